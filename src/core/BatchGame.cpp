@@ -0,0 +1,259 @@
+#include "core/BatchGame.h"
+#include <chrono>
+#include <iostream>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BATCH_X86 1
+#define BATCH_TARGET(isa) __attribute__((target(isa)))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define BATCH_X86 1
+#define BATCH_TARGET(isa)
+#endif
+
+#if defined(BATCH_X86)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace {
+    // Каждая функция добавляет выигрыши игр [begin, count) целыми
+    // векторами и возвращает первую необработанную игру
+    size_t addScalar(const int32_t* table, const int32_t* index, int64_t* score, size_t begin, size_t count) {
+        for (size_t g = begin; g < count; ++g) {
+            score[g] += table[index[g]];
+        }
+        return count;
+    }
+
+#if defined(BATCH_X86)
+    BATCH_TARGET("sse2")
+    size_t addSse2(const int32_t* table, const int32_t* index, int64_t* score, size_t begin, size_t count) {
+        size_t g = begin;
+        // Без gather: четыре выигрыша в дорожки, знак - в старшие половины
+        for (; g + 4 <= count; g += 4) {
+            __m128i payoff = _mm_set_epi32(table[index[g + 3]], table[index[g + 2]],
+                                           table[index[g + 1]], table[index[g]]);
+            __m128i sign = _mm_srai_epi32(payoff, 31);
+            __m128i* total = reinterpret_cast<__m128i*>(score + g);
+            _mm_storeu_si128(total, _mm_add_epi64(_mm_loadu_si128(total), _mm_unpacklo_epi32(payoff, sign)));
+            _mm_storeu_si128(total + 1, _mm_add_epi64(_mm_loadu_si128(total + 1), _mm_unpackhi_epi32(payoff, sign)));
+        }
+        return g;
+    }
+
+    BATCH_TARGET("avx2")
+    size_t addAvx2(const int32_t* table, const int32_t* index, int64_t* score, size_t begin, size_t count) {
+        size_t g = begin;
+        // Выигрыши собираются в 32-битные дорожки и расширяются до 64 бит
+        for (; g + 8 <= count; g += 8) {
+            __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + g));
+            __m256i payoff = _mm256_i32gather_epi32(table, idx, 4);
+            __m256i low = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(payoff));
+            __m256i high = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(payoff, 1));
+            __m256i* total = reinterpret_cast<__m256i*>(score + g);
+            _mm256_storeu_si256(total, _mm256_add_epi64(_mm256_loadu_si256(total), low));
+            _mm256_storeu_si256(total + 1, _mm256_add_epi64(_mm256_loadu_si256(total + 1), high));
+        }
+        return g;
+    }
+#endif
+}
+
+BatchGame::BatchGame(size_t games, int rounds, const GameMatrix& matrix)
+    : simd(detectSimd()),
+      gameCount(games),
+      currentRound(0),
+      totalRounds(rounds),
+      randomSeed(static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count())),
+      randomGame(0),
+      traces(nullptr),
+      outcomes(games, 0) {
+    matrix.getFlatTable(payoffTable);
+    
+    for (int seat = 0; seat < SEATS; ++seat) {
+        strategies[seat].reserve(games);
+        histories[seat].resize(games);
+        moves[seat].assign(games, 0);
+        scores[seat].assign(games, 0);
+        cooperations[seat].assign(games, 0);
+    }
+}
+
+void BatchGame::addPlayer(size_t game, StrategySlot player) {
+    for (int seat = 0; seat < SEATS; ++seat) {
+        if (strategies[seat].size() == game) {
+            strategies[seat].push_back(std::move(player));
+            return;
+        }
+    }
+    std::cerr << "BatchGame: players must be added game by game, seat by seat" << std::endl;
+}
+
+bool BatchGame::isReady() const {
+    for (int seat = 0; seat < SEATS; ++seat) {
+        if (strategies[seat].size() != gameCount) return false;
+    }
+    return true;
+}
+
+void BatchGame::makeMoves() {
+    if (currentRound == 0) {
+        // Статистика оппонентов и потоки случайных чисел создаются,
+        // когда все игроки на местах
+        for (int seat = 0; seat < SEATS; ++seat) {
+            stats[seat].clear();
+            stats[seat].reserve(gameCount);
+            randomStreams[seat].clear();
+            randomStreams[seat].reserve(gameCount);
+            for (size_t g = 0; g < gameCount; ++g) {
+                stats[seat].emplace_back(SEATS - 1, strategies[seat][g]->getStatsWindowSize());
+                randomStreams[seat].emplace_back(randomSeed, randomGame, static_cast<uint32_t>(g),
+                                                 static_cast<uint32_t>(seat));
+                strategies[seat][g]->attachOpponentStats(&stats[seat][g]);
+                strategies[seat][g]->attachRandom(&randomStreams[seat][g]);
+            }
+        }
+    }
+    
+    for (int seat = 0; seat < SEATS; ++seat) {
+        int first = (seat == 0) ? 1 : 0;
+        int second = (seat == 2) ? 1 : 2;
+        
+        for (size_t g = 0; g < gameCount; ++g) {
+            HistoryView opponents[2] = {
+                HistoryView(histories[first][g]),
+                HistoryView(histories[second][g])
+            };
+            Move move = strategies[seat][g].makeMove(
+                HistoryView(histories[seat][g]), OpponentsView(opponents, 2));
+            moves[seat][g] = static_cast<int32_t>(move);
+        }
+    }
+    
+    // Индекс исхода совпадает с раскладкой GameMatrix: m1*4 + m2*2 + m3
+    const int32_t* m0 = moves[0].data();
+    const int32_t* m1 = moves[1].data();
+    const int32_t* m2 = moves[2].data();
+    int32_t* out = outcomes.data();
+    for (size_t g = 0; g < gameCount; ++g) {
+        out[g] = ((m0[g] << 2) | (m1[g] << 1) | m2[g]) * SEATS;
+    }
+}
+
+BatchGame::Simd BatchGame::detectSimd() {
+    static const Simd level = []() {
+#if defined(BATCH_X86) && defined(__GNUC__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return AVX2;
+        if (__builtin_cpu_supports("sse2")) return SSE2;
+#elif defined(BATCH_X86)
+        int info[4];
+        __cpuid(info, 1);
+        bool sse2 = (info[3] >> 26) & 1;
+        // AVX2 нужен и процессору, и ОС (сохранение регистров YMM)
+        bool osYmm = ((info[2] >> 27) & 1) && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        if (osYmm && ((info[1] >> 5) & 1)) return AVX2;
+        if (sse2) return SSE2;
+#endif
+        return SCALAR;
+    }();
+    return level;
+}
+
+void BatchGame::accumulatePayoffs() {
+    for (int seat = 0; seat < SEATS; ++seat) {
+        const int32_t* table = payoffTable + seat;
+        const int32_t* index = outcomes.data();
+        int64_t* score = scores[seat].data();
+        size_t g = 0;
+        
+#if defined(BATCH_X86)
+        if (simd == AVX2) {
+            g = addAvx2(table, index, score, g, gameCount);
+        } else if (simd == SSE2) {
+            g = addSse2(table, index, score, g, gameCount);
+        }
+#endif
+        addScalar(table, index, score, g, gameCount);
+    }
+}
+
+void BatchGame::recordRound() {
+    Move roundMoves[SEATS];
+    std::vector<Move> relativeMoves(SEATS);
+    std::vector<int> relativeScores(SEATS);
+    
+    for (size_t g = 0; g < gameCount; ++g) {
+        int outcome = outcomes[g];
+        if (traces) {
+            (*traces)[g].add(outcome / SEATS);
+        }
+        for (int seat = 0; seat < SEATS; ++seat) {
+            roundMoves[seat] = static_cast<Move>(moves[seat][g]);
+            histories[seat][g].push_back(roundMoves[seat]);
+            cooperations[seat][g] += 1 - moves[seat][g];
+        }
+        
+        for (int seat = 0; seat < SEATS; ++seat) {
+            // Свой ход первым, затем оппоненты по порядку мест
+            relativeMoves[0] = roundMoves[seat];
+            relativeScores[0] = payoffTable[outcome + seat];
+            int k = 1;
+            for (int other = 0; other < SEATS; ++other) {
+                if (other == seat) continue;
+                relativeMoves[k] = roundMoves[other];
+                relativeScores[k] = payoffTable[outcome + other];
+                k++;
+            }
+            stats[seat][g].record(relativeMoves.data() + 1);
+            strategies[seat][g]->onRoundResult(relativeMoves, relativeScores, currentRound);
+        }
+    }
+}
+
+void BatchGame::playRound() {
+    if (!isReady()) {
+        std::cerr << "BatchGame is not ready! Need 3 players in every game." << std::endl;
+        return;
+    }
+    
+    makeMoves();
+    accumulatePayoffs();
+    recordRound();
+    currentRound++;
+}
+
+void BatchGame::playGame() {
+    while (currentRound < totalRounds) {
+        playRound();
+    }
+}
+
+std::vector<long long> BatchGame::getScores(size_t game) const {
+    return { scores[0][game], scores[1][game], scores[2][game] };
+}
+
+std::vector<long long> BatchGame::getCooperations(size_t game) const {
+    return { cooperations[0][game], cooperations[1][game], cooperations[2][game] };
+}
+
+std::vector<long long> BatchGame::getTotalScores() const {
+    std::vector<long long> totals(SEATS, 0);
+    for (int seat = 0; seat < SEATS; ++seat) {
+        for (int64_t score : scores[seat]) {
+            totals[seat] += score;
+        }
+    }
+    return totals;
+}
+
+std::vector<std::string> BatchGame::getPlayerNames(size_t game) const {
+    std::vector<std::string> names;
+    for (int seat = 0; seat < SEATS; ++seat) {
+        names.push_back(strategies[seat][game]->getName());
+    }
+    return names;
+}
@@ -0,0 +1,91 @@
+#ifndef BATCHGAME_H
+#define BATCHGAME_H
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include "core/Strategy.h"
+#include "core/GameMatrix.h"
+#include "core/PackedHistory.h"
+#include "core/OpponentStats.h"
+#include "core/StrategySlot.h"
+#include "core/RandomStream.h"
+#include "core/GameTrace.h"
+
+// Пакетный движок: много независимых игр трёх игроков идут синхронно.
+// Все данные хранятся по столбцам (отдельный массив на каждое место),
+// очки за раунд берутся из плоской таблицы 8x3 и складываются
+// векторно: AVX2 gather или SSE2, что поддерживает процессор
+// (выбирается при запуске, флаги сборки не нужны).
+class BatchGame {
+public:
+    enum Simd { SCALAR = 0, SSE2 = 1, AVX2 = 2 };
+
+private:
+    static const int SEATS = 3;
+    
+    Simd simd;
+    size_t gameCount;
+    int currentRound;
+    int totalRounds;
+    alignas(32) int32_t payoffTable[8 * SEATS];
+    
+    std::vector<StrategySlot> strategies[SEATS];
+    std::vector<PackedHistory> histories[SEATS];
+    std::vector<OpponentStats> stats[SEATS];
+    std::vector<RandomStream> randomStreams[SEATS];
+    uint64_t randomSeed;
+    uint64_t randomGame;
+    std::vector<TraceEncoder>* traces;
+    std::vector<int32_t> moves[SEATS];   // 0 - сотрудничество, 1 - предательство
+    // 64 бита: при больших выигрышах 32-битная сумма переполняется
+    // за несколько тысяч раундов
+    std::vector<int64_t> scores[SEATS];
+    std::vector<int64_t> cooperations[SEATS];
+    std::vector<int32_t> outcomes;       // индекс исхода раунда, умноженный на 3
+    
+    void makeMoves();
+    void accumulatePayoffs();
+    void recordRound();
+    
+public:
+    BatchGame(size_t games, int rounds = 100, const GameMatrix& matrix = GameMatrix());
+    
+    // Игроки добавляются по очереди на места 0, 1, 2
+    void addPlayer(size_t game, StrategySlot player);
+    void addPlayer(size_t game, std::unique_ptr<Strategy> player) {
+        addPlayer(game, StrategySlot(std::move(player)));
+    }
+    bool isReady() const;
+    // Игра пакета g - повтор g игры game: место s получает поток
+    // (seed, game, g, s). По умолчанию зерно берётся от часов.
+    void setRandomSeed(uint64_t seed, uint64_t game = 0) {
+        randomSeed = seed;
+        randomGame = game;
+    }
+    // Исходы раундов игры g пакета - в (*encoders)[g]
+    void setTrace(std::vector<TraceEncoder>* encoders) { traces = encoders; }
+    // Лучший набор инструкций этого процессора; он и выбран по умолчанию
+    static Simd detectSimd();
+    // Уровень выше поддерживаемого понижается до detectSimd()
+    void setSimd(Simd level) { simd = level < detectSimd() ? level : detectSimd(); }
+    Simd getSimd() const { return simd; }
+    
+    void playRound();
+    void playGame();
+    
+    size_t getGameCount() const { return gameCount; }
+    int getCurrentRound() const { return currentRound; }
+    int getTotalRounds() const { return totalRounds; }
+    
+    long long getScore(size_t game, int seat) const { return scores[seat][game]; }
+    std::vector<long long> getScores(size_t game) const;
+    // Число раундов сотрудничества каждого места в игре game
+    std::vector<long long> getCooperations(size_t game) const;
+    // Сумма очков каждого места по всем играм пакета
+    std::vector<long long> getTotalScores() const;
+    std::vector<std::string> getPlayerNames(size_t game) const;
+};
+
+#endif
@@ -0,0 +1,105 @@
+#include "Checkpoint.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    const char* const MAGIC = "PDCHECKPOINT";
+    const int FORMAT_VERSION = 3;
+}
+
+bool Checkpoint::save(const std::string& filename) const {
+    std::string tempName = filename + ".tmp";
+    {
+        std::ofstream file(tempName, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Warning: Cannot write checkpoint to " << tempName << std::endl;
+            return false;
+        }
+
+        file << MAGIC << " " << FORMAT_VERSION << "\n";
+        results.write(file);
+
+        // Выполненные блоки отрезками [first, end)
+        std::vector<std::pair<size_t, size_t>> runs;
+        for (size_t chunk = 0; chunk < done.size(); ++chunk) {
+            if (!done[chunk]) continue;
+            if (!runs.empty() && runs.back().second == chunk) {
+                runs.back().second = chunk + 1;
+            } else {
+                runs.emplace_back(chunk, chunk + 1);
+            }
+        }
+        file << "chunks " << chunkSize << " " << done.size() << " " << runs.size() << "\n";
+        for (const auto& run : runs) {
+            file << run.first << " " << run.second << "\n";
+        }
+
+        file.flush();
+        if (!file) {
+            std::cerr << "Warning: Failed to write checkpoint " << tempName << std::endl;
+            return false;
+        }
+    }
+
+#ifdef _WIN32
+    // rename в Windows не заменяет существующий файл
+    std::remove(filename.c_str());
+#endif
+    if (std::rename(tempName.c_str(), filename.c_str()) != 0) {
+        std::cerr << "Warning: Cannot replace checkpoint " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Checkpoint::load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string magic, key;
+    int version = 0;
+    file >> magic >> version;
+    if (magic != MAGIC || version != FORMAT_VERSION) {
+        std::cerr << "Warning: " << filename << " is not a checkpoint file" << std::endl;
+        return false;
+    }
+    if (!results.read(file, filename)) {
+        return false;
+    }
+
+    size_t chunkCount = 0, runCount = 0;
+    if (!(file >> key >> chunkSize >> chunkCount >> runCount) || key != "chunks" || chunkSize == 0) {
+        std::cerr << "Warning: Corrupted chunk list in " << filename << std::endl;
+        return false;
+    }
+
+    done.assign(chunkCount, 0);
+    for (size_t i = 0; i < runCount; ++i) {
+        size_t first = 0, end = 0;
+        if (!(file >> first >> end) || first > end || end > chunkCount) {
+            std::cerr << "Warning: Corrupted chunk list in " << filename << std::endl;
+            return false;
+        }
+        std::fill(done.begin() + first, done.begin() + end, 1);
+    }
+    return true;
+}
+
+size_t Checkpoint::completedChunks() const {
+    return static_cast<size_t>(std::count(done.begin(), done.end(), 1));
+}
+
+std::string Checkpoint::fileName(const std::string& dir, int shardIndex, int shardCount) {
+    std::ostringstream name;
+    name << (dir.empty() ? "." : dir) << "/tournament_checkpoint";
+    if (shardCount > 1) {
+        name << "_" << shardIndex << "_of_" << shardCount;
+    }
+    name << ".txt";
+    return name.str();
+}
@@ -0,0 +1,30 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "core/PartialResults.h"
+
+// Контрольная точка турнира: очки завершённых блоков и отметки
+// самих блоков (диапазон шарда режется на блоки по chunkSize рангов).
+// Файл пишется во временный и переименовывается, поэтому на диске
+// всегда лежит либо старая, либо новая целая версия.
+//   PDCHECKPOINT 3
+//   <тело PartialResults>
+//   chunks <chunkSize> <число блоков> <число отрезков>
+//   <первый блок> <конец>            (отрезки выполненных блоков)
+struct Checkpoint {
+    PartialResults results;
+    uint64_t chunkSize = 1;
+    std::vector<char> done;
+
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+
+    size_t completedChunks() const;
+
+    static std::string fileName(const std::string& dir, int shardIndex, int shardCount);
+};
+
+#endif
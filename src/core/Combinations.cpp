@@ -0,0 +1,67 @@
+#include "Combinations.h"
+#include <cmath>
+#include <limits>
+
+Combinations::Combinations(uint32_t n, int k)
+    : n(n), k(k), total(k >= 0 && static_cast<uint32_t>(k) <= n ? binomial(n, k) : 0) {}
+
+uint64_t Combinations::binomial(uint64_t n, int k) {
+    if (k < 0 || static_cast<uint64_t>(k) > n) return 0;
+    if (static_cast<uint64_t>(k) > n - k) k = static_cast<int>(n - k);
+
+    // result * (n - k + i) / i остаётся целым на каждом шаге
+    uint64_t result = 1;
+    for (int i = 1; i <= k; ++i) {
+        uint64_t factor = n - k + i;
+        if (result > std::numeric_limits<uint64_t>::max() / factor) {
+            return std::numeric_limits<uint64_t>::max();
+        }
+        result = result * factor / i;
+    }
+    return result;
+}
+
+uint32_t Combinations::largestWithin(uint64_t value, int r, uint32_t upper) {
+    // Начальная оценка из C(c, r) ~ c^r / r!, затем точная подгонка
+    double factorial = 1.0;
+    for (int i = 2; i <= r; ++i) factorial *= i;
+    double guess = std::pow(static_cast<double>(value) * factorial, 1.0 / r) + r - 1;
+
+    uint32_t c = guess >= upper ? upper : static_cast<uint32_t>(guess);
+    if (c < static_cast<uint32_t>(r - 1)) c = r - 1;
+    while (c > static_cast<uint32_t>(r - 1) && binomial(c, r) > value) --c;
+    while (c < upper && binomial(c + 1, r) <= value) ++c;
+    return c;
+}
+
+uint64_t Combinations::rank(const std::vector<uint32_t>& combination) const {
+    uint64_t result = 0;
+    for (int i = 0; i < k; ++i) {
+        result += binomial(combination[i], i + 1);
+    }
+    return result;
+}
+
+void Combinations::unrank(uint64_t rank, std::vector<uint32_t>& combination) const {
+    combination.resize(k);
+    uint32_t upper = n - 1;
+    for (int i = k - 1; i >= 0; --i) {
+        uint32_t c = largestWithin(rank, i + 1, upper);
+        combination[i] = c;
+        rank -= binomial(c, i + 1);
+        upper = c - 1;
+    }
+}
+
+bool Combinations::next(std::vector<uint32_t>& combination) const {
+    // Увеличиваем первый элемент, который можно сдвинуть, младшие - в начало
+    for (int i = 0; i < k; ++i) {
+        uint32_t limit = (i + 1 < k) ? combination[i + 1] : n;
+        if (combination[i] + 1 < limit) {
+            ++combination[i];
+            for (int j = 0; j < i; ++j) combination[j] = j;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,38 @@
+#ifndef COMBINATIONS_H
+#define COMBINATIONS_H
+
+#include <cstdint>
+#include <vector>
+
+// Ленивая нумерация сочетаний C(n, k) в колексикографическом порядке.
+// Сочетание - возрастающие номера c[0] < c[1] < ... < c[k-1],
+// его ранг равен C(c[0], 1) + C(c[1], 2) + ... + C(c[k-1], k).
+// rank/unrank работают за O(k) без перебора, поэтому работу можно
+// делить на непрерывные диапазоны рангов, не храня сами сочетания.
+class Combinations {
+private:
+    uint32_t n;
+    int k;
+    uint64_t total;
+
+    // Наибольшее c, при котором C(c, r) <= value
+    static uint32_t largestWithin(uint64_t value, int r, uint32_t upper);
+
+public:
+    Combinations(uint32_t n, int k);
+
+    // C(n, k); UINT64_MAX при переполнении
+    static uint64_t binomial(uint64_t n, int k);
+
+    uint64_t size() const { return total; }
+    uint32_t getN() const { return n; }
+    int getK() const { return k; }
+
+    uint64_t rank(const std::vector<uint32_t>& combination) const;
+    void unrank(uint64_t rank, std::vector<uint32_t>& combination) const;
+
+    // Следующее сочетание в том же порядке; false после последнего
+    bool next(std::vector<uint32_t>& combination) const;
+};
+
+#endif
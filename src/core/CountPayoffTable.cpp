@@ -0,0 +1,97 @@
+#include "core/CountPayoffTable.h"
+#include <cmath>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    // Значение в точке fraction по трём опорным точкам 0, 1/2 и 1
+    int interpolate(double fraction, int none, int half, int all) {
+        double value = (fraction <= 0.5)
+            ? none + (half - none) * (fraction * 2.0)
+            : half + (all - half) * (fraction * 2.0 - 1.0);
+        return static_cast<int>(std::lround(value));
+    }
+}
+
+CountPayoffTable::CountPayoffTable(int playerCount, const GameMatrix& base, const std::string& filename)
+    : players(playerCount < 2 ? 2 : playerCount),
+      payoffs(2 * (playerCount < 2 ? 2 : playerCount), 0),
+      tableLoaded(false) {
+    
+    // Опорные точки для места 0: 0, 1 и 2 сотрудничающих оппонента
+    for (Move own : { Move::COOPERATE, Move::DEFECT }) {
+        int none = base.getPayoff(own, Move::DEFECT, Move::DEFECT, 0);
+        int half = base.getPayoff(own, Move::COOPERATE, Move::DEFECT, 0);
+        int all = base.getPayoff(own, Move::COOPERATE, Move::COOPERATE, 0);
+        
+        for (int k = 0; k < players; ++k) {
+            double fraction = (players > 1) ? static_cast<double>(k) / (players - 1) : 0.0;
+            setPayoff(own, k, interpolate(fraction, none, half, all));
+        }
+    }
+    
+    if (!filename.empty()) {
+        tableLoaded = loadFromFile(filename);
+    }
+}
+
+void CountPayoffTable::setPayoff(Move own, int cooperatingOthers, int value) {
+    if (cooperatingOthers < 0 || cooperatingOthers >= players) return;
+    payoffs[static_cast<int>(own) * players + cooperatingOthers] = value;
+}
+
+bool CountPayoffTable::parseLine(const std::string& line) {
+    std::istringstream iss(line);
+    char move;
+    int cooperatingOthers, value;
+    std::string rest;
+    
+    // Строка таблицы: "<C|D> <число сотрудничающих оппонентов> <выигрыш>"
+    if (!(iss >> move >> cooperatingOthers >> value) || (iss >> rest)) {
+        return false;
+    }
+    move = static_cast<char>(std::toupper(static_cast<unsigned char>(move)));
+    if (move != 'C' && move != 'D') {
+        std::cerr << "Warning: Move must be C or D: " << line << std::endl;
+        return false;
+    }
+    if (cooperatingOthers < 0 || cooperatingOthers >= players) {
+        std::cerr << "Warning: Cooperator count out of range for " << players
+                  << " players: " << line << std::endl;
+        return false;
+    }
+    setPayoff(charToMove(move), cooperatingOthers, value);
+    return true;
+}
+
+bool CountPayoffTable::loadFromFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    bool anyParsed = false;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        if (parseLine(line)) anyParsed = true;
+    }
+    return anyParsed;
+}
+
+void CountPayoffTable::printTable() const {
+    std::cout << "=== Payoff Table (" << players << " players) ===" << std::endl;
+    std::cout << (tableLoaded ? "(Loaded from file)" : "(Derived from 3-player matrix)") << std::endl;
+    std::cout << "Cooperating others:";
+    for (int k = 0; k < players; ++k) std::cout << " " << k;
+    std::cout << std::endl;
+    
+    for (Move own : { Move::COOPERATE, Move::DEFECT }) {
+        std::cout << moveToChar(own) << " =>";
+        for (int k = 0; k < players; ++k) std::cout << " " << payoff(own, k);
+        std::cout << std::endl;
+    }
+    std::cout << "===================" << std::endl;
+}
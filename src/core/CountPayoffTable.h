@@ -0,0 +1,39 @@
+#ifndef COUNTPAYOFFTABLE_H
+#define COUNTPAYOFFTABLE_H
+
+#include <vector>
+#include <string>
+#include "core/Move.h"
+#include "core/GameMatrix.h"
+
+// Таблица выигрышей симметричной игры N игроков: выигрыш зависит только
+// от собственного хода и числа сотрудничающих оппонентов, поэтому
+// хранится 2*N значений вместо 2^N строк полной матрицы.
+class CountPayoffTable {
+private:
+    int players;
+    std::vector<int> payoffs;  // payoffs[move * players + cooperatingOthers]
+    bool tableLoaded;
+    
+    bool parseLine(const std::string& line);
+    
+public:
+    // Таблица выводится из матрицы трёх игроков (места 0) кусочно-линейной
+    // интерполяцией по доле сотрудничающих оппонентов; для N = 3 совпадает
+    // с матрицей. Строки вида "C <k> <выигрыш>" из файла её переопределяют.
+    CountPayoffTable(int playerCount = 3, const GameMatrix& base = GameMatrix(),
+                     const std::string& filename = "");
+    
+    bool loadFromFile(const std::string& filename);
+    
+    int payoff(Move own, int cooperatingOthers) const {
+        return payoffs[static_cast<int>(own) * players + cooperatingOthers];
+    }
+    void setPayoff(Move own, int cooperatingOthers, int value);
+    
+    int getPlayerCount() const { return players; }
+    bool isTableLoaded() const { return tableLoaded; }
+    void printTable() const;
+};
+
+#endif
@@ -1,55 +1,219 @@
 #include "Game.h"
+#include "utils/Logger.h"
+#include "core/GameTrace.h"
 #include <iostream>
 #include <iomanip>
+#include <map>
+#include <algorithm>
 
-Game::Game(int rounds, const std::string& matrixFile) 
-    : currentRound(0), totalRounds(rounds), matrix(matrixFile) {
+Game::Game(int rounds, const std::string& matrixFile, int numPlayers) 
+    : matrix(matrixFile),
+      countTable(numPlayers, matrix, numPlayers != 3 ? matrixFile : ""),
+      playerCount(numPlayers),
+      currentRound(0),
+      totalRounds(rounds),
+      roundScores(numPlayers, 0),
+      cooperations(numPlayers, 0),
+      cycleDetection(true),
+      fastForwardedRounds(0),
+      logger(nullptr),
+      logGame(0),
+      trace(nullptr) {
+    players.resizeFor(numPlayers);
+}
+
+Game::Game(int rounds, const GameMatrix& matrix, const CountPayoffTable& countTable)
+    : matrix(matrix),
+      countTable(countTable),
+      playerCount(countTable.getPlayerCount()),
+      currentRound(0),
+      totalRounds(rounds),
+      roundScores(playerCount, 0),
+      cooperations(playerCount, 0),
+      cycleDetection(true),
+      fastForwardedRounds(0),
+      logger(nullptr),
+      logGame(0),
+      trace(nullptr) {
+    players.resizeFor(playerCount);
 }
 
 void Game::addPlayer(std::unique_ptr<Strategy> player) {
     players.addPlayer(std::move(player));
 }
 
+void Game::addPlayer(StrategySlot player) {
+    players.addPlayer(std::move(player));
+}
+
 void Game::playRound() {
     if (!isReady()) {
-        std::cerr << "Game is not ready! Need exactly 3 players." << std::endl;
+        std::cerr << "Game is not ready! Need exactly " << playerCount << " players." << std::endl;
         return;
     }
 
+    if (currentRound == 0) {
+        players.prepareOpponentStats();
+        players.prepareRandomStreams();
+    }
+
     // 1. Каждый игрок делает ход
-    for (int i = 0; i < 3; ++i) {
-        auto opponentsHistory = players.getOpponentsHistory(i);
-        auto ownHistory = players.getPlayerHistory(i);
+    for (int i = 0; i < playerCount; ++i) {
+        // Представления не копируют историю
+        OpponentsView opponentsHistory = players.getOpponentsView(i);
+        HistoryView ownHistory = players.getPlayerHistory(i);
         
-        Move move = players.getStrategies()[i]->makeMove(ownHistory, opponentsHistory);
+        // Встроенные стратегии вызываются напрямую, остальные - виртуально
+        Move move = players.getStrategies()[i].makeMove(ownHistory, opponentsHistory);
         players.setCurrentMove(i, move);
     }
 
     // 2. Получаем очки за раунд
-    auto currentMoves = players.getCurrentMoves();
-    std::vector<int> roundScores = matrix.getPayoff(
-        currentMoves[0], currentMoves[1], currentMoves[2]);
+    computeRoundScores();
+    const auto& currentMoves = players.getCurrentMoves();
+    if (trace && playerCount == 3) {
+        trace->add(PayoffTable::outcomeIndex(currentMoves[0], currentMoves[1], currentMoves[2]));
+    }
 
     // 3. Обновляем очки
-    for (int i = 0; i < 3; ++i) {
+    for (int i = 0; i < playerCount; ++i) {
         players.addToScore(i, roundScores[i]);
+        cooperations[i] += currentMoves[i] == Move::COOPERATE;
+    }
+    if (logger) {
+        logger->logRound(logGame, currentRound, currentMoves, roundScores, players.getScores());
     }
 
     // 4. Сохраняем ходы в историю
-    for (int i = 0; i < 3; ++i) {
+    for (int i = 0; i < playerCount; ++i) {
         players.addMoveToHistory(i, currentMoves[i]);
     }
 
+    // 5. Обновляем статистику оппонентов и сообщаем стратегиям результат
+    players.notifyRoundResult(roundScores, currentRound);
+
     currentRound++;
 }
 
+void Game::computeRoundScores() {
+    const auto& currentMoves = players.getCurrentMoves();
+    
+    if (playerCount == 3) {
+        // Упакованная таблица, без аллокаций
+        const PayoffTable& table = matrix.getTable();
+        int outcome = PayoffTable::outcomeIndex(currentMoves[0], currentMoves[1], currentMoves[2]);
+        for (int i = 0; i < 3; ++i) {
+            roundScores[i] = table.payoff(outcome, i);
+        }
+        return;
+    }
+    
+    // N игроков: выигрыш зависит от числа сотрудничающих оппонентов
+    int cooperators = 0;
+    for (int i = 0; i < playerCount; ++i) {
+        cooperators += (currentMoves[i] == Move::COOPERATE) ? 1 : 0;
+    }
+    for (int i = 0; i < playerCount; ++i) {
+        int own = (currentMoves[i] == Move::COOPERATE) ? 1 : 0;
+        roundScores[i] = countTable.payoff(currentMoves[i], cooperators - own);
+    }
+}
+
+bool Game::captureState(std::vector<uint64_t>& key) const {
+    // Сигнатуры всех стратегий и ходы последнего раунда (по биту на игрока)
+    key.assign(playerCount + (playerCount + 63) / 64, 0);
+    const auto& strategies = players.getStrategies();
+    for (int i = 0; i < playerCount; ++i) {
+        if (!strategies[i]->getStateSignature(key[i])) {
+            return false;
+        }
+    }
+    
+    const auto& currentMoves = players.getCurrentMoves();
+    for (int i = 0; i < playerCount; ++i) {
+        key[playerCount + i / 64] |= static_cast<uint64_t>(currentMoves[i] == Move::DEFECT) << (i % 64);
+    }
+    return true;
+}
+
 void Game::playGame() {
+    // Состояние -> номер раунда, после которого оно наблюдалось
+    std::map<std::vector<uint64_t>, int> seenStates;
+    // Накопленные очки и ходы после каждого отслеживаемого раунда
+    std::vector<long long> scoreLog;
+    std::vector<Move> moveLog;
+    std::vector<uint64_t> key;
+    bool detecting = cycleDetection && isReady();
+    int firstTracked = currentRound + 1;
+    
     while (currentRound < totalRounds) {
         playRound();
+        if (!detecting) continue;
+        
+        if (!captureState(key) || seenStates.size() >= MAX_TRACKED_STATES) {
+            detecting = false;
+            continue;
+        }
+        
+        const auto& scores = players.getScores();
+        scoreLog.insert(scoreLog.end(), scores.begin(), scores.end());
+        const auto& currentMoves = players.getCurrentMoves();
+        moveLog.insert(moveLog.end(), currentMoves.begin(), currentMoves.end());
+        
+        auto inserted = seenStates.emplace(key, currentRound);
+        if (inserted.second) continue;
+        
+        // Цикл: раунды (cycleStart, currentRound] повторяются бесконечно
+        int cycleStart = inserted.first->second;
+        int cycleLength = currentRound - cycleStart;
+        int remaining = totalRounds - currentRound;
+        long long fullCycles = remaining / cycleLength;
+        int remainder = remaining % cycleLength;
+        
+        auto logged = [&](int round, int player) {
+            return scoreLog[static_cast<size_t>(round - firstTracked) * playerCount + player];
+        };
+        
+        int finalRound = cycleStart + remainder;
+        for (int i = 0; i < playerCount; ++i) {
+            long long cycleGain = logged(currentRound, i) - logged(cycleStart, i);
+            long long remainderGain = logged(finalRound, i) - logged(cycleStart, i);
+            players.addToScore(i, fullCycles * cycleGain + remainderGain);
+            
+            long long cycleCooperations = 0;
+            long long remainderCooperations = 0;
+            for (int round = cycleStart + 1; round <= currentRound; ++round) {
+                bool cooperated = moveLog[static_cast<size_t>(round - firstTracked) * playerCount + i] == Move::COOPERATE;
+                cycleCooperations += cooperated;
+                if (round <= finalRound) remainderCooperations += cooperated;
+            }
+            cooperations[i] += fullCycles * cycleCooperations + remainderCooperations;
+        }
+        
+        // Последний раунд выглядит так же, как раунд finalRound цикла
+        if (remainder > 0) {
+            for (int i = 0; i < playerCount; ++i) {
+                players.setCurrentMove(i, moveLog[static_cast<size_t>(finalRound - firstTracked) * playerCount + i]);
+                roundScores[i] = static_cast<int>(logged(finalRound, i) - logged(finalRound - 1, i));
+            }
+        }
+        
+        if (trace && playerCount == 3) {
+            std::vector<uint8_t> cycle;
+            cycle.reserve(static_cast<size_t>(cycleLength));
+            for (int round = cycleStart + 1; round <= currentRound; ++round) {
+                const Move* moves = &moveLog[static_cast<size_t>(round - firstTracked) * playerCount];
+                cycle.push_back(static_cast<uint8_t>(PayoffTable::outcomeIndex(moves[0], moves[1], moves[2])));
+            }
+            trace->addCycle(cycle.data(), cycle.size(), static_cast<uint64_t>(remaining));
+        }
+        
+        fastForwardedRounds = remaining;
+        currentRound = totalRounds;
     }
 }
 
-std::vector<int> Game::getScores() const {
+std::vector<long long> Game::getScores() const {
     return players.getScores();
 }
 
@@ -62,13 +226,15 @@ int Game::getCurrentRound() const {
 }
 
 bool Game::isReady() const {
-    return players.hasThreePlayers();
+    return players.hasPlayers(playerCount);
 }
 
 void Game::reset() {
     players.clear();
-    players.resizeForThreePlayers();
+    players.resizeFor(playerCount);
     currentRound = 0;
+    fastForwardedRounds = 0;
+    std::fill(cooperations.begin(), cooperations.end(), 0);
 }
 
 std::vector<Move> Game::getCurrentMoves() const {
@@ -77,6 +243,10 @@ std::vector<Move> Game::getCurrentMoves() const {
 
 void Game::printMatrix() const {
     std::cout << "\n=== GAME MATRIX ===" << std::endl;
+    if (playerCount != 3) {
+        countTable.printTable();
+        return;
+    }
     matrix.printMatrix();
 }
 
@@ -99,9 +269,7 @@ void Game::printRoundInfo() const {
     }
     std::cout << std::endl;
     
-    std::vector<int> roundScores = matrix.getPayoff(
-        currentMoves[0], currentMoves[1], currentMoves[2]);
-    
+    // roundScores хранит очки последнего сыгранного раунда
     std::cout << "Round scores: ";
     for (size_t i = 0; i < names.size(); ++i) {
         std::cout << names[i] << ": " << roundScores[i];
@@ -126,7 +294,7 @@ void Game::printFinalResults() const {
     std::cout << "FINAL RESULTS" << std::endl;
     std::cout << "Total rounds played: " << currentRound << std::endl;
     
-    int maxScore = -1;
+    long long maxScore = -1;
     int winnerIndex = -1;
     
     for (size_t i = 0; i < names.size(); ++i) {
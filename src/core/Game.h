@@ -1,30 +1,77 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <string>
 #include "core/Strategy.h"
 #include "core/GameMatrix.h"
 #include "core/Players.h"
+#include "core/CountPayoffTable.h"
+
+class Logger;
+class TraceEncoder;
 
 class Game {
 private:
     Players players;
     GameMatrix matrix;
+    CountPayoffTable countTable;
+    int playerCount;
     int currentRound;
     int totalRounds;
+    std::vector<int> roundScores;
+    std::vector<long long> cooperations;
+    bool cycleDetection;
+    int fastForwardedRounds;
+    Logger* logger;
+    uint32_t logGame;
+    TraceEncoder* trace;
+    
+    void computeRoundScores();
+    bool captureState(std::vector<uint64_t>& key) const;
     
 public:
-    Game(int rounds = 100, const std::string& matrixFile = "");
+    // Для трёх игроков используется полная матрица GameMatrix,
+    // для другого числа - таблица по числу сотрудничающих (CountPayoffTable)
+    Game(int rounds = 100, const std::string& matrixFile = "", int numPlayers = 3);
+    // Уже загруженные матрица и таблица; число игроков - из таблицы
+    Game(int rounds, const GameMatrix& matrix, const CountPayoffTable& countTable);
     void addPlayer(std::unique_ptr<Strategy> player);
+    void addPlayer(StrategySlot player);
     void playRound();
+    // Если все стратегии детерминированы (getStateSignature), повтор
+    // совместного состояния замыкает цикл, и оставшиеся раунды
+    // считаются как целые циклы плюс остаток. Пропущенные раунды
+    // не попадают в историю и не передаются в onRoundResult.
     void playGame();
+    
+    static constexpr size_t MAX_TRACKED_STATES = 1 << 16;
+    void setCycleDetection(bool enabled) { cycleDetection = enabled; }
+    int getFastForwardedRounds() const { return fastForwardedRounds; }
+    // Зерно потоков случайных чисел игроков; game и replica - номер
+    // игры в турнире и повтора, см. RandomStream
+    void setRandomSeed(uint64_t seed, uint64_t game = 0, uint32_t replica = 0) {
+        players.setRandomSeed(seed, game, replica);
+    }
+    // Раунды игры уходят в журнал (Logger::logRound) под номером game
+    // от logGameStart; nullptr - без журнала
+    void setLogger(Logger* target, uint32_t game) {
+        logger = target;
+        logGame = game;
+    }
+    // Исходы раундов (и перемотанных тоже) в двоичную трассу;
+    // только для трёх игроков
+    void setTrace(TraceEncoder* encoder) { trace = encoder; }
 
-    std::vector<int> getScores() const;
+    std::vector<long long> getScores() const;
+    // Число раундов, в которых место сотрудничало (с перемотанными)
+    const std::vector<long long>& getCooperations() const { return cooperations; }
     std::vector<std::string> getPlayerNames() const;
     int getCurrentRound() const;
     int getTotalRounds() const { return totalRounds; }
+    int getPlayerCount() const { return playerCount; }
 
     void printRoundInfo() const;
     void printFinalResults() const;
@@ -2,6 +2,8 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <algorithm>
+#include <cctype>
 
 GameMatrix::GameMatrix() : matrixLoaded(false) {
     setDefaultMatrix();
@@ -66,14 +68,25 @@ void GameMatrix::parseLine(const std::string& line) {
     char m1, m2, m3;
     int p1, p2, p3;
 
-    if (iss >> m1 >> m2 >> m3 >> p1 >> p2 >> p3) {
-        int idx1 = (m1 == 'C' || m1 == 'c') ? 0 : 1;
-        int idx2 = (m2 == 'C' || m2 == 'c') ? 0 : 1;
-        int idx3 = (m3 == 'C' || m3 == 'c') ? 0 : 1;
+    // Строки "C <k> <выигрыш>" относятся к таблице N игроков (CountPayoffTable)
+    size_t second = line.find_first_not_of(" \t", 1);
+    if (second != std::string::npos && std::isdigit(static_cast<unsigned char>(line[second]))) {
+        return;
+    }
 
-        payoff[idx1][idx2][idx3][0] = p1;
-        payoff[idx1][idx2][idx3][1] = p2;
-        payoff[idx1][idx2][idx3][2] = p3;
+    if (iss >> m1 >> m2 >> m3 >> p1 >> p2 >> p3) {
+        int outcome = PayoffTable::outcomeIndex(charToMove(m1), charToMove(m2), charToMove(m3));
+        int values[3] = { p1, p2, p3 };
+        
+        for (int seat = 0; seat < 3; ++seat) {
+            if (values[seat] < PayoffTable::MIN_PAYOFF || values[seat] > PayoffTable::MAX_PAYOFF) {
+                std::cerr << "Warning: Payoff " << values[seat] << " out of range, clamped: "
+                          << line << std::endl;
+                values[seat] = std::max(PayoffTable::MIN_PAYOFF,
+                                        std::min(PayoffTable::MAX_PAYOFF, values[seat]));
+            }
+            table.set(outcome, seat, values[seat]);
+        }
         
     } else {
         std::cerr << "Warning: Cannot parse matrix line: " << line << std::endl;
@@ -81,42 +94,27 @@ void GameMatrix::parseLine(const std::string& line) {
 }
 
 std::vector<int> GameMatrix::getPayoff(Move move1, Move move2, Move move3) const {
-    int idx1 = moveToIndex(move1);
-    int idx2 = moveToIndex(move2);
-    int idx3 = moveToIndex(move3);
+    int outcome = PayoffTable::outcomeIndex(move1, move2, move3);
     
     return {
-        payoff[idx1][idx2][idx3][0],
-        payoff[idx1][idx2][idx3][1],
-        payoff[idx1][idx2][idx3][2]
+        table.payoff(outcome, 0),
+        table.payoff(outcome, 1),
+        table.payoff(outcome, 2)
     };
 }
 
+void GameMatrix::getFlatTable(int* out) const {
+    for (int outcome = 0; outcome < PayoffTable::OUTCOMES; ++outcome) {
+        for (int seat = 0; seat < PayoffTable::SEATS; ++seat) {
+            out[outcome * PayoffTable::SEATS + seat] = table.payoff(outcome, seat);
+        }
+    }
+}
+
 void GameMatrix::setDefaultMatrix() {
-    // C C C => 7 7 7
-    payoff[0][0][0][0] = 7; payoff[0][0][0][1] = 7; payoff[0][0][0][2] = 7;
-    
-    // C C D => 3 3 9
-    payoff[0][0][1][0] = 3; payoff[0][0][1][1] = 3; payoff[0][0][1][2] = 9;
-    
-    // C D C => 3 9 3
-    payoff[0][1][0][0] = 3; payoff[0][1][0][1] = 9; payoff[0][1][0][2] = 3;
-    
-    // D C C => 9 3 3
-    payoff[1][0][0][0] = 9; payoff[1][0][0][1] = 3; payoff[1][0][0][2] = 3;
-    
-    // C D D => 0 5 5
-    payoff[0][1][1][0] = 0; payoff[0][1][1][1] = 5; payoff[0][1][1][2] = 5;
-    
-    // D C D => 5 0 5
-    payoff[1][0][1][0] = 5; payoff[1][0][1][1] = 0; payoff[1][0][1][2] = 5;
-    
-    // D D C => 5 5 0
-    payoff[1][1][0][0] = 5; payoff[1][1][0][1] = 5; payoff[1][1][0][2] = 0;
-    
-    // D D D => 1 1 1
-    payoff[1][1][1][0] = 1; payoff[1][1][1][1] = 1; payoff[1][1][1][2] = 1;
-    
+    // Матрица по умолчанию вычислена на этапе компиляции:
+    // C C C => 7 7 7, C C D => 3 3 9, C D D => 0 5 5, D D D => 1 1 1
+    table = DefaultPayoffTable::table;
     matrixLoaded = false;
 }
 
@@ -128,21 +126,15 @@ void GameMatrix::printMatrix() const {
         std::cout << "(Default matrix)" << std::endl;
     }
     
-    std::cout << "C C C => " << payoff[0][0][0][0] << " " 
-              << payoff[0][0][0][1] << " " << payoff[0][0][0][2] << std::endl;
-    std::cout << "C C D => " << payoff[0][0][1][0] << " " 
-              << payoff[0][0][1][1] << " " << payoff[0][0][1][2] << std::endl;
-    std::cout << "C D C => " << payoff[0][1][0][0] << " " 
-              << payoff[0][1][0][1] << " " << payoff[0][1][0][2] << std::endl;
-    std::cout << "D C C => " << payoff[1][0][0][0] << " " 
-              << payoff[1][0][0][1] << " " << payoff[1][0][0][2] << std::endl;
-    std::cout << "C D D => " << payoff[0][1][1][0] << " " 
-              << payoff[0][1][1][1] << " " << payoff[0][1][1][2] << std::endl;
-    std::cout << "D C D => " << payoff[1][0][1][0] << " " 
-              << payoff[1][0][1][1] << " " << payoff[1][0][1][2] << std::endl;
-    std::cout << "D D C => " << payoff[1][1][0][0] << " " 
-              << payoff[1][1][0][1] << " " << payoff[1][1][0][2] << std::endl;
-    std::cout << "D D D => " << payoff[1][1][1][0] << " " 
-              << payoff[1][1][1][1] << " " << payoff[1][1][1][2] << std::endl;
+    // Порядок вывода: по числу предателей
+    const int order[PayoffTable::OUTCOMES] = { 0, 1, 2, 4, 3, 5, 6, 7 };
+    for (int outcome : order) {
+        std::cout << ((outcome & 4) ? 'D' : 'C') << " "
+                  << ((outcome & 2) ? 'D' : 'C') << " "
+                  << ((outcome & 1) ? 'D' : 'C') << " => "
+                  << table.payoff(outcome, 0) << " "
+                  << table.payoff(outcome, 1) << " "
+                  << table.payoff(outcome, 2) << std::endl;
+    }
     std::cout << "===================" << std::endl;
 }
\ No newline at end of file
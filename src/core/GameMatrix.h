@@ -5,16 +5,14 @@
 #include <string>
 #include <fstream>
 #include "core/Strategy.h"
+#include "core/PayoffTable.h"
 
 class GameMatrix {
 private:
-    int payoff[2][2][2][3];
+    PayoffTable table;
     bool matrixLoaded;
     
     void parseLine(const std::string& line);
-    int moveToIndex(Move move) const {
-        return (move == Move::COOPERATE) ? 0 : 1;
-    }
     
 public:
     GameMatrix();
@@ -22,9 +20,18 @@ public:
     
     bool loadFromFile(const std::string& filename);
     std::vector<int> getPayoff(Move move1, Move move2, Move move3) const;
+    
+    // Поиск без ветвлений и аллокаций, для горячего цикла движка
+    int getPayoff(Move move1, Move move2, Move move3, int seat) const {
+        return table.payoff(move1, move2, move3, seat);
+    }
+    const PayoffTable& getTable() const { return table; }
     void setDefaultMatrix();
     void printMatrix() const;
     
+    // Плоская таблица 8x3: out[(m1*4 + m2*2 + m3) * 3 + seat], C = 0, D = 1
+    void getFlatTable(int* out) const;
+    
     bool isMatrixLoaded() const { return matrixLoaded; }
 };
 
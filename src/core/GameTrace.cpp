@@ -0,0 +1,412 @@
+#include "GameTrace.h"
+#include <filesystem>
+#include <iostream>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char MAGIC[8] = {'P', 'D', 'T', 'R', 'A', 'C', 'E', '\0'};
+
+    template <typename T>
+    void appendValue(std::string& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    size_t runBytes(size_t length) {
+        if (length <= 31) return 1;
+        size_t bytes = 2;
+        for (size_t extra = (length - 32) >> 7; extra; extra >>= 7) ++bytes;
+        return bytes;
+    }
+
+    void appendRun(std::string& out, uint8_t outcome, size_t length) {
+        if (length <= 31) {
+            out.push_back(static_cast<char>(outcome | ((length - 1) << 3)));
+            return;
+        }
+        out.push_back(static_cast<char>(outcome | (31 << 3)));
+        size_t extra = length - 32;
+        do {
+            uint8_t byte = extra & 0x7F;
+            extra >>= 7;
+            out.push_back(static_cast<char>(byte | (extra ? 0x80 : 0)));
+        } while (extra);
+    }
+
+    std::string buildHeader(const std::vector<std::string>& strategyNames, uint64_t seed, uint64_t matrixHash) {
+        std::string header(MAGIC, sizeof(MAGIC));
+        appendValue<uint32_t>(header, GameTrace::VERSION);
+        appendValue<uint32_t>(header, static_cast<uint32_t>(strategyNames.size()));
+        appendValue<uint64_t>(header, seed);
+        appendValue<uint64_t>(header, matrixHash);
+        for (const auto& name : strategyNames) {
+            appendValue<uint32_t>(header, static_cast<uint32_t>(name.size()));
+            header += name;
+        }
+        return header;
+    }
+}
+
+std::string GameTrace::fileName(const std::string& dir, int shardIndex, int shardCount) {
+    std::string name = (dir.empty() ? "." : dir) + "/tournament_trace";
+    if (shardCount > 1) {
+        name += "_" + std::to_string(shardIndex) + "_of_" + std::to_string(shardCount);
+    }
+    return name + ".pdt";
+}
+
+void GameTrace::setReplica(std::string& record, uint32_t replica) {
+    size_t at = 8 + 4 * SEATS;
+    if (record.size() < at + sizeof(replica)) return;
+    std::memcpy(&record[at], &replica, sizeof(replica));
+}
+
+void TraceEncoder::encode(const uint8_t* outcomes, size_t count, std::string& out) {
+    size_t rleBytes = 0;
+    for (size_t i = 0; i < count;) {
+        size_t j = i;
+        while (j < count && outcomes[j] == outcomes[i]) ++j;
+        rleBytes += runBytes(j - i);
+        i = j;
+    }
+    size_t packedBytes = (count * 3 + 7) / 8;
+
+    if (rleBytes < packedBytes) {
+        out.push_back(static_cast<char>(GameTrace::RLE));
+        for (size_t i = 0; i < count;) {
+            size_t j = i;
+            while (j < count && outcomes[j] == outcomes[i]) ++j;
+            appendRun(out, outcomes[i], j - i);
+            i = j;
+        }
+    } else {
+        out.push_back(static_cast<char>(GameTrace::PACKED));
+        size_t start = out.size();
+        out.append(packedBytes, '\0');
+        for (size_t r = 0; r < count; ++r) {
+            size_t bit = r * 3;
+            unsigned value = unsigned(outcomes[r]) << (bit & 7);
+            out[start + (bit >> 3)] = static_cast<char>(out[start + (bit >> 3)] | (value & 0xFF));
+            if (value > 0xFF) {
+                out[start + (bit >> 3) + 1] = static_cast<char>(out[start + (bit >> 3) + 1] | (value >> 8));
+            }
+        }
+    }
+}
+
+void TraceEncoder::encodeBlock() {
+    if (block.empty()) return;
+    offsets.push_back(static_cast<uint32_t>(payload.size()));
+    encode(block.data(), block.size(), payload);
+    block.clear();
+}
+
+void TraceEncoder::addCycle(const uint8_t* cycle, size_t cycleLength, uint64_t count) {
+    if (cycleLength == 0) return;
+    uint64_t phase = 0;
+    auto next = [&]() {
+        uint8_t outcome = cycle[phase];
+        if (++phase == cycleLength) phase = 0;
+        return outcome;
+    };
+
+    // Добиваем начатый блок
+    while (count > 0 && !block.empty()) {
+        add(next());
+        --count;
+    }
+
+    // Целые блоки: содержимое зависит только от сдвига цикла
+    std::vector<std::pair<uint64_t, std::string>> encoded;
+    while (count >= GameTrace::BLOCK_ROUNDS) {
+        auto found = std::find_if(encoded.begin(), encoded.end(),
+                                  [&](const std::pair<uint64_t, std::string>& item) { return item.first == phase; });
+        offsets.push_back(static_cast<uint32_t>(payload.size()));
+        if (found != encoded.end()) {
+            payload += found->second;
+            phase = (phase + GameTrace::BLOCK_ROUNDS) % cycleLength;
+        } else {
+            uint64_t start = phase;
+            for (uint32_t r = 0; r < GameTrace::BLOCK_ROUNDS; ++r) block.push_back(next());
+            std::string bytes;
+            encode(block.data(), block.size(), bytes);
+            block.clear();
+            payload += bytes;
+            // Сдвигов не больше длины цикла; помним первые несколько
+            if (encoded.size() < 64) encoded.emplace_back(start, std::move(bytes));
+        }
+        rounds += GameTrace::BLOCK_ROUNDS;
+        count -= GameTrace::BLOCK_ROUNDS;
+    }
+
+    while (count > 0) {
+        add(next());
+        --count;
+    }
+}
+
+void TraceEncoder::clear() {
+    block.clear();
+    payload.clear();
+    offsets.clear();
+    rounds = 0;
+}
+
+std::string TraceEncoder::finish(const uint32_t ids[GameTrace::SEATS], uint32_t replica) {
+    encodeBlock();
+    uint32_t blockCount = static_cast<uint32_t>(offsets.size());
+    offsets.push_back(static_cast<uint32_t>(payload.size()));
+
+    std::string body;
+    body.reserve(32 + offsets.size() * 4 + payload.size());
+    for (uint32_t seat = 0; seat < GameTrace::SEATS; ++seat) {
+        appendValue<uint32_t>(body, ids[seat]);
+    }
+    appendValue<uint32_t>(body, replica);
+    appendValue<uint64_t>(body, rounds);
+    appendValue<uint32_t>(body, blockCount);
+    for (uint32_t offset : offsets) {
+        appendValue<uint32_t>(body, offset);
+    }
+    body += payload;
+
+    std::string record;
+    appendValue<uint64_t>(record, body.size());
+    record += body;
+    clear();
+    return record;
+}
+
+bool TraceWriter::open(const std::string& filename, const std::vector<std::string>& strategyNames,
+                       uint64_t seed, uint64_t matrixHash, const KeepGame& keep) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file.is_open()) file.close();
+    games = 0;
+    std::string header = buildHeader(strategyNames, seed, matrixHash);
+
+    // Продолжение: нужные целые записи переписываются во временный
+    // файл, оборванный хвост и игры незавершённых блоков пропадают
+    bool kept = false;
+    if (keep && std::ifstream(filename, std::ios::binary).is_open()) {
+        TraceReader previous;
+        if (previous.open(filename) && previous.getSeed() == seed &&
+            previous.getMatrixHash() == matrixHash && previous.getStrategyNames() == strategyNames) {
+            std::string temporary = filename + ".tmp";
+            std::ofstream copy(temporary, std::ios::binary | std::ios::trunc);
+            copy.write(header.data(), header.size());
+            std::vector<uint32_t> ids(GameTrace::SEATS);
+            for (size_t g = 0; g < previous.getGameCount(); ++g) {
+                const TraceReader::GameInfo& game = previous.getGame(g);
+                ids.assign(game.ids, game.ids + GameTrace::SEATS);
+                if (!keep(ids)) continue;
+                copy.write(reinterpret_cast<const char*>(game.record), static_cast<std::streamsize>(game.recordBytes));
+                ++games;
+            }
+            copy.close();
+            previous.close();
+            std::error_code error;
+            if (copy) std::filesystem::rename(temporary, filename, error);
+            kept = copy && !error;
+            if (!kept) games = 0;
+        } else {
+            std::cerr << "Warning: Game trace " << filename
+                      << " belongs to a different tournament, rewriting it" << std::endl;
+        }
+    }
+
+    if (kept) {
+        file.open(filename, std::ios::binary | std::ios::app);
+    } else {
+        file.open(filename, std::ios::binary | std::ios::trunc);
+        file.write(header.data(), header.size());
+    }
+    if (!file.is_open()) {
+        std::cerr << "Warning: Cannot write game trace to " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void TraceWriter::append(const std::string& record) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file.is_open()) return;
+    file.write(record.data(), static_cast<std::streamsize>(record.size()));
+    ++games;
+}
+
+void TraceWriter::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file.is_open()) file.flush();
+}
+
+void TraceWriter::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file.is_open()) file.close();
+}
+
+TraceReader::TraceReader()
+    : data(nullptr),
+      size(0),
+#if defined(_WIN32)
+      fileHandle(nullptr),
+      mappingHandle(nullptr),
+#else
+      descriptor(-1),
+#endif
+      seed(0),
+      matrixHash(0) {}
+
+TraceReader::~TraceReader() {
+    close();
+}
+
+bool TraceReader::map(const std::string& filename) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    fileHandle = file;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return false;
+    size = static_cast<size_t>(fileSize.QuadPart);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) return false;
+    mappingHandle = mapping;
+    data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    return data != nullptr;
+#else
+    descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (descriptor < 0) return false;
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || info.st_size == 0) return false;
+    size = static_cast<size_t>(info.st_size);
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (view == MAP_FAILED) return false;
+    data = static_cast<const unsigned char*>(view);
+    return true;
+#endif
+}
+
+void TraceReader::close() {
+#if defined(_WIN32)
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    if (data) munmap(const_cast<unsigned char*>(data), size);
+    if (descriptor >= 0) ::close(descriptor);
+    descriptor = -1;
+#endif
+    data = nullptr;
+    size = 0;
+    strategyNames.clear();
+    games.clear();
+}
+
+bool TraceReader::open(const std::string& filename) {
+    close();
+    if (!map(filename) || !parse()) {
+        std::cerr << "Warning: Cannot read game trace " << filename << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool TraceReader::parse() {
+    size_t position = sizeof(MAGIC) + 4 + 4 + 8 + 8;
+    if (size < position || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 ||
+        load<uint32_t>(data + 8) != GameTrace::VERSION) {
+        return false;
+    }
+    uint32_t strategyCount = load<uint32_t>(data + 12);
+    seed = load<uint64_t>(data + 16);
+    matrixHash = load<uint64_t>(data + 24);
+
+    for (uint32_t id = 0; id < strategyCount; ++id) {
+        if (size - position < 4) return false;
+        uint32_t length = load<uint32_t>(data + position);
+        position += 4;
+        if (size - position < length) return false;
+        strategyNames.emplace_back(reinterpret_cast<const char*>(data + position), length);
+        position += length;
+    }
+
+    // Оборванная последняя запись (сбой при записи) пропускается
+    const size_t fixedBytes = 4 * GameTrace::SEATS + 4 + 8 + 4;
+    while (size - position >= 8) {
+        uint64_t bodyBytes = load<uint64_t>(data + position);
+        const unsigned char* body = data + position + 8;
+        if (bodyBytes > size - position - 8 || bodyBytes < fixedBytes) break;
+
+        GameInfo game;
+        for (uint32_t seat = 0; seat < GameTrace::SEATS; ++seat) {
+            game.ids[seat] = load<uint32_t>(body + 4 * seat);
+        }
+        for (uint32_t seat = 0; seat < GameTrace::SEATS; ++seat) {
+            if (game.ids[seat] >= strategyNames.size()) return false;
+        }
+        game.replica = load<uint32_t>(body + 12);
+        game.rounds = load<uint64_t>(body + 16);
+        game.blockCount = load<uint32_t>(body + 24);
+        game.offsets = body + fixedBytes;
+        uint64_t offsetBytes = 4 * (uint64_t(game.blockCount) + 1);
+        if (fixedBytes + offsetBytes > bodyBytes ||
+            game.blockCount != (game.rounds + GameTrace::BLOCK_ROUNDS - 1) / GameTrace::BLOCK_ROUNDS ||
+            load<uint32_t>(game.offsets + 4 * game.blockCount) != bodyBytes - fixedBytes - offsetBytes) {
+            return false;
+        }
+        for (uint32_t b = 0; b < game.blockCount; ++b) {
+            if (load<uint32_t>(game.offsets + 4 * b) >= load<uint32_t>(game.offsets + 4 * (b + 1))) {
+                return false;
+            }
+        }
+        game.blocks = game.offsets + offsetBytes;
+        game.record = data + position;
+        game.recordBytes = 8 + bodyBytes;
+        games.push_back(game);
+        position += 8 + bodyBytes;
+    }
+    return true;
+}
+
+void TraceReader::blockRange(const GameInfo& game, uint32_t block,
+                             const unsigned char*& begin, const unsigned char*& end) const {
+    begin = game.blocks + load<uint32_t>(game.offsets + 4 * block);
+    end = game.blocks + load<uint32_t>(game.offsets + 4 * (block + 1));
+}
+
+int TraceReader::outcome(size_t index, uint64_t round) const {
+    const GameInfo& game = games[index];
+    if (round >= game.rounds) return -1;
+
+    const unsigned char* at;
+    const unsigned char* end;
+    blockRange(game, static_cast<uint32_t>(round / GameTrace::BLOCK_ROUNDS), at, end);
+    uint64_t offset = round % GameTrace::BLOCK_ROUNDS;
+    uint8_t kind = *at++;
+
+    if (kind == GameTrace::PACKED) {
+        return packedOutcome(at, end - at, offset);
+    }
+    while (at < end) {
+        int value;
+        uint64_t length;
+        at = readRun(at, end, value, length);
+        if (offset < length) return value;
+        offset -= length;
+    }
+    return -1;
+}
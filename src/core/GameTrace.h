@@ -0,0 +1,219 @@
+#ifndef GAMETRACE_H
+#define GAMETRACE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Двоичная трасса игр троих: на раунд - индекс исхода 0..7
+// (PayoffTable::outcomeIndex, 3 бита). Раунды игры режутся на блоки
+// по BLOCK_ROUNDS; блок хранится либо упакованным по 3 бита, либо
+// серийным кодом (RLE) - что короче. Смещения блоков лежат перед
+// ними, поэтому любой раунд читается разбором одного блока.
+//
+// Файл (порядок байтов машины):
+//   "PDTRACE\0" <версия u32> <число стратегий u32> <seed u64> <хэш матрицы u64>
+//   <длина u32> <имя>                     (по стратегии, номер - ID)
+//   записи игр подряд:
+//   <байт записи u64> <ID по местам u32 x3> <повтор u32>
+//   <раунды u64> <блоки u32> <смещение блока u32 x (блоки + 1)> <блоки>
+// Блок: байт вида (PACKED или RLE) и данные. Серия RLE - байт
+// исход | (длина - 1) << 3 для длин до 31, иначе исход | 31 << 3
+// и LEB128 (длина - 32).
+namespace GameTrace {
+    const uint32_t VERSION = 1;
+    const uint32_t SEATS = 3;
+    const uint32_t BLOCK_ROUNDS = 4096;
+    enum BlockKind : uint8_t { PACKED = 0, RLE = 1 };
+
+    // <dir>/tournament_trace.pdt, у шарда - с номером шарда
+    std::string fileName(const std::string& dir, int shardIndex = 0, int shardCount = 1);
+    // Меняет номер повтора в готовой записи (TraceEncoder::finish)
+    void setReplica(std::string& record, uint32_t replica);
+}
+
+// Кодирует раунды одной игры по мере игры
+class TraceEncoder {
+private:
+    std::vector<uint8_t> block;
+    std::string payload;
+    std::vector<uint32_t> offsets;
+    uint64_t rounds;
+
+    // Короче из двух кодировок count исходов - в out
+    static void encode(const uint8_t* outcomes, size_t count, std::string& out);
+    void encodeBlock();
+
+public:
+    TraceEncoder() : rounds(0) { block.reserve(GameTrace::BLOCK_ROUNDS); }
+
+    void add(int outcome) {
+        block.push_back(static_cast<uint8_t>(outcome));
+        ++rounds;
+        if (block.size() == GameTrace::BLOCK_ROUNDS) encodeBlock();
+    }
+    // length раундов подряд с одним исходом
+    void addRun(int outcome, uint64_t length) {
+        uint8_t value = static_cast<uint8_t>(outcome);
+        addCycle(&value, 1, length);
+    }
+    // count раундов, повторяющих исходы cycle[0..cycleLength) по кругу.
+    // Целые блоки кодируются один раз на сдвиг цикла относительно
+    // блока, поэтому время растёт с числом блоков, а не раундов.
+    void addCycle(const uint8_t* cycle, size_t cycleLength, uint64_t count);
+    uint64_t getRounds() const { return rounds; }
+    void clear();
+
+    // Запись игры для TraceWriter::append; кодировщик очищается
+    std::string finish(const uint32_t ids[GameTrace::SEATS], uint32_t replica);
+};
+
+// Файл трассы; append потокобезопасен
+class TraceWriter {
+private:
+    std::ofstream file;
+    std::mutex mutex;
+    uint64_t games;
+
+public:
+    // Оставить ли при продолжении запись игры с такими ID по местам
+    using KeepGame = std::function<bool(const std::vector<uint32_t>& ids)>;
+
+    TraceWriter() : games(0) {}
+
+    // Без keep файл создаётся заново. С keep (продолжение турнира)
+    // из файла с тем же заголовком сохраняются целые записи, для
+    // которых keep вернул true, остальное отбрасывается и дописывается
+    bool open(const std::string& filename, const std::vector<std::string>& strategyNames,
+              uint64_t seed, uint64_t matrixHash, const KeepGame& keep = nullptr);
+    bool isOpen() const { return file.is_open(); }
+    void append(const std::string& record);
+    // Сбрасывает буфер в файл (перед записью контрольной точки)
+    void flush();
+    // Дописывает буфер и закрывает файл; число игр сохраняется
+    void close();
+    uint64_t getGameCount() const { return games; }
+};
+
+// Чтение трассы через отображение файла в память: записи игр
+// находятся одним проходом по заголовкам, раунды не загружаются
+class TraceReader {
+public:
+    struct GameInfo {
+        uint32_t ids[GameTrace::SEATS];
+        uint32_t replica;
+        uint64_t rounds;
+        uint32_t blockCount;
+        const unsigned char* offsets;
+        const unsigned char* blocks;
+        // Запись целиком, вместе с длиной
+        const unsigned char* record;
+        uint64_t recordBytes;
+    };
+
+private:
+    const unsigned char* data;
+    size_t size;
+#if defined(_WIN32)
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int descriptor;
+#endif
+    uint64_t seed;
+    uint64_t matrixHash;
+    std::vector<std::string> strategyNames;
+    std::vector<GameInfo> games;
+
+    template <typename T>
+    static T load(const unsigned char* at) {
+        T value;
+        std::memcpy(&value, at, sizeof(T));
+        return value;
+    }
+    // Исход r упакованного блока из count байт
+    static int packedOutcome(const unsigned char* bytes, size_t count, uint64_t r) {
+        size_t byte = static_cast<size_t>((r * 3) >> 3);
+        unsigned shift = static_cast<unsigned>((r * 3) & 7);
+        unsigned pair = bytes[byte] | (byte + 1 < count ? unsigned(bytes[byte + 1]) << 8 : 0u);
+        return static_cast<int>((pair >> shift) & 7);
+    }
+    // Серия RLE с позиции at; возвращает позицию за ней
+    static const unsigned char* readRun(const unsigned char* at, const unsigned char* end,
+                                        int& outcome, uint64_t& length) {
+        uint8_t head = *at++;
+        outcome = head & 7;
+        length = (head >> 3) + 1;
+        if ((head >> 3) == 31) {
+            uint64_t extra = 0;
+            int shift = 0;
+            while (at < end) {
+                uint8_t byte = *at++;
+                extra |= uint64_t(byte & 0x7F) << shift;
+                shift += 7;
+                if (!(byte & 0x80)) break;
+            }
+            length = 32 + extra;
+        }
+        return at;
+    }
+    bool map(const std::string& filename);
+    bool parse();
+    void blockRange(const GameInfo& game, uint32_t block, const unsigned char*& begin, const unsigned char*& end) const;
+
+public:
+    TraceReader();
+    ~TraceReader();
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    bool open(const std::string& filename);
+    void close();
+
+    uint64_t getSeed() const { return seed; }
+    uint64_t getMatrixHash() const { return matrixHash; }
+    const std::vector<std::string>& getStrategyNames() const { return strategyNames; }
+    size_t getGameCount() const { return games.size(); }
+    const GameInfo& getGame(size_t index) const { return games[index]; }
+
+    // Исход раунда round игры index
+    int outcome(size_t index, uint64_t round) const;
+
+    // visit(исход, число раундов подряд) по всем раундам игры
+    template <typename Visitor>
+    void forEachRun(size_t index, Visitor visit) const;
+};
+
+template <typename Visitor>
+void TraceReader::forEachRun(size_t index, Visitor visit) const {
+    const GameInfo& game = games[index];
+    for (uint32_t b = 0; b < game.blockCount; ++b) {
+        const unsigned char* at;
+        const unsigned char* end;
+        blockRange(game, b, at, end);
+        uint64_t blockRounds = std::min<uint64_t>(GameTrace::BLOCK_ROUNDS,
+                                                  game.rounds - uint64_t(b) * GameTrace::BLOCK_ROUNDS);
+        uint8_t kind = *at++;
+
+        if (kind == GameTrace::PACKED) {
+            for (uint64_t r = 0; r < blockRounds; ++r) {
+                visit(packedOutcome(at, end - at, r), uint64_t(1));
+            }
+            continue;
+        }
+
+        while (at < end) {
+            int outcome;
+            uint64_t length;
+            at = readRun(at, end, outcome, length);
+            visit(outcome, length);
+        }
+    }
+}
+
+#endif
@@ -1,113 +1,476 @@
 #include "History.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <sstream>
 
-History::History(const std::string& configDir) : configPath(configDir) {
+namespace {
+    const char MAGIC[8] = {'P', 'D', 'H', 'I', 'S', 'T', '\0', '\0'};
+    const size_t HEADER_BYTES = sizeof(MAGIC) + 4;
+
+    uint32_t checksum(const std::string& data) {
+        uint32_t hash = 2166136261u;
+        for (unsigned char byte : data) {
+            hash ^= byte;
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    void appendValue(std::string& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    // count бит из bitAt(i), по 8 в байте, младший первый
+    template <typename BitAt>
+    void appendBits(std::string& out, size_t count, BitAt bitAt) {
+        size_t start = out.size();
+        out.append((count + 7) / 8, '\0');
+        for (size_t i = 0; i < count; ++i) {
+            if (bitAt(i)) out[start + i / 8] = static_cast<char>(out[start + i / 8] | (1 << (i % 8)));
+        }
+    }
+
+    std::string header() {
+        std::string bytes(MAGIC, sizeof(MAGIC));
+        appendValue<uint32_t>(bytes, History::FILE_VERSION);
+        return bytes;
+    }
+
+    // Чтение тела сегмента с проверкой границ
+    class Cursor {
+    private:
+        const std::string& data;
+        size_t position;
+
+    public:
+        explicit Cursor(const std::string& source) : data(source), position(0) {}
+
+        template <typename T>
+        bool read(T& value) {
+            if (data.size() - position < sizeof(T)) return false;
+            std::memcpy(&value, data.data() + position, sizeof(T));
+            position += sizeof(T);
+            return true;
+        }
+
+        // Указатель на count байт или nullptr
+        const unsigned char* take(size_t count) {
+            if (data.size() - position < count) return nullptr;
+            const unsigned char* at = reinterpret_cast<const unsigned char*>(data.data()) + position;
+            position += count;
+            return at;
+        }
+
+        bool atEnd() const { return position == data.size(); }
+    };
+}
+
+History::History(const std::string& configDir)
+    : roundCount(0),
+      configPath(configDir),
+      savedRounds(0),
+      savedNames(0),
+      segmentCount(0),
+      validBytes(0),
+      rewriteOnSave(false) {
     if (!configDir.empty()) {
         loadFromFile();
     }
 }
 
-void History::addRound(const std::vector<std::string>& playerNames, 
+History::PlayerId History::intern(const std::string& name) {
+    auto found = playerIds.find(name);
+    if (found != playerIds.end()) {
+        return found->second;
+    }
+    PlayerId id = static_cast<PlayerId>(playerNames.size());
+    playerIds.emplace(name, id);
+    playerNames.push_back(name);
+    columns.emplace_back();
+    return id;
+}
+
+bool History::findPlayer(const std::string& name, PlayerId& id) const {
+    auto found = playerIds.find(name);
+    if (found == playerIds.end()) return false;
+    id = found->second;
+    return true;
+}
+
+void History::addRound(const std::vector<std::string>& names,
                        const std::vector<Move>& moves) {
-    if (playerNames.size() != moves.size()) {
+    if (names.size() != moves.size()) {
         throw std::invalid_argument("Player names and moves size mismatch");
     }
     
-    RoundRecord record;
-    for (size_t i = 0; i < playerNames.size(); ++i) {
-        record[playerNames[i]] = moves[i];
+    std::vector<PlayerId> ids;
+    ids.reserve(names.size());
+    for (const auto& name : names) {
+        ids.push_back(intern(name));
     }
-    rounds.push_back(record);
+    addInternedRound(ids, moves);
 }
 
-RoundRecord History::getLastRound() const {
-    if (rounds.empty()) {
-        return RoundRecord();
+void History::addInternedRound(const std::vector<PlayerId>& ids, const std::vector<Move>& moves) {
+    if (ids.size() != moves.size()) {
+        throw std::invalid_argument("Player ids and moves size mismatch");
     }
-    return rounds.back();
+    
+    size_t round = roundCount;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        PlayerColumn& column = columns[ids[i]];
+        if (column.lastRound == round) {
+            // Имя повторилось в раунде - действует последний ход
+            column.moves.setBack(moves[i]);
+            continue;
+        }
+        if (column.firstRound == NO_ROUND) {
+            column.firstRound = round;
+        } else if (!column.sparse && column.lastRound + 1 != round) {
+            // Первый пропуск: присутствие в прошлых раундах восстанавливается
+            column.sparse = true;
+            for (size_t past = 0; past <= column.lastRound; ++past) {
+                column.presence.push_back(past >= column.firstRound ? Move::COOPERATE : Move::DEFECT);
+            }
+        }
+        if (column.sparse) {
+            while (column.presence.size() < round) column.presence.push_back(Move::DEFECT);
+            column.presence.push_back(Move::COOPERATE);
+        }
+        column.moves.push_back(moves[i]);
+        column.lastRound = round;
+    }
+    roundCount++;
 }
 
-std::vector<Move> History::getPlayerMoves(const std::string& playerName) const {
-    std::vector<Move> result;
-    for (const auto& round : rounds) {
-        auto it = round.find(playerName);
-        if (it != round.end()) {
-            result.push_back(it->second);
-        }
+bool History::moveAt(PlayerId id, size_t round, Move& move) const {
+    if (id >= columns.size() || round >= roundCount) return false;
+    const PlayerColumn& column = columns[id];
+    if (column.firstRound == NO_ROUND || round < column.firstRound || round > column.lastRound) {
+        return false;
+    }
+    
+    size_t index = round - column.firstRound;
+    if (column.sparse) {
+        if (column.presence[round] != Move::COOPERATE) return false;
+        index = column.presence.rank(round);
     }
-    return result;
+    move = column.moves[index];
+    return true;
+}
+
+bool History::RoundView::getMove(const std::string& name, Move& move) const {
+    PlayerId id;
+    return history && history->findPlayer(name, id) && history->moveAt(id, round, move);
 }
 
-std::vector<RoundRecord> History::getAllRounds() const {
-    return rounds;
+size_t History::RoundView::size() const {
+    size_t count = 0;
+    forEach([&](const std::string&, Move) { count++; });
+    return count;
+}
+
+RoundRecord History::RoundView::toRecord() const {
+    RoundRecord record;
+    forEach([&](const std::string& name, Move move) { record[name] = move; });
+    return record;
+}
+
+HistoryView History::getPlayerMoves(const std::string& playerName) const {
+    PlayerId id;
+    if (!findPlayer(playerName, id)) return HistoryView();
+    return getPlayerMoves(id);
 }
 
 bool History::isEmpty() const {
-    return rounds.empty();
+    return roundCount == 0;
 }
 
 void History::clear() {
-    rounds.clear();
+    playerNames.clear();
+    playerIds.clear();
+    columns.clear();
+    roundCount = 0;
+    // Файл на диске догонит очищенную историю при сохранении
+    rewriteOnSave = true;
 }
 
-void History::saveToFile() const {
-    if (configPath.empty()) return;
+size_t History::memoryUsage() const {
+    size_t bytes = 0;
+    for (const auto& column : columns) {
+        bytes += column.moves.memoryUsage() + column.presence.memoryUsage();
+    }
+    return bytes;
+}
+
+size_t History::movesBefore(const PlayerColumn& column, size_t round) const {
+    if (column.firstRound == NO_ROUND || round <= column.firstRound) return 0;
+    if (column.sparse) return column.presence.rank(std::min(round, column.presence.size()));
+    return std::min(round - column.firstRound, column.moves.size());
+}
+
+bool History::isPresent(const PlayerColumn& column, size_t round) const {
+    if (column.firstRound == NO_ROUND || round < column.firstRound || round > column.lastRound) return false;
+    return !column.sparse || column.presence[round] == Move::COOPERATE;
+}
+
+std::string History::encodeSegment(size_t fromRound, size_t fromName) const {
+    std::string body;
+    size_t rounds = roundCount - fromRound;
+    appendValue<uint64_t>(body, fromRound);
+    appendValue<uint32_t>(body, static_cast<uint32_t>(rounds));
+    appendValue<uint32_t>(body, static_cast<uint32_t>(fromName));
+    appendValue<uint32_t>(body, static_cast<uint32_t>(playerNames.size() - fromName));
+    for (size_t id = fromName; id < playerNames.size(); ++id) {
+        appendValue<uint32_t>(body, static_cast<uint32_t>(playerNames[id].size()));
+        body += playerNames[id];
+    }
     
-    std::ofstream file(configPath + "/history.txt", std::ios::app);
-    if (!file.is_open()) {
-        std::cerr << "Warning: Cannot save history to " << configPath << "/history.txt" << std::endl;
+    size_t countAt = body.size();
+    uint32_t columnCount = 0;
+    appendValue<uint32_t>(body, 0);
+    for (PlayerId id = 0; id < columns.size(); ++id) {
+        const PlayerColumn& column = columns[id];
+        size_t first = movesBefore(column, fromRound);
+        size_t present = movesBefore(column, roundCount) - first;
+        if (present == 0) continue;
+        
+        columnCount++;
+        appendValue<uint32_t>(body, id);
+        appendValue<uint32_t>(body, static_cast<uint32_t>(present));
+        bool dense = present == rounds;
+        appendValue<uint8_t>(body, dense);
+        if (!dense) {
+            appendBits(body, rounds, [&](size_t i) { return isPresent(column, fromRound + i); });
+        }
+        appendBits(body, present, [&](size_t i) { return column.moves[first + i] == Move::COOPERATE; });
+    }
+    std::memcpy(&body[countAt], &columnCount, sizeof(columnCount));
+    return body;
+}
+
+bool History::decodeSegment(const std::string& body) {
+    Cursor cursor(body);
+    uint64_t firstRound;
+    uint32_t rounds, firstName, nameCount, columnCount;
+    if (!cursor.read(firstRound) || firstRound != roundCount || !cursor.read(rounds) ||
+        !cursor.read(firstName) || firstName != playerNames.size() || !cursor.read(nameCount)) {
+        return false;
+    }
+    std::vector<std::string> names(nameCount);
+    for (auto& name : names) {
+        uint32_t length;
+        const unsigned char* bytes;
+        if (!cursor.read(length) || !(bytes = cursor.take(length))) return false;
+        name.assign(reinterpret_cast<const char*>(bytes), length);
+    }
+    
+    struct Slice {
+        PlayerId id;
+        const unsigned char* presence;    // nullptr - все раунды сегмента
+        const unsigned char* moves;
+        size_t next;
+    };
+    std::vector<Slice> slices;
+    if (!cursor.read(columnCount)) return false;
+    for (uint32_t c = 0; c < columnCount; ++c) {
+        uint32_t id, present;
+        uint8_t dense;
+        if (!cursor.read(id) || id >= playerNames.size() + names.size() ||
+            !cursor.read(present) || !cursor.read(dense)) {
+            return false;
+        }
+        Slice slice = {id, nullptr, nullptr, 0};
+        if (!dense && !(slice.presence = cursor.take((rounds + 7) / 8))) return false;
+        if ((dense && present != rounds) || !(slice.moves = cursor.take((present + 7) / 8))) return false;
+        // Ходов ровно столько, сколько отмеченных раундов
+        if (!dense) {
+            size_t marked = 0;
+            for (size_t round = 0; round < rounds; ++round) {
+                marked += (slice.presence[round / 8] >> (round % 8)) & 1;
+            }
+            if (marked != present) return false;
+        }
+        slices.push_back(slice);
+    }
+    if (!cursor.atEnd()) return false;
+    
+    for (const auto& name : names) intern(name);
+    // Раунды сегмента собираются из столбцов по порядку
+    std::vector<PlayerId> ids;
+    std::vector<Move> moves;
+    auto bit = [](const unsigned char* bytes, size_t i) { return (bytes[i / 8] >> (i % 8)) & 1; };
+    for (size_t round = 0; round < rounds; ++round) {
+        ids.clear();
+        moves.clear();
+        for (auto& slice : slices) {
+            if (slice.presence && !bit(slice.presence, round)) continue;
+            ids.push_back(slice.id);
+            moves.push_back(bit(slice.moves, slice.next++) ? Move::COOPERATE : Move::DEFECT);
+        }
+        addInternedRound(ids, moves);
+    }
+    return true;
+}
+
+void History::markSaved() {
+    savedRounds = roundCount;
+    savedNames = playerNames.size();
+    rewriteOnSave = false;
+}
+
+void History::saveToFile() {
+    if (configPath.empty()) return;
+    if (rewriteOnSave || segmentCount >= MAX_SEGMENTS) {
+        compact();
         return;
     }
+    if (savedRounds == roundCount && savedNames == playerNames.size()) return;
     
-    file.exceptions(std::ifstream::badbit);
+    std::string filename = getFileName();
+    std::string record;
+    std::error_code error;
+    if (validBytes == 0) {
+        record = header();
+    } else if (std::filesystem::file_size(filename, error) != validBytes) {
+        // Оборванный хвост прошлой записи
+        std::filesystem::resize_file(filename, validBytes, error);
+    }
+    std::string body = encodeSegment(savedRounds, savedNames);
+    appendValue<uint32_t>(record, static_cast<uint32_t>(body.size()));
+    appendValue<uint32_t>(record, checksum(body));
+    record += body;
     
-    for (const auto& round : rounds) {
-        for (const auto& [name, move] : round) {
-            file << name << ":" << moveToChar(move) << " ";
+    std::ofstream file;
+    if (!error) {
+        file.open(filename, std::ios::binary | (validBytes == 0 ? std::ios::trunc : std::ios::app));
+        file.write(record.data(), static_cast<std::streamsize>(record.size()));
+    }
+    if (error || !file.flush()) {
+        std::cerr << "Warning: Cannot save history to " << filename << std::endl;
+        return;
+    }
+    validBytes += record.size();
+    segmentCount++;
+    markSaved();
+}
+
+bool History::compact() {
+    if (configPath.empty()) return false;
+    
+    std::string filename = getFileName();
+    std::string temporary = filename + ".tmp";
+    std::string data = header();
+    size_t segments = 0;
+    if (roundCount > 0 || !playerNames.empty()) {
+        std::string body = encodeSegment(0, 0);
+        appendValue<uint32_t>(data, static_cast<uint32_t>(body.size()));
+        appendValue<uint32_t>(data, checksum(body));
+        data += body;
+        segments = 1;
+    }
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!file.flush()) {
+            std::cerr << "Warning: Cannot save history to " << temporary << std::endl;
+            return false;
         }
-        file << "\n";
     }
+    std::error_code error;
+    std::filesystem::rename(temporary, filename, error);
+    if (error) {
+        std::cerr << "Warning: Cannot replace " << filename << ": " << error.message() << std::endl;
+        return false;
+    }
+    validBytes = data.size();
+    segmentCount = segments;
+    markSaved();
+    return true;
 }
 
 bool History::loadFromFile() {
     if (configPath.empty()) return false;
     
-    std::ifstream file(configPath + "/history.txt");
+    clear();
+    markSaved();
+    segmentCount = 0;
+    validBytes = 0;
+    
+    std::string filename = getFileName();
+    std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) {
+        return importLegacy();
+    }
+    
+    std::string expected = header();
+    std::string bytes(HEADER_BYTES, '\0');
+    if (!file.read(&bytes[0], HEADER_BYTES) || bytes != expected) {
+        std::cerr << "Warning: " << filename << " is not a history file, it will be rewritten on save" << std::endl;
+        rewriteOnSave = true;
         return false;
     }
+    validBytes = HEADER_BYTES;
+    std::error_code error;
+    uint64_t fileBytes = std::filesystem::file_size(filename, error);
+    if (error) fileBytes = 0;
     
-    file.exceptions(std::ifstream::badbit);
+    // Сегменты по одному: в памяти только текущее тело
+    std::string body;
+    uint32_t size, sum;
+    while (file.read(reinterpret_cast<char*>(&size), sizeof(size)) &&
+           file.read(reinterpret_cast<char*>(&sum), sizeof(sum))) {
+        // Длина из испорченного заголовка не должна выходить за файл
+        if (size > fileBytes - validBytes - sizeof(size) - sizeof(sum)) break;
+        body.resize(size);
+        if (!file.read(&body[0], size) || checksum(body) != sum) break;
+        
+        if (!decodeSegment(body)) {
+            std::cerr << "Warning: Corrupt segment in " << filename << ", history truncated" << std::endl;
+            break;
+        }
+        validBytes += sizeof(size) + sizeof(sum) + size;
+        segmentCount++;
+    }
+    savedRounds = roundCount;
+    savedNames = playerNames.size();
+    return true;
+}
+
+bool History::importLegacy() {
+    // Прежний формат: строка на раунд, "имя:C имя:D ..."
+    std::ifstream file(configPath + "/history.txt", std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
     
-    try {
-        std::string line;
-        while (std::getline(file, line)) {
-            if (line.empty()) continue;
-            
-            std::istringstream iss(line);
-            std::string token;
-            RoundRecord record;
-            
-            while (iss >> token) {
-                size_t colonPos = token.find(':');
-                if (colonPos == std::string::npos) continue;
-                
-                std::string name = token.substr(0, colonPos);
-                char moveChar = token[colonPos + 1];
-                Move move = (moveChar == 'C' || moveChar == 'c') ? Move::COOPERATE : Move::DEFECT;
-                
-                record[name] = move;
-            }
-            
-            if (!record.empty()) {
-                rounds.push_back(record);
+    std::string line;
+    std::vector<PlayerId> ids;
+    std::vector<Move> moves;
+    while (std::getline(file, line)) {
+        ids.clear();
+        moves.clear();
+        size_t position = 0;
+        while (position < line.size()) {
+            size_t end = line.find_first_of(" \t\r", position);
+            if (end == std::string::npos) end = line.size();
+            size_t colon = line.find(':', position);
+            if (colon != std::string::npos && colon < end) {
+                ids.push_back(intern(line.substr(position, colon - position)));
+                moves.push_back(charToMove(colon + 1 < end ? line[colon + 1] : '\0'));
             }
+            position = end + 1;
+        }
+        if (!ids.empty()) {
+            addInternedRound(ids, moves);
         }
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "Error loading history: " << e.what() << std::endl;
-        return false;
     }
-}
\ No newline at end of file
+    
+    // Сразу в новый формат; history.txt остаётся как был
+    rewriteOnSave = true;
+    saveToFile();
+    return true;
+}
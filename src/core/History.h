@@ -2,31 +2,176 @@
 #define HISTORY_H
 
 #include <vector>
+#include <deque>
 #include <map>
 #include <string>
+#include <cstdint>
+#include <unordered_map>
 #include "core/Strategy.h"
+#include "core/PackedHistory.h"
+#include "core/HistoryView.h"
 
 using RoundRecord = std::map<std::string, Move>;
 
+// История раундов по столбцам: имя игрока один раз превращается
+// в ID, ходы каждого игрока лежат в своём PackedHistory (бит на раунд).
+// Столбец игрока доступен за O(1) как HistoryView, раунды читаются
+// через лёгкие представления, без копий.
+//
+// Столбец содержит ходы только тех раундов, где игрок был. Пока
+// игрок участвует в раундах подряд, номер хода - раунд минус первый
+// раунд игрока; после первого пропуска заводится битовый столбец
+// присутствия, и номер хода - его rank.
+//
+// На диске - <configDir>/history.pdh: заголовок "PDHIST\0\0" <версия u32>
+// и сегменты <байт u32> <FNV-1a u32> <тело>. Каждое сохранение
+// дописывает один сегмент только с новыми раундами и именами:
+//   <первый раунд u64> <раундов u32> <первый новый ID u32> <имён u32>
+//   (<длина u32> <имя>)... <столбцов u32>, затем по игроку сегмента
+//   <ID u32> <ходов u32> <подряд u8> [биты присутствия] <биты ходов>
+// (биты - по 8 раундов в байте, младший первый; присутствие пишется,
+// только если игрок пропускал раунды сегмента). Загрузка идёт
+// потоком по сегментам; оборванный или испорченный хвост отбрасывается
+// и затирается при следующем сохранении. Больше MAX_SEGMENTS
+// сегментов сжимаются в один (compact). Старый history.txt
+// импортируется, если history.pdh ещё нет.
 class History {
+public:
+    using PlayerId = uint32_t;
+
+    // Ходы одного раунда
+    class RoundView {
+    private:
+        const History* history;
+        size_t round;
+
+    public:
+        RoundView(const History* owner, size_t index) : history(owner), round(index) {}
+
+        size_t getIndex() const { return round; }
+        bool getMove(PlayerId id, Move& move) const { return history && history->moveAt(id, round, move); }
+        bool getMove(const std::string& name, Move& move) const;
+        // visit(имя, ход) по игрокам раунда в порядке ID
+        template <typename Visitor>
+        void forEach(Visitor visit) const;
+        size_t size() const;
+        bool empty() const { return size() == 0; }
+        RoundRecord toRecord() const;
+    };
+
+    // Все раунды по порядку
+    class RoundRange {
+    private:
+        const History* history;
+
+    public:
+        class Iterator {
+        private:
+            const History* history;
+            size_t round;
+        public:
+            Iterator(const History* owner, size_t index) : history(owner), round(index) {}
+            RoundView operator*() const { return RoundView(history, round); }
+            Iterator& operator++() { ++round; return *this; }
+            bool operator==(const Iterator& other) const { return round == other.round; }
+            bool operator!=(const Iterator& other) const { return round != other.round; }
+        };
+
+        explicit RoundRange(const History* owner) : history(owner) {}
+        Iterator begin() const { return Iterator(history, 0); }
+        Iterator end() const { return Iterator(history, history->getRoundCount()); }
+        size_t size() const { return history->getRoundCount(); }
+    };
+
 private:
-    std::vector<RoundRecord> rounds;
+    static const size_t NO_ROUND = static_cast<size_t>(-1);
+
+    struct PlayerColumn {
+        PackedHistory moves;
+        size_t firstRound;
+        size_t lastRound;
+        bool sparse;
+        PackedHistory presence;    // только при sparse: COOPERATE - игрок был
+
+        PlayerColumn() : firstRound(NO_ROUND), lastRound(NO_ROUND), sparse(false) {}
+    };
+
+    std::vector<std::string> playerNames;
+    std::unordered_map<std::string, PlayerId> playerIds;
+    // deque: новые игроки не сдвигают столбцы, на которые смотрят HistoryView
+    std::deque<PlayerColumn> columns;
+    size_t roundCount;
     std::string configPath;
-    
+
+    // Что уже лежит в файле
+    size_t savedRounds;
+    size_t savedNames;
+    size_t segmentCount;
+    uint64_t validBytes;
+    bool rewriteOnSave;
+
+    bool moveAt(PlayerId id, size_t round, Move& move) const;
+    // Ходы игрока в раундах до round
+    size_t movesBefore(const PlayerColumn& column, size_t round) const;
+    bool isPresent(const PlayerColumn& column, size_t round) const;
+    std::string encodeSegment(size_t fromRound, size_t fromName) const;
+    bool decodeSegment(const std::string& body);
+    bool importLegacy();
+    void markSaved();
+
 public:
+    static constexpr uint32_t FILE_VERSION = 1;
+    static constexpr size_t MAX_SEGMENTS = 64;
+
     History(const std::string& configDir = "");
-    
-    void addRound(const std::vector<std::string>& playerNames, 
+
+    // ID игрока; новое имя получает следующий номер
+    PlayerId intern(const std::string& name);
+    // false, если игрок не встречался
+    bool findPlayer(const std::string& name, PlayerId& id) const;
+    const std::string& getPlayerName(PlayerId id) const { return playerNames[id]; }
+    const std::vector<std::string>& getPlayerNames() const { return playerNames; }
+
+    void addRound(const std::vector<std::string>& playerNames,
                   const std::vector<Move>& moves);
-    RoundRecord getLastRound() const;
-    std::vector<Move> getPlayerMoves(const std::string& playerName) const;
-    std::vector<RoundRecord> getAllRounds() const;
+    // То же по готовым ID, без поиска имён
+    void addInternedRound(const std::vector<PlayerId>& ids, const std::vector<Move>& moves);
+
+    RoundView getRound(size_t round) const { return RoundView(this, round); }
+    RoundView getLastRound() const { return RoundView(this, roundCount ? roundCount - 1 : NO_ROUND); }
+    // Ходы игрока в раундах, где он был; пустое представление для
+    // незнакомого имени или ID. Видит раунды на момент вызова;
+    // действительно до clear() или loadFromFile().
+    HistoryView getPlayerMoves(const std::string& playerName) const;
+    HistoryView getPlayerMoves(PlayerId id) const {
+        return id < columns.size() ? HistoryView(columns[id].moves) : HistoryView();
+    }
+    RoundRange getAllRounds() const { return RoundRange(this); }
     bool isEmpty() const;
     void clear();
-    void saveToFile() const;
+    // Дописывает раунды, добавленные после загрузки или прошлого сохранения
+    void saveToFile();
+    // Заменяет историю содержимым файла
     bool loadFromFile();
-    
-    int getRoundCount() const { return rounds.size(); }
+    // Переписывает файл одним сегментом
+    bool compact();
+    size_t getSegmentCount() const { return segmentCount; }
+    std::string getFileName() const { return configPath + "/history.pdh"; }
+
+    int getRoundCount() const { return static_cast<int>(roundCount); }
+    // Байт под столбцы ходов и присутствия
+    size_t memoryUsage() const;
 };
 
-#endif
\ No newline at end of file
+template <typename Visitor>
+void History::RoundView::forEach(Visitor visit) const {
+    if (!history) return;
+    Move move;
+    for (PlayerId id = 0; id < history->columns.size(); ++id) {
+        if (history->moveAt(id, round, move)) {
+            visit(history->playerNames[id], move);
+        }
+    }
+}
+
+#endif
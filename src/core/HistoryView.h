@@ -0,0 +1,80 @@
+#ifndef HISTORYVIEW_H
+#define HISTORYVIEW_H
+
+#include <cstddef>
+#include <vector>
+#include "core/Move.h"
+#include "core/PackedHistory.h"
+
+// Невладеющее представление истории ходов одного игрока.
+// Видит первые size() раундов упакованной истории; действительно,
+// пока жива история, на которую оно указывает.
+class HistoryView {
+private:
+    const PackedHistory* history;
+    size_t length;
+
+public:
+    class Iterator {
+    private:
+        const PackedHistory* history;
+        size_t index;
+    public:
+        Iterator(const PackedHistory* source, size_t position) : history(source), index(position) {}
+        Move operator*() const { return (*history)[index]; }
+        Iterator& operator++() { ++index; return *this; }
+        bool operator==(const Iterator& other) const { return index == other.index; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+    };
+
+    HistoryView() : history(nullptr), length(0) {}
+    HistoryView(const PackedHistory& source) : history(&source), length(source.size()) {}
+    HistoryView(const PackedHistory& source, size_t size) : history(&source), length(size) {}
+
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+
+    Move operator[](size_t index) const { return (*history)[index]; }
+    Move back() const { return (*history)[length - 1]; }
+
+    Iterator begin() const { return Iterator(history, 0); }
+    Iterator end() const { return Iterator(history, length); }
+
+    // Запросы к упакованной истории за O(1)
+    size_t countCooperations(size_t from, size_t to) const { return history->countCooperations(from, to); }
+    size_t countDefections(size_t from, size_t to) const { return history->countDefections(from, to); }
+    size_t countCooperations() const { return length ? history->rank(length) : 0; }
+    size_t countDefections() const { return length - countCooperations(); }
+    // Бит 0 - самый последний ход, единица - сотрудничество
+    uint64_t lastMoves(size_t count) const { return length ? history->lastMoves(count, length) : 0; }
+
+    std::vector<Move> toVector() const {
+        std::vector<Move> result;
+        result.reserve(length);
+        for (Move move : *this) result.push_back(move);
+        return result;
+    }
+};
+
+// Невладеющее представление историй всех оппонентов игрока
+class OpponentsView {
+private:
+    const HistoryView* views;
+    size_t length;
+
+public:
+    OpponentsView() : views(nullptr), length(0) {}
+    OpponentsView(const HistoryView* data, size_t size) : views(data), length(size) {}
+    OpponentsView(const std::vector<HistoryView>& opponents)
+        : views(opponents.data()), length(opponents.size()) {}
+
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+
+    const HistoryView& operator[](size_t index) const { return views[index]; }
+
+    const HistoryView* begin() const { return views; }
+    const HistoryView* end() const { return views + length; }
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include "MarkovGame.h"
+
+MarkovGame::MarkovGame(const std::array<MemoryOneResponse, SEATS>& responses,
+                       const GameMatrix& matrix)
+    : table(matrix.getTable()) {
+    // Вероятность совместного исхода - произведение независимых ходов мест
+    auto jointProbability = [](int outcome, const double (&cooperate)[SEATS]) {
+        double probability = 1.0;
+        for (int seat = 0; seat < SEATS; ++seat) {
+            bool defect = (outcome >> (SEATS - 1 - seat)) & 1;
+            probability *= defect ? 1.0 - cooperate[seat] : cooperate[seat];
+        }
+        return probability;
+    };
+
+    double first[SEATS];
+    for (int seat = 0; seat < SEATS; ++seat) {
+        first[seat] = responses[seat].initial;
+    }
+    for (int next = 0; next < STATES; ++next) {
+        initial[next] = jointProbability(next, first);
+    }
+
+    for (int current = 0; current < STATES; ++current) {
+        double cooperate[SEATS];
+        for (int seat = 0; seat < SEATS; ++seat) {
+            cooperate[seat] = responses[seat].afterOutcome[seatOutcome(current, seat)];
+        }
+        for (int next = 0; next < STATES; ++next) {
+            transition[current][next] = jointProbability(next, cooperate);
+        }
+    }
+}
+
+int MarkovGame::seatOutcome(int outcome, int seat) {
+    int own = (outcome >> (SEATS - 1 - seat)) & 1;
+    int opponents = 0;
+    for (int other = 0; other < SEATS; ++other) {
+        if (other == seat) continue;
+        opponents = (opponents << 1) | ((outcome >> (SEATS - 1 - other)) & 1);
+    }
+    return (own << 2) | opponents;
+}
+
+bool MarkovGame::describe(const std::vector<const Strategy*>& strategies,
+                          std::array<MemoryOneResponse, SEATS>& responses) {
+    if (strategies.size() != static_cast<size_t>(SEATS)) {
+        return false;
+    }
+    for (int seat = 0; seat < SEATS; ++seat) {
+        if (!strategies[seat] || !strategies[seat]->getMemoryOneResponse(responses[seat])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+MarkovGame::Matrix MarkovGame::multiply(const Matrix& a, const Matrix& b) {
+    Matrix result{};
+    for (int i = 0; i < STATES; ++i) {
+        for (int k = 0; k < STATES; ++k) {
+            double value = a[i][k];
+            for (int j = 0; j < STATES; ++j) {
+                result[i][j] += value * b[k][j];
+            }
+        }
+    }
+    return result;
+}
+
+MarkovGame::Matrix MarkovGame::add(const Matrix& a, const Matrix& b) {
+    Matrix result;
+    for (int i = 0; i < STATES; ++i) {
+        for (int j = 0; j < STATES; ++j) {
+            result[i][j] = a[i][j] + b[i][j];
+        }
+    }
+    return result;
+}
+
+std::vector<double> MarkovGame::scoresFor(const Distribution& distribution) const {
+    std::vector<double> scores(SEATS, 0.0);
+    for (int outcome = 0; outcome < STATES; ++outcome) {
+        for (int seat = 0; seat < SEATS; ++seat) {
+            scores[seat] += distribution[outcome] * table.payoff(outcome, seat);
+        }
+    }
+    return scores;
+}
+
+MarkovGame::Distribution MarkovGame::expectedVisits(long long rounds) const {
+    Distribution visits{};
+    if (rounds <= 0) {
+        return visits;
+    }
+
+    // sum = I + T + ... + T^(n-1), power = T^n; по битам rounds от старшего
+    Matrix sum{};
+    Matrix power{};
+    for (int i = 0; i < STATES; ++i) power[i][i] = 1.0;
+
+    for (int bit = 62; bit >= 0; --bit) {
+        sum = add(sum, multiply(power, sum));
+        power = multiply(power, power);
+        if ((rounds >> bit) & 1) {
+            sum = add(sum, power);
+            power = multiply(power, transition);
+        }
+    }
+
+    for (int i = 0; i < STATES; ++i) {
+        for (int j = 0; j < STATES; ++j) {
+            visits[j] += initial[i] * sum[i][j];
+        }
+    }
+    return visits;
+}
+
+std::vector<double> MarkovGame::expectedTotals(long long rounds) const {
+    return scoresFor(expectedVisits(rounds));
+}
+
+std::vector<double> MarkovGame::expectedCooperations(long long rounds) const {
+    Distribution visits = expectedVisits(rounds);
+    std::vector<double> cooperations(SEATS, 0.0);
+    for (int outcome = 0; outcome < STATES; ++outcome) {
+        for (int seat = 0; seat < SEATS; ++seat) {
+            // Ход места seat - бит (SEATS - 1 - seat) индекса исхода
+            if (!((outcome >> (SEATS - 1 - seat)) & 1)) {
+                cooperations[seat] += visits[outcome];
+            }
+        }
+    }
+    return cooperations;
+}
+
+std::vector<double> MarkovGame::expectedRoundScores(long long round) const {
+    // p0 * T^round
+    Distribution distribution = initial;
+    Matrix power = transition;
+    for (long long remaining = round; remaining > 0; remaining >>= 1) {
+        if (remaining & 1) {
+            Distribution next{};
+            for (int i = 0; i < STATES; ++i) {
+                for (int j = 0; j < STATES; ++j) {
+                    next[j] += distribution[i] * power[i][j];
+                }
+            }
+            distribution = next;
+        }
+        power = multiply(power, power);
+    }
+    return scoresFor(distribution);
+}
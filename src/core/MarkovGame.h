@@ -0,0 +1,55 @@
+#ifndef MARKOVGAME_H
+#define MARKOVGAME_H
+
+#include <array>
+#include <vector>
+#include "core/Strategy.h"
+#include "core/GameMatrix.h"
+#include "core/PayoffTable.h"
+
+// Аналитический расчёт игры трёх стратегий с памятью в один раунд.
+// Совместный исход раунда (8 состояний) образует цепь Маркова:
+// распределение первого раунда задают MemoryOneResponse::initial,
+// переходы - afterOutcome. Ожидаемые очки за rounds раундов равны
+// p0 * (I + T + ... + T^(rounds-1)) * r и считаются удвоением
+// за O(8^3 log rounds), без симуляции раундов.
+class MarkovGame {
+public:
+    static constexpr int STATES = PayoffTable::OUTCOMES;
+    static constexpr int SEATS = PayoffTable::SEATS;
+    using Distribution = std::array<double, STATES>;
+    using Matrix = std::array<Distribution, STATES>;
+
+private:
+    PayoffTable table;
+    Distribution initial;
+    Matrix transition;
+
+    // Исход с точки зрения места seat: свой ход, затем соперники по порядку мест
+    static int seatOutcome(int outcome, int seat);
+    static Matrix multiply(const Matrix& a, const Matrix& b);
+    static Matrix add(const Matrix& a, const Matrix& b);
+    std::vector<double> scoresFor(const Distribution& distribution) const;
+
+public:
+    MarkovGame(const std::array<MemoryOneResponse, SEATS>& responses,
+               const GameMatrix& matrix = GameMatrix());
+
+    // Собирает описания стратегий; false, если хотя бы одна не memory-one
+    static bool describe(const std::vector<const Strategy*>& strategies,
+                         std::array<MemoryOneResponse, SEATS>& responses);
+
+    // Ожидаемое число раундов с каждым исходом за rounds раундов
+    Distribution expectedVisits(long long rounds) const;
+    // Ожидаемые суммарные очки мест за rounds раундов
+    std::vector<double> expectedTotals(long long rounds) const;
+    // Ожидаемое число раундов сотрудничества мест за rounds раундов
+    std::vector<double> expectedCooperations(long long rounds) const;
+    // Ожидаемые очки мест в раунде round (с нуля)
+    std::vector<double> expectedRoundScores(long long round) const;
+
+    const Distribution& getInitialDistribution() const { return initial; }
+    const Matrix& getTransitionMatrix() const { return transition; }
+};
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+enum class Move {
+    COOPERATE,
+    DEFECT
+};
+
+inline char moveToChar(Move move) {
+    return (move == Move::COOPERATE) ? 'C' : 'D';
+}
+
+inline Move charToMove(char c) {
+    return (c == 'C' || c == 'c') ? Move::COOPERATE : Move::DEFECT;
+}
+
+#endif
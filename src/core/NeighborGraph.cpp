@@ -0,0 +1,98 @@
+#include "NeighborGraph.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+void NeighborGraph::buildFromEdges(uint32_t vertexCount, const std::vector<std::pair<uint32_t, uint32_t>>& edges) {
+    // Подсчёт степеней, затем раскладка по смещениям (оба направления)
+    offsets.assign(static_cast<size_t>(vertexCount) + 1, 0);
+    for (const auto& edge : edges) {
+        if (edge.first == edge.second) continue;
+        offsets[edge.first + 1]++;
+        offsets[edge.second + 1]++;
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    std::vector<uint64_t> fill(offsets.begin(), offsets.end() - 1);
+    neighbors.assign(offsets.back(), 0);
+    for (const auto& edge : edges) {
+        if (edge.first == edge.second) continue;
+        neighbors[fill[edge.first]++] = edge.second;
+        neighbors[fill[edge.second]++] = edge.first;
+    }
+
+    // Сортировка и удаление повторных рёбер со сжатием массива
+    uint64_t write = 0;
+    for (size_t v = 0; v < vertexCount; ++v) {
+        auto first = neighbors.begin() + offsets[v];
+        auto last = neighbors.begin() + offsets[v + 1];
+        std::sort(first, last);
+        last = std::unique(first, last);
+
+        uint64_t begin = write;
+        for (auto it = first; it != last; ++it) {
+            neighbors[write++] = *it;
+        }
+        offsets[v] = begin;
+    }
+    offsets[vertexCount] = write;
+    neighbors.resize(write);
+}
+
+NeighborGraph NeighborGraph::lattice(uint32_t width, uint32_t height, bool moore) {
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    edges.reserve(static_cast<size_t>(width) * height * (moore ? 4 : 2));
+
+    // Каждая клетка добавляет рёбра вправо и вниз (и диагонали для Мура)
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            uint32_t cell = y * width + x;
+            uint32_t right = y * width + (x + 1) % width;
+            uint32_t down = ((y + 1) % height) * width + x;
+            edges.emplace_back(cell, right);
+            edges.emplace_back(cell, down);
+            if (moore) {
+                edges.emplace_back(cell, ((y + 1) % height) * width + (x + 1) % width);
+                edges.emplace_back(cell, ((y + 1) % height) * width + (x + width - 1) % width);
+            }
+        }
+    }
+
+    NeighborGraph graph;
+    graph.buildFromEdges(width * height, edges);
+    return graph;
+}
+
+bool NeighborGraph::loadEdgeList(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Warning: Cannot open edge list " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    uint32_t vertexCount = 0;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+
+        std::istringstream fields(line);
+        long long u = 0, v = 0;
+        if (!(fields >> u)) continue;
+        if (!(fields >> v) || u < 0 || v < 0 || u >= UINT32_MAX || v >= UINT32_MAX) {
+            std::cerr << "Warning: Bad edge at " << filename << ":" << lineNumber << std::endl;
+            return false;
+        }
+        edges.emplace_back(static_cast<uint32_t>(u), static_cast<uint32_t>(v));
+        vertexCount = std::max(vertexCount, static_cast<uint32_t>(std::max(u, v) + 1));
+    }
+
+    buildFromEdges(vertexCount, edges);
+    return true;
+}
@@ -0,0 +1,39 @@
+#ifndef NEIGHBORGRAPH_H
+#define NEIGHBORGRAPH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Неориентированный граф соседства в формате CSR: соседи вершины v -
+// neighbors[offsets[v] .. offsets[v + 1]), по возрастанию, без петель
+// и повторов. Вершины нумеруются с нуля.
+class NeighborGraph {
+private:
+    std::vector<uint64_t> offsets;
+    std::vector<uint32_t> neighbors;
+
+    void buildFromEdges(uint32_t vertexCount, const std::vector<std::pair<uint32_t, uint32_t>>& edges);
+
+public:
+    NeighborGraph() : offsets(1, 0) {}
+
+    // Тор width x height; moore - 8 соседей вместо 4 (фон Неймана)
+    static NeighborGraph lattice(uint32_t width, uint32_t height, bool moore = false);
+    // Список рёбер "u v" по строке; '#' - комментарий. Число вершин -
+    // наибольший номер плюс один
+    bool loadEdgeList(const std::string& filename);
+    void setEdges(uint32_t vertexCount, const std::vector<std::pair<uint32_t, uint32_t>>& edges) {
+        buildFromEdges(vertexCount, edges);
+    }
+
+    uint32_t getVertexCount() const { return static_cast<uint32_t>(offsets.size() - 1); }
+    uint64_t getEdgeCount() const { return neighbors.size() / 2; }
+    uint32_t degree(uint32_t vertex) const {
+        return static_cast<uint32_t>(offsets[vertex + 1] - offsets[vertex]);
+    }
+    const uint32_t* begin(uint32_t vertex) const { return neighbors.data() + offsets[vertex]; }
+    const uint32_t* end(uint32_t vertex) const { return neighbors.data() + offsets[vertex + 1]; }
+};
+
+#endif
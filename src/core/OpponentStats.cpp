@@ -0,0 +1,73 @@
+#include "core/OpponentStats.h"
+#include <algorithm>
+
+OpponentStats::OpponentStats(size_t opponentCount, size_t window)
+    : opponents(opponentCount),
+      windowSize(std::max<size_t>(1, window)),
+      rounds(0),
+      windowPosition(0),
+      cooperations(opponentCount, 0),
+      windowCooperations(opponentCount, 0),
+      lastMoves(opponentCount, Move::COOPERATE),
+      window(windowSize * opponentCount, Move::COOPERATE) {
+}
+
+void OpponentStats::record(const Move* opponentMoves) {
+    Move* row = window.data() + windowPosition * opponents;
+    bool windowFull = rounds >= windowSize;
+    
+    for (size_t i = 0; i < opponents; ++i) {
+        Move move = opponentMoves[i];
+        size_t cooperated = (move == Move::COOPERATE) ? 1 : 0;
+        
+        // Вытесняем самый старый ход из окна
+        if (windowFull && row[i] == Move::COOPERATE) {
+            windowCooperations[i]--;
+        }
+        row[i] = move;
+        windowCooperations[i] += cooperated;
+        cooperations[i] += cooperated;
+        lastMoves[i] = move;
+    }
+    
+    windowPosition = (windowPosition + 1) % windowSize;
+    rounds++;
+}
+
+void OpponentStats::reset() {
+    rounds = 0;
+    windowPosition = 0;
+    std::fill(cooperations.begin(), cooperations.end(), 0);
+    std::fill(windowCooperations.begin(), windowCooperations.end(), 0);
+    std::fill(lastMoves.begin(), lastMoves.end(), Move::COOPERATE);
+}
+
+size_t OpponentStats::getTotalCooperations() const {
+    size_t total = 0;
+    for (size_t count : cooperations) total += count;
+    return total;
+}
+
+double OpponentStats::getCooperationRate(double defaultValue) const {
+    size_t total = rounds * opponents;
+    return total > 0 ? static_cast<double>(getTotalCooperations()) / total : defaultValue;
+}
+
+double OpponentStats::getDefectRate(double defaultValue) const {
+    size_t total = rounds * opponents;
+    return total > 0 ? static_cast<double>(getTotalDefections()) / total : defaultValue;
+}
+
+double OpponentStats::getWindowCooperationRate(double defaultValue) const {
+    size_t total = getWindowFill() * opponents;
+    if (total == 0) return defaultValue;
+    
+    size_t cooperated = 0;
+    for (size_t count : windowCooperations) cooperated += count;
+    return static_cast<double>(cooperated) / total;
+}
+
+size_t OpponentStats::getLastDefectCount() const {
+    if (rounds == 0) return 0;
+    return static_cast<size_t>(std::count(lastMoves.begin(), lastMoves.end(), Move::DEFECT));
+}
@@ -0,0 +1,53 @@
+#ifndef OPPONENTSTATS_H
+#define OPPONENTSTATS_H
+
+#include <cstddef>
+#include <vector>
+#include "core/Move.h"
+
+// Статистика по оппонентам одного игрока, которую движок обновляет
+// после каждого раунда за O(число оппонентов): общие счётчики,
+// счётчики в скользящем окне и последние ходы.
+class OpponentStats {
+private:
+    size_t opponents;
+    size_t windowSize;
+    size_t rounds;
+    size_t windowPosition;
+    
+    std::vector<size_t> cooperations;
+    std::vector<size_t> windowCooperations;
+    std::vector<Move> lastMoves;
+    std::vector<Move> window;  // кольцевой буфер: windowSize строк по opponents ходов
+    
+public:
+    OpponentStats(size_t opponentCount = 2, size_t window = 10);
+    
+    // Ходы оппонентов в том же порядке, что и в OpponentsView
+    void record(const Move* opponentMoves);
+    void record(const std::vector<Move>& opponentMoves) { record(opponentMoves.data()); }
+    void reset();
+    
+    size_t getOpponentCount() const { return opponents; }
+    size_t getWindowSize() const { return windowSize; }
+    size_t getRounds() const { return rounds; }
+    
+    // Общие счётчики
+    size_t getCooperations(size_t opponent) const { return cooperations[opponent]; }
+    size_t getDefections(size_t opponent) const { return rounds - cooperations[opponent]; }
+    size_t getTotalCooperations() const;
+    size_t getTotalDefections() const { return rounds * opponents - getTotalCooperations(); }
+    double getCooperationRate(double defaultValue = 0.5) const;
+    double getDefectRate(double defaultValue = 0.0) const;
+    
+    // Счётчики в окне из последних getWindowFill() раундов
+    size_t getWindowFill() const { return rounds < windowSize ? rounds : windowSize; }
+    size_t getWindowCooperations(size_t opponent) const { return windowCooperations[opponent]; }
+    double getWindowCooperationRate(double defaultValue = 0.5) const;
+    
+    // Последние ходы (до первого раунда - COOPERATE)
+    Move getLastMove(size_t opponent) const { return lastMoves[opponent]; }
+    size_t getLastDefectCount() const;
+};
+
+#endif
@@ -0,0 +1,66 @@
+#include "core/PackedHistory.h"
+
+namespace {
+    uint64_t reverseBits(uint64_t x) {
+        x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+        x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+        x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+        x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+        x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+        return (x >> 32) | (x << 32);
+    }
+}
+
+void PackedHistory::push_back(Move move) {
+    if ((length & 63) == 0) {
+        ranks.push_back(totalCooperations());
+        words.push_back(0);
+    }
+    if (move == Move::COOPERATE) {
+        words.back() |= uint64_t(1) << (length & 63);
+    }
+    length++;
+}
+
+void PackedHistory::setBack(Move move) {
+    uint64_t bit = uint64_t(1) << ((length - 1) & 63);
+    if (move == Move::COOPERATE) {
+        words.back() |= bit;
+    } else {
+        words.back() &= ~bit;
+    }
+}
+
+void PackedHistory::clear() {
+    words.clear();
+    ranks.clear();
+    length = 0;
+}
+
+uint64_t PackedHistory::lastMoves(size_t count, size_t end) const {
+    if (count > 64) count = 64;
+    if (count > end) count = end;
+    if (count == 0) return 0;
+    
+    size_t start = end - count;
+    size_t word = start >> 6;
+    size_t offset = start & 63;
+    
+    // Собираем 64 бита начиная с позиции start (максимум из двух слов)
+    uint64_t bits = words[word] >> offset;
+    if (offset != 0 && word + 1 < words.size()) {
+        bits |= words[word + 1] << (64 - offset);
+    }
+    
+    // Разворачиваем, чтобы самый последний ход оказался в бите 0
+    return reverseBits(bits) >> (64 - count);
+}
+
+std::vector<Move> PackedHistory::toVector() const {
+    std::vector<Move> result;
+    result.reserve(length);
+    for (size_t i = 0; i < length; ++i) {
+        result.push_back((*this)[i]);
+    }
+    return result;
+}
@@ -0,0 +1,80 @@
+#ifndef PACKEDHISTORY_H
+#define PACKEDHISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "core/Move.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+inline unsigned popcount64(uint64_t value) {
+#if defined(_MSC_VER)
+    return static_cast<unsigned>(__popcnt64(value));
+#else
+    return static_cast<unsigned>(__builtin_popcountll(value));
+#endif
+}
+
+// Упакованная история ходов одного игрока: 64 раунда в одном слове.
+// Бит равен 1, если игрок сотрудничал. Для каждого слова хранится
+// число сотрудничеств до его начала, поэтому подсчёт на любом
+// отрезке раундов выполняется за O(1).
+class PackedHistory {
+private:
+    std::vector<uint64_t> words;
+    std::vector<uint64_t> ranks;
+    size_t length;
+
+public:
+    PackedHistory() : length(0) {}
+
+    void push_back(Move move);
+    // Заменяет последний ход (счётчики прошлых слов не меняются)
+    void setBack(Move move);
+    void clear();
+
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+
+    Move operator[](size_t index) const {
+        return ((words[index >> 6] >> (index & 63)) & 1) ? Move::COOPERATE : Move::DEFECT;
+    }
+    Move back() const { return (*this)[length - 1]; }
+
+    // Число сотрудничеств в раундах [0, position)
+    size_t rank(size_t position) const {
+        size_t word = position >> 6;
+        size_t offset = position & 63;
+        if (offset == 0) {
+            return (word < ranks.size()) ? ranks[word] : totalCooperations();
+        }
+        return ranks[word] + popcount64(words[word] & ((uint64_t(1) << offset) - 1));
+    }
+
+    // Число сотрудничеств в раундах [from, to)
+    size_t countCooperations(size_t from, size_t to) const { return rank(to) - rank(from); }
+    size_t countDefections(size_t from, size_t to) const {
+        return (to - from) - countCooperations(from, to);
+    }
+
+    // Последние count ходов среди первых end раундов; count больше 64
+    // урезается до 64.
+    // Бит 0 - самый последний ход, единица - сотрудничество.
+    uint64_t lastMoves(size_t count, size_t end) const;
+    uint64_t lastMoves(size_t count) const { return lastMoves(count, length); }
+
+    std::vector<Move> toVector() const;
+    size_t memoryUsage() const {
+        return words.capacity() * sizeof(uint64_t) + ranks.capacity() * sizeof(uint64_t);
+    }
+
+private:
+    size_t totalCooperations() const {
+        return words.empty() ? 0 : ranks.back() + popcount64(words.back());
+    }
+};
+
+#endif
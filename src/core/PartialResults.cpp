@@ -0,0 +1,96 @@
+#include "PartialResults.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    const char* const MAGIC = "PDPARTIAL";
+    const int FORMAT_VERSION = 3;
+}
+
+bool PartialResults::save(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Warning: Cannot write partial results to " << filename << std::endl;
+        return false;
+    }
+
+    file << MAGIC << " " << FORMAT_VERSION << "\n";
+    write(file);
+    return static_cast<bool>(file);
+}
+
+void PartialResults::write(std::ostream& out) const {
+    out << "shard " << shardIndex << " " << shardCount << "\n";
+    out << "range " << begin << " " << end << " " << totalGroups << "\n";
+    out << "settings " << groupSize << " " << rounds << " " << replicas << " " << (analytic ? 1 : 0) << " " << seed
+        << " " << matrixHash << "\n";
+    out << "strategies " << strategyNames.size() << "\n";
+    for (size_t id = 0; id < strategyNames.size(); ++id) {
+        out << strategyNames[id] << " " << scores[id] << " " << displayNames[id] << "\n";
+    }
+}
+
+bool PartialResults::load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Warning: Cannot open partial results " << filename << std::endl;
+        return false;
+    }
+
+    std::string magic;
+    int version = 0;
+    file >> magic >> version;
+    if (magic != MAGIC || version != FORMAT_VERSION) {
+        std::cerr << "Warning: " << filename << " is not a partial results file" << std::endl;
+        return false;
+    }
+    return read(file, filename);
+}
+
+bool PartialResults::read(std::istream& in, const std::string& source) {
+    std::string key;
+    size_t count = 0;
+    int analyticFlag = 0;
+    bool ok = static_cast<bool>(in >> key >> shardIndex >> shardCount) && key == "shard";
+    ok = ok && (in >> key >> begin >> end >> totalGroups) && key == "range";
+    ok = ok && (in >> key >> groupSize >> rounds >> replicas >> analyticFlag >> seed >> matrixHash) && key == "settings";
+    ok = ok && (in >> key >> count) && key == "strategies";
+    if (!ok) {
+        std::cerr << "Warning: Corrupted header in " << source << std::endl;
+        return false;
+    }
+    analytic = analyticFlag != 0;
+
+    strategyNames.assign(count, "");
+    displayNames.assign(count, "");
+    scores.assign(count, 0);
+    for (size_t id = 0; id < count; ++id) {
+        if (!(in >> strategyNames[id] >> scores[id])) {
+            std::cerr << "Warning: Truncated results in " << source << std::endl;
+            return false;
+        }
+        std::getline(in, displayNames[id]);
+        if (!displayNames[id].empty() && displayNames[id][0] == ' ') {
+            displayNames[id].erase(0, 1);
+        }
+    }
+    return true;
+}
+
+bool PartialResults::isCompatible(const PartialResults& other) const {
+    return strategyNames == other.strategyNames &&
+           totalGroups == other.totalGroups &&
+           groupSize == other.groupSize &&
+           rounds == other.rounds &&
+           replicas == other.replicas &&
+           analytic == other.analytic &&
+           seed == other.seed &&
+           matrixHash == other.matrixHash;
+}
+
+std::string PartialResults::shardFileName(const std::string& dir, int index, int count) {
+    std::ostringstream name;
+    name << (dir.empty() ? "." : dir) << "/tournament_shard_" << index << "_of_" << count << ".txt";
+    return name.str();
+}
@@ -0,0 +1,49 @@
+#ifndef PARTIALRESULTS_H
+#define PARTIALRESULTS_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Частичные результаты турнира: очки по ID стратегий за диапазон
+// рангов групп [begin, end). Пишутся шардом (--shard=i/N) и
+// складываются командой merge. Текстовый формат:
+//   PDPARTIAL 3
+//   shard <i> <N>
+//   range <begin> <end> <total>
+//   settings <groupSize> <rounds> <replicas> <analytic> <seed> <matrixHash>
+//   strategies <count>
+//   <имя> <очки> <отображаемое имя>   (по строке на стратегию)
+struct PartialResults {
+    int shardIndex = 0;
+    int shardCount = 1;
+    uint64_t begin = 0;
+    uint64_t end = 0;
+    uint64_t totalGroups = 0;
+    int groupSize = 3;
+    int rounds = 0;
+    int replicas = 1;
+    bool analytic = false;
+    uint64_t seed = 0;
+    // Хэш матрицы выигрышей и таблицы по числу сотрудничающих
+    uint64_t matrixHash = 0;
+    std::vector<std::string> strategyNames;
+    std::vector<std::string> displayNames;
+    std::vector<long long> scores;
+
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+    // Тело файла без заголовка PDPARTIAL (используется и контрольной точкой)
+    void write(std::ostream& out) const;
+    bool read(std::istream& in, const std::string& source);
+
+    // Совпадают ли стратегии и параметры турнира
+    bool isCompatible(const PartialResults& other) const;
+
+    // Имя файла шарда в каталоге конфигураций
+    static std::string shardFileName(const std::string& dir, int index, int count);
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef PAYOFFTABLE_H
+#define PAYOFFTABLE_H
+
+#include <cstdint>
+#include "core/Move.h"
+
+// Таблица выигрышей игры трёх игроков. Три выигрыша одного исхода
+// упакованы в одно 64-битное слово (по 21 биту со смещением), поэтому
+// поиск - это одно чтение, сдвиг и вычитание без ветвлений и аллокаций.
+// Исход кодируется как m1*4 + m2*2 + m3, где C = 0, D = 1.
+class PayoffTable {
+public:
+    static constexpr int OUTCOMES = 8;
+    static constexpr int SEATS = 3;
+    static constexpr int FIELD_BITS = 21;
+    static constexpr int MIN_PAYOFF = -(1 << (FIELD_BITS - 1));
+    static constexpr int MAX_PAYOFF = (1 << (FIELD_BITS - 1)) - 1;
+
+private:
+    static constexpr uint64_t FIELD_MASK = (uint64_t(1) << FIELD_BITS) - 1;
+    static constexpr int64_t BIAS = int64_t(1) << (FIELD_BITS - 1);
+    
+    uint64_t packed[OUTCOMES];
+
+public:
+    constexpr PayoffTable() : packed{} {
+        for (int outcome = 0; outcome < OUTCOMES; ++outcome) {
+            for (int seat = 0; seat < SEATS; ++seat) {
+                set(outcome, seat, 0);
+            }
+        }
+    }
+    
+    // Значения в порядке исходов, по три выигрыша на исход
+    constexpr explicit PayoffTable(const int (&values)[OUTCOMES * SEATS]) : packed{} {
+        for (int outcome = 0; outcome < OUTCOMES; ++outcome) {
+            for (int seat = 0; seat < SEATS; ++seat) {
+                set(outcome, seat, values[outcome * SEATS + seat]);
+            }
+        }
+    }
+    
+    static constexpr int outcomeIndex(Move move1, Move move2, Move move3) {
+        return (static_cast<int>(move1) << 2) | (static_cast<int>(move2) << 1) | static_cast<int>(move3);
+    }
+    
+    constexpr int payoff(int outcome, int seat) const {
+        return static_cast<int>(static_cast<int64_t>((packed[outcome] >> (seat * FIELD_BITS)) & FIELD_MASK) - BIAS);
+    }
+    
+    constexpr int payoff(Move move1, Move move2, Move move3, int seat) const {
+        return payoff(outcomeIndex(move1, move2, move3), seat);
+    }
+    
+    // Все три выигрыша исхода одним словом
+    constexpr uint64_t packedOutcome(int outcome) const { return packed[outcome]; }
+    
+    // Значение должно лежать в [MIN_PAYOFF, MAX_PAYOFF]
+    constexpr void set(int outcome, int seat, int value) {
+        int shift = seat * FIELD_BITS;
+        uint64_t field = static_cast<uint64_t>(static_cast<int64_t>(value) + BIAS) & FIELD_MASK;
+        packed[outcome] = (packed[outcome] & ~(FIELD_MASK << shift)) | (field << shift);
+    }
+    
+    constexpr bool operator==(const PayoffTable& other) const {
+        for (int outcome = 0; outcome < OUTCOMES; ++outcome) {
+            if (packed[outcome] != other.packed[outcome]) return false;
+        }
+        return true;
+    }
+    constexpr bool operator!=(const PayoffTable& other) const { return !(*this == other); }
+};
+
+// Таблица, известная на этапе компиляции
+template <int... Values>
+struct StaticPayoffTable {
+    static_assert(sizeof...(Values) == PayoffTable::OUTCOMES * PayoffTable::SEATS,
+                  "StaticPayoffTable needs 3 payoffs for each of 8 outcomes");
+    
+    static constexpr int values[sizeof...(Values)] = { Values... };
+    static constexpr PayoffTable table = PayoffTable(values);
+    
+    static constexpr int payoff(int outcome, int seat) { return table.payoff(outcome, seat); }
+};
+
+// Матрица по умолчанию (см. GameMatrix::setDefaultMatrix)
+using DefaultPayoffTable = StaticPayoffTable<
+    7, 7, 7,    // C C C
+    3, 3, 9,    // C C D
+    3, 9, 3,    // C D C
+    0, 5, 5,    // C D D
+    9, 3, 3,    // D C C
+    5, 0, 5,    // D C D
+    5, 5, 0,    // D D C
+    1, 1, 1     // D D D
+>;
+
+#endif
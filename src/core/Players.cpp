@@ -1,25 +1,38 @@
 #include "Players.h"
 #include <algorithm>
+#include <chrono>
 
-Players::Players() {
+Players::Players()
+    : randomSeed(static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count())),
+      randomGame(0),
+      randomReplica(0) {
     resizeForThreePlayers();
 }
 
 void Players::addPlayer(std::unique_ptr<Strategy> player) {
+    strategies.emplace_back(std::move(player));
+}
+
+void Players::addPlayer(StrategySlot player) {
     strategies.push_back(std::move(player));
 }
 
 void Players::clear() {
     strategies.clear();
+    opponentStats.clear();
     history.clear();
     scores.clear();
     currentMoves.clear();
 }
 
 void Players::resizeForThreePlayers() {
-    history.resize(3);
-    scores.resize(3, 0);
-    currentMoves.resize(3);
+    resizeFor(3);
+}
+
+void Players::resizeFor(size_t playerCount) {
+    history.resize(playerCount);
+    scores.resize(playerCount, 0);
+    currentMoves.resize(playerCount);
 }
 
 bool Players::hasThreePlayers() const {
@@ -40,14 +53,14 @@ void Players::addMoveToHistory(size_t playerIndex, Move move) {
     }
 }
 
-std::vector<std::vector<Move>> Players::getOpponentsHistory(size_t playerIndex) const {
-    std::vector<std::vector<Move>> opponentsHistory;
+OpponentsView Players::getOpponentsView(size_t playerIndex) {
+    opponentViews.clear();
     for (size_t i = 0; i < history.size(); ++i) {
         if (i != playerIndex) {
-            opponentsHistory.push_back(history[i]);
+            opponentViews.emplace_back(history[i]);
         }
     }
-    return opponentsHistory;
+    return OpponentsView(opponentViews);
 }
 
 void Players::setCurrentMove(size_t playerIndex, Move move) {
@@ -56,15 +69,68 @@ void Players::setCurrentMove(size_t playerIndex, Move move) {
     }
 }
 
-void Players::addToScore(size_t playerIndex, int points) {
+void Players::addToScore(size_t playerIndex, long long points) {
     if (playerIndex < scores.size()) {
         scores[playerIndex] += points;
     }
 }
 
+void Players::prepareOpponentStats() {
+    if (opponentStats.size() == strategies.size()) return;
+    
+    // Статистика создаётся один раз, когда состав игроков известен
+    opponentStats.clear();
+    opponentStats.reserve(strategies.size());
+    for (const auto& strategy : strategies) {
+        opponentStats.emplace_back(strategies.size() - 1, strategy->getStatsWindowSize());
+    }
+    for (size_t i = 0; i < strategies.size(); ++i) {
+        strategies[i]->attachOpponentStats(&opponentStats[i]);
+    }
+    relativeMoves.resize(strategies.size());
+    relativeScores.resize(strategies.size());
+}
+
+void Players::setRandomSeed(uint64_t seed, uint64_t game, uint32_t replica) {
+    randomSeed = seed;
+    randomGame = game;
+    randomReplica = replica;
+}
+
+void Players::prepareRandomStreams() {
+    randomStreams.clear();
+    randomStreams.reserve(strategies.size());
+    for (size_t i = 0; i < strategies.size(); ++i) {
+        randomStreams.emplace_back(randomSeed, randomGame, randomReplica, static_cast<uint32_t>(i));
+    }
+    for (size_t i = 0; i < strategies.size(); ++i) {
+        strategies[i]->attachRandom(&randomStreams[i]);
+    }
+}
+
+void Players::notifyRoundResult(const std::vector<int>& roundScores, int round) {
+    size_t n = strategies.size();
+    for (size_t i = 0; i < n; ++i) {
+        // Переставляем так, чтобы свой ход был первым, а оппоненты шли по порядку
+        relativeMoves[0] = currentMoves[i];
+        relativeScores[0] = roundScores[i];
+        size_t k = 1;
+        for (size_t j = 0; j < n; ++j) {
+            if (j == i) continue;
+            relativeMoves[k] = currentMoves[j];
+            relativeScores[k] = roundScores[j];
+            k++;
+        }
+        
+        opponentStats[i].record(relativeMoves.data() + 1);
+        strategies[i]->onRoundResult(relativeMoves, relativeScores, round);
+    }
+}
+
 void Players::resetForNewGame() {
     // Очищаем историю и сбрасываем счет, но оставляем стратегии
     for (auto& h : history) h.clear();
+    for (auto& stats : opponentStats) stats.reset();
     std::fill(scores.begin(), scores.end(), 0);
     std::fill(currentMoves.begin(), currentMoves.end(), Move::COOPERATE);
 }
\ No newline at end of file
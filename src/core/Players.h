@@ -5,34 +5,50 @@
 #include <memory>
 #include <string>
 #include "core/Strategy.h"
+#include "core/StrategySlot.h"
+#include "core/RandomStream.h"
 
 class Players {
 private:
-    std::vector<std::unique_ptr<Strategy>> strategies;
-    std::vector<std::vector<Move>> history;
-    std::vector<int> scores;
+    std::vector<StrategySlot> strategies;
+    std::vector<PackedHistory> history;
+    std::vector<HistoryView> opponentViews;
+    std::vector<OpponentStats> opponentStats;
+    std::vector<Move> relativeMoves;
+    std::vector<int> relativeScores;
+    std::vector<long long> scores;
     std::vector<Move> currentMoves;
+    std::vector<RandomStream> randomStreams;
+    uint64_t randomSeed;
+    uint64_t randomGame;
+    uint32_t randomReplica;
     
 public:
     Players();
     
     // Управление игроками
     void addPlayer(std::unique_ptr<Strategy> player);
+    void addPlayer(StrategySlot player);
     void clear();
     void resizeForThreePlayers();
+    void resizeFor(size_t playerCount);
     bool hasThreePlayers() const;
+    bool hasPlayers(size_t playerCount) const { return strategies.size() == playerCount; }
     size_t count() const { return strategies.size(); }
     
     // Доступ к данным
-    const std::vector<std::unique_ptr<Strategy>>& getStrategies() const { return strategies; }
+    const std::vector<StrategySlot>& getStrategies() const { return strategies; }
+    std::vector<StrategySlot>& getStrategies() { return strategies; }
     std::vector<std::string> getNames() const;
-    std::vector<int> getScores() const { return scores; }
-    int getScore(size_t index) const { return scores[index]; }
+    const std::vector<long long>& getScores() const { return scores; }
+    long long getScore(size_t index) const { return scores[index]; }
     
     // Работа с историей
     void addMoveToHistory(size_t playerIndex, Move move);
-    const std::vector<Move>& getPlayerHistory(size_t playerIndex) const { return history[playerIndex]; }
-    std::vector<std::vector<Move>> getOpponentsHistory(size_t playerIndex) const;
+    HistoryView getPlayerHistory(size_t playerIndex) const { return HistoryView(history[playerIndex]); }
+    const PackedHistory& getPackedHistory(size_t playerIndex) const { return history[playerIndex]; }
+    // Представления действительны до следующего вызова или изменения истории
+    OpponentsView getOpponentsView(size_t playerIndex);
     
     // Текущие ходы
     void setCurrentMove(size_t playerIndex, Move move);
@@ -40,7 +56,18 @@ public:
     const std::vector<Move>& getCurrentMoves() const { return currentMoves; }
     
     // Обновление очков
-    void addToScore(size_t playerIndex, int points);
+    void addToScore(size_t playerIndex, long long points);
+    
+    // Статистика оппонентов и уведомления стратегий о результате раунда
+    void prepareOpponentStats();
+    void notifyRoundResult(const std::vector<int>& roundScores, int round);
+    const OpponentStats& getOpponentStats(size_t playerIndex) const { return opponentStats[playerIndex]; }
+    
+    // Потоки случайных чисел мест: место i получает поток
+    // (seed, game, replica, i). По умолчанию зерно берётся от часов.
+    void setRandomSeed(uint64_t seed, uint64_t game = 0, uint32_t replica = 0);
+    // Заводит потоки заново с начала и выдаёт их стратегиям
+    void prepareRandomStreams();
     
     // Сброс состояния
     void resetForNewGame();
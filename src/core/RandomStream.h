@@ -0,0 +1,169 @@
+#ifndef RANDOMSTREAM_H
+#define RANDOMSTREAM_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+// Счётчиковый генератор Philox4x32-10 (Salmon et al., Random123).
+// Блок из четырёх 32-битных слов - чистая функция ключа и счётчика,
+// поэтому поток любой игры восстанавливается независимо от остальных,
+// в любом потоке и в любом порядке.
+//
+// Поток игрока задаётся (seed, game, replica, seat):
+//   ключ    = перемешанные seed и seat
+//   счётчик = {номер блока, replica, game (64 бита)}
+// На поток приходится 2^32 блоков (2^34 слова).
+//
+// Слова выдаются из буфера на BUFFER_BLOCKS блоков, которые считаются
+// одним проходом по независимым дорожкам (компилятор векторизует
+// умножения). Случайный бит стоит сдвиг, испытание Бернулли - одно
+// слово и сравнение с порогом, без перевода в double.
+class RandomStream {
+public:
+    static const int BUFFER_BLOCKS = 16;
+    static const int BUFFER_WORDS = BUFFER_BLOCKS * 4;
+
+private:
+    uint32_t key[2];
+    uint32_t counter[4];
+    alignas(32) uint32_t buffer[BUFFER_WORDS];
+    int used;
+    uint64_t bits;
+    int bitsLeft;
+
+    static uint32_t mulhilo(uint32_t a, uint32_t b, uint32_t& hi) {
+        uint64_t product = static_cast<uint64_t>(a) * b;
+        hi = static_cast<uint32_t>(product >> 32);
+        return static_cast<uint32_t>(product);
+    }
+
+    static uint64_t mix(uint64_t value) {
+        // splitmix64
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    void refill() {
+        generateBlocks(counter, key, buffer);
+        counter[0] += BUFFER_BLOCKS;
+        used = 0;
+    }
+
+public:
+    RandomStream(uint64_t seed = 0, uint64_t game = 0, uint32_t replica = 0, uint32_t seat = 0) {
+        uint64_t mixed = mix(seed ^ mix(seat));
+        key[0] = static_cast<uint32_t>(mixed);
+        key[1] = static_cast<uint32_t>(mixed >> 32);
+        counter[0] = 0;
+        counter[1] = replica;
+        counter[2] = static_cast<uint32_t>(game);
+        counter[3] = static_cast<uint32_t>(game >> 32);
+        used = BUFFER_WORDS;
+        bits = 0;
+        bitsLeft = 0;
+    }
+
+    // Один блок Philox4x32-10 без состояния
+    static void generate(const uint32_t in[4], const uint32_t inKey[2], uint32_t out[4]) {
+        uint32_t c0 = in[0], c1 = in[1], c2 = in[2], c3 = in[3];
+        uint32_t k0 = inKey[0], k1 = inKey[1];
+        for (int round = 0; round < 10; ++round) {
+            uint32_t hi0, hi1;
+            uint32_t lo0 = mulhilo(0xD2511F53u, c0, hi0);
+            uint32_t lo1 = mulhilo(0xCD9E8D57u, c2, hi1);
+            c0 = hi1 ^ c1 ^ k0;
+            c1 = lo1;
+            c2 = hi0 ^ c3 ^ k1;
+            c3 = lo0;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+    // BUFFER_BLOCKS блоков подряд с номерами in[0], in[0] + 1, ...;
+    // блок b занимает out[4b..4b+3], как при поблочном generate
+    static void generateBlocks(const uint32_t in[4], const uint32_t inKey[2], uint32_t out[BUFFER_WORDS]) {
+        uint32_t c0[BUFFER_BLOCKS], c1[BUFFER_BLOCKS], c2[BUFFER_BLOCKS], c3[BUFFER_BLOCKS];
+        for (int b = 0; b < BUFFER_BLOCKS; ++b) {
+            c0[b] = in[0] + static_cast<uint32_t>(b);
+            c1[b] = in[1];
+            c2[b] = in[2];
+            c3[b] = in[3];
+        }
+        uint32_t k0 = inKey[0], k1 = inKey[1];
+        for (int round = 0; round < 10; ++round) {
+            for (int b = 0; b < BUFFER_BLOCKS; ++b) {
+                uint64_t product0 = static_cast<uint64_t>(0xD2511F53u) * c0[b];
+                uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57u) * c2[b];
+                c0[b] = static_cast<uint32_t>(product1 >> 32) ^ c1[b] ^ k0;
+                c1[b] = static_cast<uint32_t>(product1);
+                c2[b] = static_cast<uint32_t>(product0 >> 32) ^ c3[b] ^ k1;
+                c3[b] = static_cast<uint32_t>(product0);
+            }
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        for (int b = 0; b < BUFFER_BLOCKS; ++b) {
+            out[4 * b] = c0[b];
+            out[4 * b + 1] = c1[b];
+            out[4 * b + 2] = c2[b];
+            out[4 * b + 3] = c3[b];
+        }
+    }
+
+    uint32_t nextUint32() {
+        if (used == BUFFER_WORDS) refill();
+        return buffer[used++];
+    }
+
+    uint64_t nextUint64() {
+        uint64_t high = nextUint32();
+        return (high << 32) | nextUint32();
+    }
+
+    // Равномерно в [0, 1), 53 значащих бита
+    double nextDouble() {
+        return static_cast<double>(nextUint64() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Честная монета: биты слов потока по одному
+    bool nextBit() {
+        if (bitsLeft == 0) {
+            bits = nextUint64();
+            bitsLeft = 64;
+        }
+        bool bit = bits & 1;
+        bits >>= 1;
+        --bitsLeft;
+        return bit;
+    }
+
+    // Порог для bernoulli: вероятность с шагом 2^-32, 1.0 - всегда
+    static uint64_t threshold(double probability) {
+        if (!(probability > 0.0)) return 0;
+        if (probability >= 1.0) return uint64_t(1) << 32;
+        return static_cast<uint64_t>(probability * 4294967296.0);
+    }
+
+    bool bernoulliThreshold(uint64_t limit) { return nextUint32() < limit; }
+    bool bernoulli(double probability) { return bernoulliThreshold(threshold(probability)); }
+
+    // Генератор текущего потока с зерном от часов - для стратегий,
+    // вызываемых без движка
+    static RandomStream& threadFallback() {
+        thread_local RandomStream stream(
+            static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()),
+            std::hash<std::thread::id>()(std::this_thread::get_id()));
+        return stream;
+    }
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "ReplicatorDynamics.h"
+#include <algorithm>
+#include <numeric>
+
+ReplicatorDynamics::ReplicatorDynamics(size_t strategyCount, std::vector<double> payoffs)
+    : count(strategyCount),
+      tensor(std::move(payoffs)),
+      shares(strategyCount, strategyCount ? 1.0 / strategyCount : 0.0),
+      fitness(strategyCount, 0.0),
+      partial(strategyCount, 0.0),
+      offset(0.0),
+      generation(0) {
+    tensor.resize(count * count * count, 0.0);
+
+    // Сдвиг до неотрицательной приспособленности
+    double minPayoff = tensor.empty() ? 0.0 : *std::min_element(tensor.begin(), tensor.end());
+    offset = minPayoff < 0.0 ? -minPayoff : 0.0;
+    computeFitness();
+}
+
+void ReplicatorDynamics::computeFitness() {
+    // Свёртка по j как сумма строк A[i][j][*] с весами x_j: внутренний
+    // цикл идёт подряд по памяти и без редукции, поэтому векторизуется
+    for (size_t i = 0; i < count; ++i) {
+        std::fill(partial.begin(), partial.end(), 0.0);
+        const double* block = &tensor[index(i, 0, 0)];
+        for (size_t j = 0; j < count; ++j) {
+            const double weight = shares[j];
+            if (weight == 0.0) continue;
+            const double* row = block + j * count;
+            double* out = partial.data();
+            for (size_t k = 0; k < count; ++k) {
+                out[k] += weight * row[k];
+            }
+        }
+        fitness[i] = std::inner_product(partial.begin(), partial.end(), shares.begin(), 0.0);
+    }
+}
+
+bool ReplicatorDynamics::setShares(const std::vector<double>& initial) {
+    if (initial.size() != count) return false;
+    double total = 0.0;
+    for (double share : initial) {
+        if (share < 0.0) return false;
+        total += share;
+    }
+    if (total <= 0.0) return false;
+
+    for (size_t i = 0; i < count; ++i) {
+        shares[i] = initial[i] / total;
+    }
+    generation = 0;
+    computeFitness();
+    return true;
+}
+
+bool ReplicatorDynamics::step() {
+    double mean = getMeanFitness() + offset;
+    if (mean <= 0.0) return false;
+
+    // Деление на сумму вместо mean гасит накопление ошибки округления
+    double total = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        shares[i] *= (fitness[i] + offset) / mean;
+        if (shares[i] < EXTINCTION_SHARE) shares[i] = 0.0;
+        total += shares[i];
+    }
+    for (double& share : shares) {
+        share /= total;
+    }
+
+    ++generation;
+    computeFitness();
+    return true;
+}
+
+double ReplicatorDynamics::getMeanFitness() const {
+    return std::inner_product(fitness.begin(), fitness.end(), shares.begin(), 0.0);
+}
@@ -0,0 +1,51 @@
+#ifndef REPLICATORDYNAMICS_H
+#define REPLICATORDYNAMICS_H
+
+#include <cstddef>
+#include <vector>
+
+// Дискретная динамика репликаторов для игр трёх игроков.
+// Тензор выигрышей A[i][j][k] - средний выигрыш за раунд стратегии i
+// против соперников j и k (симметричен по j, k). Соперники выбираются
+// из бесконечной популяции с долями x, поэтому приспособленность
+//   f_i = sum_jk x_j x_k A[i][j][k],
+// а новые доли x_i' = x_i (f_i + c) / (phi + c), phi = sum_i x_i f_i.
+// Сдвиг c делает приспособленность положительной при отрицательных
+// выигрышах. Поколение стоит O(n^3) умножений без повторных игр.
+class ReplicatorDynamics {
+private:
+    size_t count;
+    std::vector<double> tensor;   // [(i * n + j) * n + k]
+    std::vector<double> shares;
+    std::vector<double> fitness;
+    std::vector<double> partial;  // sum_j x_j A[i][j][k] для текущего i
+    double offset;
+    int generation;
+
+    void computeFitness();
+
+public:
+    // Доля ниже порога обнуляется (стратегия вымерла): иначе доли уходят
+    // в денормализованные числа, и каждое поколение замедляется в разы
+    static constexpr double EXTINCTION_SHARE = 1e-100;
+
+    // tensor - n*n*n значений в порядке index(i, j, k)
+    ReplicatorDynamics(size_t strategyCount, std::vector<double> tensor);
+
+    size_t index(size_t i, size_t j, size_t k) const { return (i * count + j) * count + k; }
+    double payoff(size_t i, size_t j, size_t k) const { return tensor[index(i, j, k)]; }
+
+    // Доли нормируются; false, если размер не совпадает или сумма не положительна
+    bool setShares(const std::vector<double>& initial);
+    // Одно поколение; false, если средняя приспособленность не положительна
+    bool step();
+
+    const std::vector<double>& getShares() const { return shares; }
+    // Приспособленность (без сдвига) при текущих долях
+    const std::vector<double>& getFitness() const { return fitness; }
+    double getMeanFitness() const;
+    int getGeneration() const { return generation; }
+    size_t getStrategyCount() const { return count; }
+};
+
+#endif
@@ -0,0 +1,66 @@
+#include "ResultCache.h"
+#include <iostream>
+#include <sstream>
+
+bool ResultCache::open(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    filename = name;
+    entries.clear();
+    if (appendFile.is_open()) appendFile.close();
+
+    // Оборванная последняя строка (сбой при записи) пропускается
+    std::ifstream file(filename);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        uint64_t key = 0;
+        size_t seats = 0;
+        if (!(fields >> std::hex >> key >> std::dec >> seats) || seats == 0) continue;
+
+        std::vector<long long> scores(seats);
+        bool complete = true;
+        for (auto& score : scores) {
+            if (!(fields >> score)) {
+                complete = false;
+                break;
+            }
+        }
+        if (complete) entries[key] = std::move(scores);
+    }
+
+    appendFile.open(filename, std::ios::app);
+    if (!appendFile.is_open()) {
+        std::cerr << "Warning: Cannot open result cache " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ResultCache::lookup(uint64_t key, std::vector<long long>& seatScores) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end() || it->second.size() != seatScores.size()) return false;
+    seatScores = it->second;
+    return true;
+}
+
+void ResultCache::store(uint64_t key, const std::vector<long long>& seatScores) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!entries.emplace(key, seatScores).second) return;
+    if (!appendFile.is_open()) return;
+
+    appendFile << std::hex << key << std::dec << " " << seatScores.size();
+    for (long long score : seatScores) {
+        appendFile << " " << score;
+    }
+    appendFile << "\n" << std::flush;
+}
+
+size_t ResultCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+std::string ResultCache::fileName(const std::string& dir) {
+    return (dir.empty() ? "." : dir) + "/game_cache.txt";
+}
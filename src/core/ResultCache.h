@@ -0,0 +1,50 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Кэш результатов игр на диске с адресацией по содержимому: ключ -
+// FNV-1a от всего, что определяет исход игры (конфигурации стратегий
+// по местам, выигрыши матрицы, число раундов, повторов, зерно --seed).
+// Изменение конфигурации или матрицы даёт новые ключи, поэтому
+// устаревшие записи просто перестают находиться.
+// Файл дописывается строками
+//   <ключ hex> <число мест> <очки места 0> ...
+// и целиком читается при открытии. Методы потокобезопасны.
+class ResultCache {
+private:
+    std::string filename;
+    std::unordered_map<uint64_t, std::vector<long long>> entries;
+    std::ofstream appendFile;
+    mutable std::mutex mutex;
+
+public:
+    static constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+    static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+    // Продолжение хэша hash байтами data
+    static uint64_t hash(const std::string& data, uint64_t hash = FNV_OFFSET) {
+        for (unsigned char byte : data) {
+            hash ^= byte;
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    // Читает существующие записи и открывает файл на дозапись
+    bool open(const std::string& filename);
+    bool isOpen() const { return appendFile.is_open(); }
+
+    bool lookup(uint64_t key, std::vector<long long>& seatScores) const;
+    void store(uint64_t key, const std::vector<long long>& seatScores);
+    size_t size() const;
+
+    static std::string fileName(const std::string& dir);
+};
+
+#endif
@@ -0,0 +1,349 @@
+#include "core/ResultsTable.h"
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    const char MAGIC[8] = {'P', 'D', 'R', 'E', 'S', 'U', 'L', 'T'};
+    const char* SOURCE_NAMES[] = {"played", "cached", "analytic"};
+
+    template <typename T>
+    void appendValue(std::string& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void appendName(std::string& out, const std::string& name) {
+        appendValue<uint32_t>(out, static_cast<uint32_t>(name.size()));
+        out += name;
+    }
+
+    // Последовательное чтение с проверкой границ
+    class Cursor {
+    private:
+        const std::string& data;
+        size_t position;
+
+    public:
+        explicit Cursor(const std::string& source) : data(source), position(0) {}
+
+        size_t remaining() const { return data.size() - position; }
+
+        template <typename T>
+        bool read(T& value) {
+            if (remaining() < sizeof(T)) return false;
+            std::memcpy(&value, data.data() + position, sizeof(T));
+            position += sizeof(T);
+            return true;
+        }
+
+        bool readBytes(size_t count, std::string& out) {
+            if (remaining() < count) return false;
+            out.assign(data, position, count);
+            position += count;
+            return true;
+        }
+
+        bool appendBytes(size_t count, std::string& out) {
+            if (remaining() < count) return false;
+            out.append(data, position, count);
+            position += count;
+            return true;
+        }
+
+        bool readName(std::string& out) {
+            uint32_t length;
+            return read(length) && readBytes(length, out);
+        }
+    };
+}
+
+size_t ResultsTable::typeWidth(ColumnType type) {
+    switch (type) {
+        case UINT8: return 1;
+        case INT32:
+        case UINT32: return 4;
+        case INT64:
+        case UINT64: return 8;
+    }
+    return 0;
+}
+
+std::string ResultsTable::fileName(const std::string& dir, int shardIndex, int shardCount) {
+    std::string name = (dir.empty() ? "." : dir) + "/tournament_results";
+    if (shardCount > 1) {
+        name += "_" + std::to_string(shardIndex) + "_of_" + std::to_string(shardCount);
+    }
+    return name + ".pdr";
+}
+
+std::string ResultsTable::csvFileName(const std::string& filename) {
+    size_t dot = filename.find_last_of('.');
+    size_t slash = filename.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return filename + ".csv";
+    }
+    return filename.substr(0, dot) + ".csv";
+}
+
+bool ResultsWriter::open(const std::string& filename, const std::vector<std::string>& names,
+                         int seats, int rounds, int replicas, uint64_t runSeed, uint64_t matrixHash,
+                         const KeepGame& keep) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (binaryFile.is_open()) binaryFile.close();
+    if (csvFile.is_open()) csvFile.close();
+    strategyNames = names;
+    groupSize = static_cast<uint32_t>(seats);
+    seed = runSeed;
+    bufferedRows = 0;
+    rows = 0;
+
+    using namespace ResultsTable;
+    columns.clear();
+    const char* seatColumns[] = {"id", "score", "coop"};
+    const ColumnType seatTypes[] = {UINT32, INT64, INT64};
+    for (int kind = 0; kind < 3; ++kind) {
+        for (uint32_t seat = 0; seat < groupSize; ++seat) {
+            columns.push_back({seatColumns[kind] + std::to_string(seat), seatTypes[kind], ""});
+        }
+    }
+    columns.push_back({"replica", INT32, ""});
+    columns.push_back({"source", UINT8, ""});
+    columns.push_back({"seed", UINT64, ""});
+    columns.push_back({"wall_ns", INT64, ""});
+
+    std::string header(MAGIC, sizeof(MAGIC));
+    appendValue<uint32_t>(header, VERSION);
+    appendValue<uint32_t>(header, groupSize);
+    appendValue<uint32_t>(header, static_cast<uint32_t>(rounds));
+    appendValue<uint32_t>(header, static_cast<uint32_t>(replicas));
+    appendValue<uint64_t>(header, seed);
+    appendValue<uint64_t>(header, matrixHash);
+    appendValue<uint32_t>(header, static_cast<uint32_t>(strategyNames.size()));
+    for (const auto& name : strategyNames) appendName(header, name);
+    appendValue<uint32_t>(header, static_cast<uint32_t>(columns.size()));
+    for (const auto& column : columns) {
+        appendValue<uint8_t>(header, column.type);
+        appendName(header, column.name);
+    }
+
+    std::string csvName = csvFileName(filename);
+    ResultsReader previous;
+    bool resumed = false;
+    if (keep && std::ifstream(filename, std::ios::binary).is_open() && previous.open(filename)) {
+        std::vector<std::string> columnNames;
+        for (const auto& column : columns) columnNames.push_back(column.name);
+        resumed = previous.getGroupSize() == groupSize && previous.getRounds() == static_cast<uint32_t>(rounds) &&
+                  previous.getReplicas() == static_cast<uint32_t>(replicas) && previous.getSeed() == seed &&
+                  previous.getMatrixHash() == matrixHash && previous.getStrategyNames() == strategyNames &&
+                  previous.getColumnNames() == columnNames;
+        if (!resumed) {
+            std::cerr << "Warning: Results table " << filename
+                      << " belongs to a different tournament, rewriting it" << std::endl;
+        }
+    }
+    if (!resumed) return create(filename, csvName, header);
+
+    // Продолжение: нужные строки переписываются во временные файлы,
+    // строки незавершённых блоков и оборванный хвост пропадают
+    std::string binaryTemporary = filename + ".tmp";
+    std::string csvTemporary = csvName + ".tmp";
+    if (!create(binaryTemporary, csvTemporary, header)) return false;
+
+    std::vector<std::vector<uint32_t>> ids(groupSize);
+    std::vector<std::vector<int64_t>> scores(groupSize), cooperations(groupSize);
+    std::vector<int32_t> replicaColumn;
+    std::vector<uint8_t> sources;
+    std::vector<int64_t> wallNanos;
+    for (uint32_t seat = 0; seat < groupSize; ++seat) {
+        std::string suffix = std::to_string(seat);
+        previous.getColumn("id" + suffix, ids[seat]);
+        previous.getColumn("score" + suffix, scores[seat]);
+        previous.getColumn("coop" + suffix, cooperations[seat]);
+    }
+    previous.getColumn("replica", replicaColumn);
+    previous.getColumn("source", sources);
+    previous.getColumn("wall_ns", wallNanos);
+
+    ResultRow row;
+    row.ids.resize(groupSize);
+    row.scores.resize(groupSize);
+    row.cooperations.resize(groupSize);
+    for (uint64_t r = 0; r < previous.getRowCount(); ++r) {
+        bool valid = sources[r] <= ANALYTIC;
+        for (uint32_t seat = 0; seat < groupSize; ++seat) {
+            row.ids[seat] = ids[seat][r];
+            row.scores[seat] = scores[seat][r];
+            row.cooperations[seat] = cooperations[seat][r];
+            valid = valid && row.ids[seat] < strategyNames.size();
+        }
+        if (!valid || !keep(row.ids)) continue;
+        row.replica = replicaColumn[r];
+        row.source = static_cast<Source>(sources[r]);
+        row.wallNanos = wallNanos[r];
+        appendRow(row);
+    }
+    writeChunk();
+    binaryFile.close();
+    csvFile.close();
+
+    std::error_code error;
+    std::filesystem::rename(binaryTemporary, filename, error);
+    if (!error) std::filesystem::rename(csvTemporary, csvName, error);
+    if (error) {
+        std::cerr << "Warning: Cannot replace " << filename << ": " << error.message() << std::endl;
+        return false;
+    }
+    binaryFile.open(filename, std::ios::binary | std::ios::app);
+    csvFile.open(csvName, std::ios::app);
+    if (!binaryFile.is_open() || !csvFile.is_open()) {
+        std::cerr << "Warning: Cannot write results table to " << filename << std::endl;
+        binaryFile.close();
+        csvFile.close();
+        return false;
+    }
+    return true;
+}
+
+bool ResultsWriter::create(const std::string& binaryName, const std::string& csvName, const std::string& header) {
+    binaryFile.open(binaryName, std::ios::binary | std::ios::trunc);
+    binaryFile.write(header.data(), header.size());
+    csvFile.open(csvName, std::ios::trunc);
+    for (uint32_t seat = 0; seat < groupSize; ++seat) csvFile << "strategy" << seat << ",";
+    for (size_t c = groupSize; c < columns.size(); ++c) {
+        csvFile << columns[c].name << (c + 1 < columns.size() ? "," : "\n");
+    }
+    if (!binaryFile.is_open() || !csvFile.is_open()) {
+        std::cerr << "Warning: Cannot write results table to " << binaryName << std::endl;
+        binaryFile.close();
+        csvFile.close();
+        return false;
+    }
+    return true;
+}
+
+void ResultsWriter::append(const ResultRow& row) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (binaryFile.is_open()) appendRow(row);
+}
+
+void ResultsWriter::appendRow(const ResultRow& row) {
+    std::ostringstream line;
+    for (uint32_t seat = 0; seat < groupSize; ++seat) {
+        uint32_t id = row.ids[seat];
+        put<uint32_t>(columns[seat].data, id);
+        line << (id < strategyNames.size() ? strategyNames[id] : std::to_string(id)) << ",";
+    }
+    for (uint32_t seat = 0; seat < groupSize; ++seat) {
+        put<int64_t>(columns[groupSize + seat].data, row.scores[seat]);
+        line << row.scores[seat] << ",";
+    }
+    for (uint32_t seat = 0; seat < groupSize; ++seat) {
+        int64_t cooperations = row.cooperations.empty() ? -1 : row.cooperations[seat];
+        put<int64_t>(columns[2 * groupSize + seat].data, cooperations);
+        line << cooperations << ",";
+    }
+    size_t tail = 3 * groupSize;
+    put<int32_t>(columns[tail].data, row.replica);
+    put<uint8_t>(columns[tail + 1].data, row.source);
+    put<uint64_t>(columns[tail + 2].data, seed);
+    put<int64_t>(columns[tail + 3].data, row.wallNanos);
+    line << row.replica << "," << SOURCE_NAMES[row.source] << "," << seed << "," << row.wallNanos << "\n";
+    csvFile << line.str();
+
+    ++rows;
+    if (++bufferedRows == ResultsTable::CHUNK_ROWS) writeChunk();
+}
+
+void ResultsWriter::writeChunk() {
+    if (bufferedRows == 0) return;
+    binaryFile.write(reinterpret_cast<const char*>(&bufferedRows), sizeof(bufferedRows));
+    for (auto& column : columns) {
+        binaryFile.write(column.data.data(), static_cast<std::streamsize>(column.data.size()));
+        column.data.clear();
+    }
+    bufferedRows = 0;
+    binaryFile.flush();
+    csvFile.flush();
+}
+
+void ResultsWriter::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (binaryFile.is_open()) writeChunk();
+}
+
+void ResultsWriter::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!binaryFile.is_open()) return;
+    writeChunk();
+    binaryFile.close();
+    csvFile.close();
+}
+
+bool ResultsReader::open(const std::string& filename) {
+    rows = 0;
+    strategyNames.clear();
+    columns.clear();
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Warning: Cannot read results table " << filename << std::endl;
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    std::string data = buffer.str();
+    Cursor cursor(data);
+
+    auto fail = [&]() {
+        std::cerr << "Warning: Invalid results table " << filename << std::endl;
+        strategyNames.clear();
+        columns.clear();
+        return false;
+    };
+
+    std::string magic;
+    uint32_t version, strategyCount, columnCount;
+    if (!cursor.readBytes(sizeof(MAGIC), magic) || magic != std::string(MAGIC, sizeof(MAGIC)) ||
+        !cursor.read(version) || version != ResultsTable::VERSION ||
+        !cursor.read(groupSize) || !cursor.read(rounds) || !cursor.read(replicas) ||
+        !cursor.read(seed) || !cursor.read(matrixHash) || !cursor.read(strategyCount)) {
+        return fail();
+    }
+    strategyNames.resize(strategyCount);
+    for (auto& name : strategyNames) {
+        if (!cursor.readName(name)) return fail();
+    }
+    if (!cursor.read(columnCount)) return fail();
+    columns.resize(columnCount);
+    size_t rowWidth = 0;
+    for (auto& column : columns) {
+        uint8_t type;
+        if (!cursor.read(type) || type > ResultsTable::UINT64 || !cursor.readName(column.name)) return fail();
+        column.type = static_cast<ResultsTable::ColumnType>(type);
+        rowWidth += ResultsTable::typeWidth(column.type);
+    }
+
+    // Блок длиннее CHUNK_ROWS строк - мусор, а не данные
+    uint32_t chunkRows;
+    while (cursor.read(chunkRows) && chunkRows <= ResultsTable::CHUNK_ROWS &&
+           cursor.remaining() >= chunkRows * rowWidth) {
+        for (auto& column : columns) {
+            cursor.appendBytes(chunkRows * ResultsTable::typeWidth(column.type), column.data);
+        }
+        rows += chunkRows;
+    }
+    return true;
+}
+
+const ResultsReader::Column* ResultsReader::find(const std::string& name) const {
+    for (const auto& column : columns) {
+        if (column.name == name) return &column;
+    }
+    return nullptr;
+}
+
+std::vector<std::string> ResultsReader::getColumnNames() const {
+    std::vector<std::string> names;
+    for (const auto& column : columns) names.push_back(column.name);
+    return names;
+}
@@ -0,0 +1,152 @@
+#ifndef RESULTSTABLE_H
+#define RESULTSTABLE_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Результаты турнира по играм: строка на игру (повтор), столбцы
+// фиксированной ширины. Пишутся по мере завершения игр сразу в два
+// файла: двоичный столбцовый <имя>.pdr и <имя>.csv.
+//
+// Столбцы для группы из G мест:
+//   id0..id{G-1}        u32  ID стратегий по местам (номер в списке имён)
+//   score0..            i64  очки мест
+//   coop0..             i64  раунды сотрудничества мест, -1 - неизвестно
+//   replica             i32  номер повтора, -1 - сумма по всем повторам
+//   source              u8   PLAYED, CACHED или ANALYTIC
+//   seed                u64  зерно --seed
+//   wall_ns             i64  время игры, нс (у пакета - доля на повтор)
+// Строки из кэша и аналитические - одна на группу (replica = -1);
+// у кэша сотрудничество неизвестно, у аналитики - округлённое ожидание.
+//
+// Файл .pdr (порядок байтов машины):
+//   "PDRESULT" <версия u32> <мест u32> <раундов u32> <повторов u32>
+//   <seed u64> <хэш матрицы u64> <число стратегий u32> (<длина u32> <имя>)...
+//   <число столбцов u32> (<тип u8> <длина u32> <имя>)...
+//   блоки до CHUNK_ROWS строк: <строк u32>, затем каждый столбец
+//   целиком (строк x ширина типа)
+// В CSV вместо ID мест - имена стратегий (столбцы strategy0..).
+namespace ResultsTable {
+    const uint32_t VERSION = 2;
+    const uint32_t CHUNK_ROWS = 4096;
+    enum ColumnType : uint8_t { UINT8 = 0, INT32 = 1, UINT32 = 2, INT64 = 3, UINT64 = 4 };
+    enum Source : uint8_t { PLAYED = 0, CACHED = 1, ANALYTIC = 2 };
+
+    size_t typeWidth(ColumnType type);
+    // <dir>/tournament_results.pdr, у шарда - с номером шарда
+    std::string fileName(const std::string& dir, int shardIndex = 0, int shardCount = 1);
+    // То же имя с расширением .csv
+    std::string csvFileName(const std::string& filename);
+}
+
+struct ResultRow {
+    std::vector<uint32_t> ids;
+    std::vector<long long> scores;
+    std::vector<long long> cooperations;   // пусто - неизвестно
+    int32_t replica;
+    ResultsTable::Source source;
+    int64_t wallNanos;
+};
+
+// Запись строк; append потокобезопасен
+class ResultsWriter {
+private:
+    struct Column {
+        std::string name;
+        ResultsTable::ColumnType type;
+        std::string data;
+    };
+
+    std::ofstream binaryFile;
+    std::ofstream csvFile;
+    std::vector<std::string> strategyNames;
+    std::vector<Column> columns;
+    uint32_t groupSize;
+    uint64_t seed;
+    uint32_t bufferedRows;
+    uint64_t rows;
+    std::mutex mutex;
+
+    template <typename T>
+    static void put(std::string& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    // Создаёт файлы с заголовками
+    bool create(const std::string& binaryName, const std::string& csvName, const std::string& header);
+    void appendRow(const ResultRow& row);
+    void writeChunk();
+
+public:
+    // Оставить ли при продолжении строку игры с такими ID по местам
+    using KeepGame = std::function<bool(const std::vector<uint32_t>& ids)>;
+
+    ResultsWriter() : groupSize(0), seed(0), bufferedRows(0), rows(0) {}
+    ~ResultsWriter() { close(); }
+
+    // Без keep файлы создаются заново. С keep (продолжение турнира)
+    // из .pdr с тем же заголовком сохраняются строки целых блоков,
+    // для которых keep вернул true; CSV строится заново по ним
+    bool open(const std::string& filename, const std::vector<std::string>& strategyNames,
+              int groupSize, int rounds, int replicas, uint64_t seed, uint64_t matrixHash,
+              const KeepGame& keep = nullptr);
+    bool isOpen() const { return binaryFile.is_open(); }
+    void append(const ResultRow& row);
+    // Дописывает неполный блок в файлы (перед записью контрольной точки)
+    void flush();
+    // Дописывает неполный блок и закрывает файлы; число строк сохраняется
+    void close();
+    uint64_t getRowCount() const { return rows; }
+};
+
+// Загрузка .pdr целиком: блоки склеиваются в сплошные столбцы
+class ResultsReader {
+private:
+    struct Column {
+        std::string name;
+        ResultsTable::ColumnType type;
+        std::string data;
+    };
+
+    uint32_t groupSize;
+    uint32_t rounds;
+    uint32_t replicas;
+    uint64_t seed;
+    uint64_t matrixHash;
+    uint64_t rows;
+    std::vector<std::string> strategyNames;
+    std::vector<Column> columns;
+
+    const Column* find(const std::string& name) const;
+
+public:
+    ResultsReader() : groupSize(0), rounds(0), replicas(0), seed(0), matrixHash(0), rows(0) {}
+
+    // Чтение останавливается на оборванном или испорченном блоке
+    bool open(const std::string& filename);
+
+    uint32_t getGroupSize() const { return groupSize; }
+    uint32_t getRounds() const { return rounds; }
+    uint32_t getReplicas() const { return replicas; }
+    uint64_t getSeed() const { return seed; }
+    uint64_t getMatrixHash() const { return matrixHash; }
+    uint64_t getRowCount() const { return rows; }
+    const std::vector<std::string>& getStrategyNames() const { return strategyNames; }
+    std::vector<std::string> getColumnNames() const;
+
+    // false, если столбца нет или ширина типа не совпадает с T
+    template <typename T>
+    bool getColumn(const std::string& name, std::vector<T>& out) const {
+        const Column* column = find(name);
+        if (!column || ResultsTable::typeWidth(column->type) != sizeof(T)) return false;
+        out.resize(rows);
+        if (rows > 0) std::memcpy(out.data(), column->data.data(), column->data.size());
+        return true;
+    }
+};
+
+#endif
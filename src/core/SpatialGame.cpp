@@ -0,0 +1,137 @@
+#include "SpatialGame.h"
+#include <algorithm>
+#include <random>
+#include <thread>
+
+SpatialGame::SpatialGame(const NeighborGraph& graph, size_t strategyCount, std::vector<double> payoffs)
+    : graph(graph),
+      strategyCount(strategyCount),
+      tensor(std::move(payoffs)),
+      selfPairs(strategyCount * strategyCount, 0.0),
+      strategies(graph.getVertexCount(), 0),
+      nextStrategies(graph.getVertexCount(), 0),
+      scores(graph.getVertexCount(), 0.0),
+      threads(1),
+      generation(0) {
+    tensor.resize(strategyCount * strategyCount * strategyCount, 0.0);
+    for (size_t i = 0; i < strategyCount; ++i) {
+        for (size_t j = 0; j < strategyCount; ++j) {
+            selfPairs[i * strategyCount + j] = payoff(i, j, j);
+        }
+    }
+}
+
+void SpatialGame::seedUniform(uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<size_t> pick(0, strategyCount ? strategyCount - 1 : 0);
+    for (auto& strategy : strategies) {
+        strategy = static_cast<StrategyId>(pick(rng));
+    }
+    generation = 0;
+}
+
+void SpatialGame::setStrategies(const std::vector<StrategyId>& initial) {
+    std::copy_n(initial.begin(), std::min(initial.size(), strategies.size()), strategies.begin());
+    generation = 0;
+}
+
+void SpatialGame::setThreads(int count) {
+    if (count <= 0) {
+        unsigned hardware = std::thread::hardware_concurrency();
+        count = hardware > 0 ? static_cast<int>(hardware) : 1;
+    }
+    threads = count;
+}
+
+template <typename Body>
+void SpatialGame::parallelFor(Body body) {
+    uint32_t count = graph.getVertexCount();
+    uint32_t workers = std::max<uint32_t>(1, std::min<uint32_t>(threads, count / 1024 + 1));
+
+    // Непрерывные диапазоны вершин; нулевой играет вызывающий поток
+    std::vector<std::thread> pool;
+    for (uint32_t w = 1; w < workers; ++w) {
+        uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(count) * w / workers);
+        uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(count) * (w + 1) / workers);
+        pool.emplace_back([&body, begin, end]() { body(begin, end); });
+    }
+    body(0, static_cast<uint32_t>(static_cast<uint64_t>(count) / workers));
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+void SpatialGame::computeScores(uint32_t begin, uint32_t end, std::vector<uint32_t>& counts) {
+    const size_t n = strategyCount;
+    for (uint32_t agent = begin; agent < end; ++agent) {
+        const size_t self = strategies[agent];
+        const uint32_t* first = graph.begin(agent);
+        const uint32_t* last = graph.end(agent);
+        const uint64_t degree = last - first;
+        double total = 0.0;
+
+        if (degree < 2) {
+            // Без пары соседей агент не играет
+        } else if (degree * (degree - 1) / 2 <= n * n + degree) {
+            // Мало соседей - перебор пар
+            for (const uint32_t* a = first; a != last; ++a) {
+                for (const uint32_t* b = a + 1; b != last; ++b) {
+                    total += payoff(self, strategies[*a], strategies[*b]);
+                }
+            }
+        } else {
+            // Много соседей - по числу соседей каждой стратегии:
+            // sum_{a<b} = (sum_tu c_t c_u A[s][t][u] - sum_t c_t A[s][t][t]) / 2
+            std::fill(counts.begin(), counts.end(), 0);
+            for (const uint32_t* a = first; a != last; ++a) {
+                counts[strategies[*a]]++;
+            }
+            const double* block = &tensor[self * n * n];
+            for (size_t t = 0; t < n; ++t) {
+                if (!counts[t]) continue;
+                double row = 0.0;
+                for (size_t u = 0; u < n; ++u) {
+                    row += static_cast<double>(counts[u]) * block[t * n + u];
+                }
+                total += counts[t] * (row - selfPairs[self * n + t]);
+            }
+            total *= 0.5;
+        }
+        scores[agent] = total;
+    }
+}
+
+void SpatialGame::imitate(uint32_t begin, uint32_t end) {
+    for (uint32_t agent = begin; agent < end; ++agent) {
+        // При равенстве очков агент сохраняет свою стратегию
+        uint32_t best = agent;
+        for (const uint32_t* it = graph.begin(agent); it != graph.end(agent); ++it) {
+            if (scores[*it] > scores[best]) best = *it;
+        }
+        nextStrategies[agent] = strategies[best];
+    }
+}
+
+void SpatialGame::computeScores() {
+    parallelFor([this](uint32_t begin, uint32_t end) {
+        std::vector<uint32_t> counts(strategyCount, 0);
+        computeScores(begin, end, counts);
+    });
+}
+
+void SpatialGame::step() {
+    computeScores();
+    parallelFor([this](uint32_t begin, uint32_t end) {
+        imitate(begin, end);
+    });
+    strategies.swap(nextStrategies);
+    ++generation;
+}
+
+std::vector<uint64_t> SpatialGame::countStrategies() const {
+    std::vector<uint64_t> counts(strategyCount, 0);
+    for (StrategyId strategy : strategies) {
+        counts[strategy]++;
+    }
+    return counts;
+}
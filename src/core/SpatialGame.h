@@ -0,0 +1,60 @@
+#ifndef SPATIALGAME_H
+#define SPATIALGAME_H
+
+#include <cstdint>
+#include <vector>
+#include "core/NeighborGraph.h"
+
+// Популяция агентов на графе соседства (решётка или список рёбер).
+// Каждый агент играет тройками с каждой парой своих соседей; выигрыш
+// тройки берётся из тензора Tournament::computePayoffTensor, поэтому
+// поколение не симулирует раунды. Затем все агенты одновременно
+// перенимают стратегию лучшего по очкам из себя и соседей.
+//
+// Агенты хранятся структурой массивов, стратегии - в двух буферах
+// (текущее и следующее поколение); обе фазы шага делятся между потоками
+// по диапазонам вершин и не требуют блокировок.
+class SpatialGame {
+public:
+    using StrategyId = uint16_t;
+
+private:
+    const NeighborGraph& graph;
+    size_t strategyCount;
+    std::vector<double> tensor;       // [(i * n + j) * n + k], симметричен по j, k
+    std::vector<double> selfPairs;    // [i * n + j] = A[i][j][j]
+    std::vector<StrategyId> strategies;
+    std::vector<StrategyId> nextStrategies;
+    std::vector<double> scores;
+    int threads;
+    int generation;
+
+    double payoff(size_t self, size_t first, size_t second) const {
+        return tensor[(self * strategyCount + first) * strategyCount + second];
+    }
+    void computeScores(uint32_t begin, uint32_t end, std::vector<uint32_t>& counts);
+    void imitate(uint32_t begin, uint32_t end);
+    template <typename Body>
+    void parallelFor(Body body);
+
+public:
+    SpatialGame(const NeighborGraph& graph, size_t strategyCount, std::vector<double> tensor);
+
+    // Случайная равномерная расстановка стратегий
+    void seedUniform(uint64_t seed);
+    void setStrategies(const std::vector<StrategyId>& initial);
+    void setThreads(int count);
+
+    // Очки текущего поколения и переход к следующему
+    void step();
+    void computeScores();
+
+    const std::vector<StrategyId>& getStrategies() const { return strategies; }
+    // Сумма выигрышей агента по всем парам соседей: после step() -
+    // очки поколения, по которым прошло подражание
+    const std::vector<double>& getScores() const { return scores; }
+    std::vector<uint64_t> countStrategies() const;
+    int getGeneration() const { return generation; }
+};
+
+#endif
@@ -0,0 +1,52 @@
+#include "core/Strategy.h"
+#include <stdexcept>
+
+namespace {
+    // Стратегия, для которой сейчас работает адаптер базового класса.
+    // Повторный вход в адаптер для неё же значит, что наследник не
+    // переопределил ни одну из версий makeMove.
+    thread_local const Strategy* adapting = nullptr;
+
+    class AdapterGuard {
+    private:
+        const Strategy* previous;
+
+    public:
+        explicit AdapterGuard(const Strategy* strategy) : previous(adapting) {
+            if (adapting == strategy) {
+                throw std::logic_error("Strategy " + strategy->getName() + " overrides neither makeMove");
+            }
+            adapting = strategy;
+        }
+        ~AdapterGuard() { adapting = previous; }
+    };
+}
+
+// Адаптер для стратегий, реализующих только версию с векторами:
+// копирует историю, как это делал движок раньше
+Move Strategy::makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) {
+    AdapterGuard guard(this);
+    std::vector<std::vector<Move>> opponents;
+    opponents.reserve(opponentsHistory.size());
+    for (const auto& history : opponentsHistory) {
+        opponents.push_back(history.toVector());
+    }
+    return makeMove(ownHistory.toVector(), opponents);
+}
+
+// Обратный адаптер: векторы упаковываются во временные истории
+Move Strategy::makeMove(const std::vector<Move>& ownHistory,
+                        const std::vector<std::vector<Move>>& opponentsHistory) {
+    AdapterGuard guard(this);
+    PackedHistory own;
+    for (Move move : ownHistory) own.push_back(move);
+    
+    std::vector<PackedHistory> packed(opponentsHistory.size());
+    std::vector<HistoryView> opponents;
+    opponents.reserve(opponentsHistory.size());
+    for (size_t i = 0; i < opponentsHistory.size(); ++i) {
+        for (Move move : opponentsHistory[i]) packed[i].push_back(move);
+        opponents.emplace_back(packed[i]);
+    }
+    return makeMove(HistoryView(own), OpponentsView(opponents));
+}
@@ -1,38 +1,97 @@
 #ifndef STRATEGY_H
 #define STRATEGY_H
 
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
 #include <functional>
+#include "core/Move.h"
+#include "core/HistoryView.h"
+#include "core/OpponentStats.h"
+#include "core/RandomStream.h"
 
-enum class Move {
-    COOPERATE,
-    DEFECT
+// Стратегия с памятью в один раунд: вероятность сотрудничества в первом
+// раунде и после каждого исхода прошлого раунда. Исход считается со своей
+// точки зрения: свой ход << 2 | соперник1 << 1 | соперник2 (D = 1).
+struct MemoryOneResponse {
+    double initial = 1.0;
+    double afterOutcome[8] = {};
 };
 
-inline char moveToChar(Move move) {
-    return (move == Move::COOPERATE) ? 'C' : 'D';
-}
-
-inline Move charToMove(char c) {
-    return (c == 'C' || c == 'c') ? Move::COOPERATE : Move::DEFECT;
-}
-
-// Базовый абстрактный класс стратегии
+// Базовый абстрактный класс стратегии.
+// Наследник переопределяет хотя бы одну из версий makeMove:
+// версия с представлениями не копирует историю и используется движком,
+// версия с векторами оставлена для совместимости со старыми стратегиями.
+// Версии по умолчанию вызывают друг друга; если наследник не переопределил
+// ни одну, makeMove бросает std::logic_error вместо бесконечной рекурсии.
 class Strategy {
 public:
     virtual ~Strategy() = default;
     
+    virtual Move makeMove(HistoryView ownHistory, OpponentsView opponentsHistory);
+    
     virtual Move makeMove(
         const std::vector<Move>& ownHistory,
         const std::vector<std::vector<Move>>& opponentsHistory
-    ) = 0;
+    );
     
     virtual std::string getName() const = 0;
     
+    // Копия с той же конфигурацией. Фабрика разбирает конфигурацию один
+    // раз в прототип и выдаёт игрокам его копии; nullptr - копирование
+    // не поддерживается, и стратегия каждый раз создаётся заново.
+    virtual std::unique_ptr<Strategy> clone() const { return nullptr; }
+    
+    // Сброс состояния к началу игры; конфигурация не меняется
+    virtual void reset() {}
+    
+    // Строка, однозначно задающая разобранную конфигурацию (имя и все
+    // параметры); входит в ключ кэша результатов игр
+    virtual std::string getConfigSignature() const { return getName(); }
+    
     // Виртуальный метод для загрузки конфигурации
     virtual void loadConfig(const std::string& configDir) {
     }
+    
+    // Результат раунда: ходы и очки в порядке "свой, затем оппоненты"
+    // (как в OpponentsView), round - номер раунда с нуля. Вызывает только
+    // движок (вместе с attachOpponentStats); при прямых вызовах makeMove
+    // стратегия должна брать всё нужное из истории.
+    virtual void onRoundResult(const std::vector<Move>& moves,
+                               const std::vector<int>& payoffs,
+                               int round) {
+    }
+    
+    // Размер скользящего окна статистики оппонентов, которую ведёт движок
+    virtual size_t getStatsWindowSize() const { return 10; }
+    
+    // Сигнатура внутреннего состояния для обнаружения циклов в Game.
+    // Следующий ход должен однозначно определяться сигнатурой и ходами
+    // всех игроков в последнем раунде; более глубокую историю стратегия
+    // учитывает в сигнатуре сама. false - стратегия недетерминирована
+    // или её состояние не ограничено.
+    virtual bool getStateSignature(uint64_t& signature) const { return false; }
+    
+    // Описание для аналитического режима (MarkovGame);
+    // false - ход зависит не только от последнего раунда
+    virtual bool getMemoryOneResponse(MemoryOneResponse& response) const { return false; }
+    
+    void attachOpponentStats(const OpponentStats* stats) { opponentStats = stats; }
+    
+    // Поток случайных чисел места в игре; его выдаёт движок, чтобы
+    // игры с одним --seed повторялись при любом числе потоков
+    void attachRandom(RandomStream* stream) { randomStream = stream; }
+    
+protected:
+    // Статистика оппонентов от движка; nullptr, если стратегия вызывается напрямую
+    const OpponentStats* opponentStats = nullptr;
+    RandomStream* randomStream = nullptr;
+    
+    // Поток от движка, а без него - поток текущего потока с зерном от часов
+    RandomStream& random() const {
+        return randomStream ? *randomStream : RandomStream::threadFallback();
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -5,6 +5,7 @@
 #include "strategies/advanced/FiftyFifty.h"
 #include "strategies/advanced/TitForTat.h"
 #include "strategies/advanced/AdaptiveStrategy.h"
+#include "strategies/advanced/TableStrategy.h"
 #include <algorithm>
 #include <iostream>
 #include <cctype>
@@ -18,43 +19,52 @@ StrategyFactory& StrategyFactory::getInstance() {
     return instance;
 }
 
-void StrategyFactory::registerStrategy(const std::string& name, std::function<std::unique_ptr<Strategy>()> creator) {
-    std::string lowerName = name;
-    std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
-    
-    creators[lowerName] = creator;
+std::vector<std::string> StrategyFactory::namesFor(const std::string& lowerName) {
+    std::vector<std::string> names = { lowerName };
     
-    // Регистрируем альтернативные имена
+    // Альтернативные имена
     if (lowerName == "random") {
-        creators["rand"] = creator;
-        creators["rnd"] = creator;
+        names.insert(names.end(), { "rand", "rnd" });
     }
     else if (lowerName == "alwayscooperate") {
-        creators["always_cooperate"] = creator;
-        creators["cooperate"] = creator;
-        creators["coop"] = creator;
-        creators["ac"] = creator;
+        names.insert(names.end(), { "always_cooperate", "cooperate", "coop", "ac" });
     }
     else if (lowerName == "alwaysdefect") {
-        creators["always_defect"] = creator;
-        creators["defect"] = creator;
-        creators["def"] = creator;
-        creators["ad"] = creator;
+        names.insert(names.end(), { "always_defect", "defect", "def", "ad" });
     }
     else if (lowerName == "fiftyfifty") {
-        creators["fifty_fifty"] = creator;
-        creators["5050"] = creator;
-        creators["ff"] = creator;
+        names.insert(names.end(), { "fifty_fifty", "5050", "ff" });
     }
     else if (lowerName == "titfortat") {
-        creators["tit_for_tat"] = creator;
-        creators["tft"] = creator;
-        creators["toothfortooth"] = creator;
+        names.insert(names.end(), { "tit_for_tat", "tft", "toothfortooth" });
     }
     else if (lowerName == "adaptive") {
-        creators["adaptive_strategy"] = creator;
-        creators["adapt"] = creator;
-        creators["adaptive"] = creator;
+        names.insert(names.end(), { "adaptive_strategy", "adapt" });
+    }
+    return names;
+}
+
+void StrategyFactory::registerStrategy(const std::string& name, std::function<std::unique_ptr<Strategy>()> creator) {
+    std::string lowerName = name;
+    std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
+    
+    // Регистрируем основное и альтернативные имена.
+    // Перерегистрированное имя уходит с быстрого пути на виртуальный.
+    for (const auto& alias : namesFor(lowerName)) {
+        creators[alias] = creator;
+        slotCreators.erase(alias);
+    }
+    clearPrototypes();
+}
+
+template <typename T>
+void StrategyFactory::registerBuiltin(const std::string& name) {
+    registerStrategy(name, []() -> std::unique_ptr<Strategy> {
+        return std::make_unique<T>();
+    });
+    
+    for (const auto& alias : namesFor(name)) {
+        slotCreators[alias] = []() { return StrategySlot(T()); };
     }
 }
 
@@ -62,6 +72,22 @@ std::unique_ptr<Strategy> StrategyFactory::create(const std::string& name, const
     std::string lowerName = name;
     std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
     
+    // Прототипы заводит createSlot; здесь они только переиспользуются,
+    // чтобы встроенные стратегии в кэше оставались на быстром пути
+    auto prototype = findPrototype(name, lowerName, configDir, false);
+    if (prototype) {
+        auto copy = (*prototype)->clone();
+        if (copy) {
+            copy->reset();
+            return copy;
+        }
+    }
+    
+    return buildStrategy(name, lowerName, configDir);
+}
+
+std::unique_ptr<Strategy> StrategyFactory::buildStrategy(const std::string& name, const std::string& lowerName,
+                                                         const std::string& configDir) const {
     auto it = creators.find(lowerName);
     if (it != creators.end()) {
         auto strategy = it->second();
@@ -73,6 +99,16 @@ std::unique_ptr<Strategy> StrategyFactory::create(const std::string& name, const
         return strategy;
     }
     
+    // Табличная стратегия из <configDir>/<name>.cfg
+    ConfigFileParser config;
+    if (config.loadFromDir(configDir, lowerName) && TableStrategy::isTableConfig(config)) {
+        auto strategy = std::make_unique<TableStrategy>();
+        if (strategy->loadFromConfig(config, lowerName)) {
+            return strategy;
+        }
+        return nullptr;
+    }
+    
     std::cerr << "Error: Unknown strategy '" << name << "'" << std::endl;
     std::cerr << "Available strategies: ";
     auto strategies = getAvailableStrategies();
@@ -85,6 +121,88 @@ std::unique_ptr<Strategy> StrategyFactory::create(const std::string& name, const
     return nullptr;
 }
 
+StrategySlot StrategyFactory::createSlot(const std::string& name, const std::string& configDir) const {
+    std::string lowerName = name;
+    std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
+    
+    auto prototype = findPrototype(name, lowerName, configDir, true);
+    if (!prototype) return StrategySlot(std::unique_ptr<Strategy>());
+    
+    StrategySlot copy = prototype->clone();
+    if (copy) return copy;
+    
+    // Стратегия без clone() каждый раз создаётся заново
+    return buildSlot(name, lowerName, configDir);
+}
+
+std::shared_ptr<const StrategySlot> StrategyFactory::findPrototype(const std::string& name,
+                                                                   const std::string& lowerName,
+                                                                   const std::string& configDir,
+                                                                   bool add) const {
+    auto key = std::make_pair(lowerName, configDir);
+    std::shared_ptr<Prototype> entry;
+    {
+        std::lock_guard<std::mutex> lock(prototypesMutex);
+        auto it = prototypes.find(key);
+        if (it != prototypes.end()) {
+            entry = it->second;
+        } else if (add) {
+            entry = std::make_shared<Prototype>();
+            prototypes.emplace(key, entry);
+        } else {
+            return nullptr;
+        }
+    }
+    
+    // Конфигурация читается без мьютекса; остальные потоки с тем же
+    // ключом ждут здесь же
+    std::call_once(entry->built, [&]() {
+        entry->slot = std::make_shared<const StrategySlot>(buildSlot(name, lowerName, configDir));
+    });
+    if (*entry->slot) return entry->slot;
+    
+    // Неудача не запоминается: следующий вызов попробует снова
+    std::lock_guard<std::mutex> lock(prototypesMutex);
+    auto it = prototypes.find(key);
+    if (it != prototypes.end() && it->second == entry) {
+        prototypes.erase(it);
+    }
+    return nullptr;
+}
+
+StrategySlot StrategyFactory::buildSlot(const std::string& name, const std::string& lowerName,
+                                        const std::string& configDir) const {
+    // Встроенные стратегии - по значению, без виртуальных вызовов
+    auto it = slotCreators.find(lowerName);
+    if (it != slotCreators.end()) {
+        StrategySlot slot = it->second();
+        
+        if (!configDir.empty()) {
+            slot->loadConfig(configDir);
+        }
+        
+        return slot;
+    }
+    
+    // Табличные стратегии тоже хранятся по значению
+    ConfigFileParser config;
+    if (creators.find(lowerName) == creators.end() &&
+        config.loadFromDir(configDir, lowerName) && TableStrategy::isTableConfig(config)) {
+        TableStrategy strategy;
+        if (strategy.loadFromConfig(config, lowerName)) {
+            return StrategySlot(std::move(strategy));
+        }
+        return StrategySlot(std::unique_ptr<Strategy>());
+    }
+    
+    return StrategySlot(buildStrategy(name, lowerName, configDir));
+}
+
+void StrategyFactory::clearPrototypes() {
+    std::lock_guard<std::mutex> lock(prototypesMutex);
+    prototypes.clear();
+}
+
 bool StrategyFactory::exists(const std::string& name) const {
     std::string lowerName = name;
     std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
@@ -123,28 +241,12 @@ std::vector<std::string> StrategyFactory::getAvailableStrategies() const {
 
 void StrategyFactory::registerAllStrategies() {
     // Базовые стратегии
-    registerStrategy("random", []() -> std::unique_ptr<Strategy> {
-        return std::make_unique<RandomStrategy>();
-    });
-    
-    registerStrategy("alwayscooperate", []() -> std::unique_ptr<Strategy> {
-        return std::make_unique<AlwaysCooperate>();
-    });
-    
-    registerStrategy("alwaysdefect", []() -> std::unique_ptr<Strategy> {
-        return std::make_unique<AlwaysDefect>();
-    });
-    
-    registerStrategy("fiftyfifty", []() -> std::unique_ptr<Strategy> {
-        return std::make_unique<FiftyFifty>();
-    });
+    registerBuiltin<RandomStrategy>("random");
+    registerBuiltin<AlwaysCooperate>("alwayscooperate");
+    registerBuiltin<AlwaysDefect>("alwaysdefect");
+    registerBuiltin<FiftyFifty>("fiftyfifty");
     
     // Сложные стратегии
-    registerStrategy("titfortat", []() -> std::unique_ptr<Strategy> {
-        return std::make_unique<TitForTat>();
-    });
-    
-    registerStrategy("adaptive", []() -> std::unique_ptr<Strategy> {
-        return std::make_unique<AdaptiveStrategy>();
-    });
+    registerBuiltin<TitForTat>("titfortat");
+    registerBuiltin<AdaptiveStrategy>("adaptive");
 }
\ No newline at end of file
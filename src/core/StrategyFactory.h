@@ -4,20 +4,53 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <mutex>
+#include <utility>
 #include <functional>
+#include <vector>
 #include "core/Strategy.h"
+#include "core/StrategySlot.h"
 
 class StrategyFactory {
 private:
     std::map<std::string, std::function<std::unique_ptr<Strategy>()>> creators;
+    std::map<std::string, std::function<StrategySlot()>> slotCreators;
+    // Разобранный прототип: строится один раз (call_once) вне мьютекса
+    // карты, дальше только копируется
+    struct Prototype {
+        std::once_flag built;
+        std::shared_ptr<const StrategySlot> slot;
+    };
+    // Прототипы по (имя, каталог конфигураций): конфигурация читается
+    // с диска один раз, игроки получают копии. Мьютекс держится только
+    // на поиск и вставку в карту.
+    mutable std::map<std::pair<std::string, std::string>, std::shared_ptr<Prototype>> prototypes;
+    mutable std::mutex prototypesMutex;
     StrategyFactory();
     StrategyFactory(const StrategyFactory&) = delete;
     StrategyFactory& operator=(const StrategyFactory&) = delete;
+    
+    static std::vector<std::string> namesFor(const std::string& lowerName);
+    template <typename T>
+    void registerBuiltin(const std::string& name);
+    // Создание с чтением конфигурации, без прототипов
+    std::unique_ptr<Strategy> buildStrategy(const std::string& name, const std::string& lowerName,
+                                            const std::string& configDir) const;
+    StrategySlot buildSlot(const std::string& name, const std::string& lowerName,
+                           const std::string& configDir) const;
+    // Готовый прототип; nullptr, если его нет, а add == false, или
+    // стратегию не удалось создать
+    std::shared_ptr<const StrategySlot> findPrototype(const std::string& name, const std::string& lowerName,
+                                                      const std::string& configDir, bool add) const;
 public:
     static StrategyFactory& getInstance();
 
     void registerStrategy(const std::string& neme, std::function<std::unique_ptr<Strategy>()> creator);
     std::unique_ptr<Strategy> create(const std::string& name, const std::string& configDir = "") const;
+    // Быстрый путь для встроенных стратегий, виртуальный - для остальных
+    StrategySlot createSlot(const std::string& name, const std::string& configDir = "") const;
+    // Забыть прототипы (например, после изменения файлов конфигурации)
+    void clearPrototypes();
     bool exists(const std::string& name) const;
     std::vector<std::string> getAvailableStrategies() const;
     void registerAllStrategies();
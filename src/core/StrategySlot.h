@@ -0,0 +1,96 @@
+#ifndef STRATEGYSLOT_H
+#define STRATEGYSLOT_H
+
+#include <memory>
+#include <type_traits>
+#include <variant>
+#include "core/Strategy.h"
+#include "strategies/basic/AlwaysCooperate.h"
+#include "strategies/basic/AlwaysDefect.h"
+#include "strategies/basic/Random.h"
+#include "strategies/advanced/FiftyFifty.h"
+#include "strategies/advanced/TitForTat.h"
+#include "strategies/advanced/AdaptiveStrategy.h"
+#include "strategies/advanced/TableStrategy.h"
+
+// Место игрока в движке. Встроенные стратегии хранятся по значению
+// в std::variant, и makeMove вызывается напрямую (без виртуального
+// вызова), что позволяет компилятору встраивать их в цикл раунда.
+// Остальные стратегии идут по обычному виртуальному пути.
+class StrategySlot {
+public:
+    using Storage = std::variant<
+        std::unique_ptr<Strategy>,
+        AlwaysCooperate,
+        AlwaysDefect,
+        RandomStrategy,
+        FiftyFifty,
+        TitForTat,
+        AdaptiveStrategy,
+        TableStrategy
+    >;
+
+private:
+    Storage impl;
+    
+    template <typename T>
+    static constexpr bool isBuiltin =
+        std::is_base_of<Strategy, T>::value && std::is_constructible<Storage, T>::value;
+
+public:
+    StrategySlot(std::unique_ptr<Strategy> strategy) : impl(std::move(strategy)) {}
+    
+    template <typename T, typename = std::enable_if_t<isBuiltin<std::decay_t<T>>>>
+    explicit StrategySlot(T&& builtin) : impl(std::forward<T>(builtin)) {}
+    
+    Move makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) {
+        return std::visit([&](auto& strategy) -> Move {
+            using T = std::decay_t<decltype(strategy)>;
+            if constexpr (std::is_same<T, std::unique_ptr<Strategy>>::value) {
+                return strategy->makeMove(ownHistory, opponentsHistory);
+            } else {
+                // Квалифицированный вызов - без виртуальной диспетчеризации
+                return strategy.T::makeMove(ownHistory, opponentsHistory);
+            }
+        }, impl);
+    }
+    
+    Strategy* get() {
+        return std::visit([](auto& strategy) -> Strategy* {
+            using T = std::decay_t<decltype(strategy)>;
+            if constexpr (std::is_same<T, std::unique_ptr<Strategy>>::value) {
+                return strategy.get();
+            } else {
+                return &strategy;
+            }
+        }, impl);
+    }
+    const Strategy* get() const { return const_cast<StrategySlot*>(this)->get(); }
+    
+    Strategy* operator->() { return get(); }
+    const Strategy* operator->() const { return get(); }
+    explicit operator bool() const { return get() != nullptr; }
+    
+    // Копия для нового игрока со сброшенным состоянием: встроенные
+    // копируются по значению, остальные - через Strategy::clone.
+    // Пустой слот, если стратегия не поддерживает копирование.
+    StrategySlot clone() const {
+        return std::visit([](const auto& strategy) -> StrategySlot {
+            using T = std::decay_t<decltype(strategy)>;
+            if constexpr (std::is_same<T, std::unique_ptr<Strategy>>::value) {
+                std::unique_ptr<Strategy> copy = strategy ? strategy->clone() : nullptr;
+                if (copy) copy->reset();
+                return StrategySlot(std::move(copy));
+            } else {
+                T copy(strategy);
+                copy.T::reset();
+                return StrategySlot(std::move(copy));
+            }
+        }, impl);
+    }
+    
+    // true, если стратегия встроена в variant (быстрый путь)
+    bool isDevirtualized() const { return impl.index() != 0; }
+};
+
+#endif
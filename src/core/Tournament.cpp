@@ -1,8 +1,52 @@
 #include "Tournament.h"
 #include "StrategyFactory.h"
+#include "MarkovGame.h"
+#include "Combinations.h"
+#include "Checkpoint.h"
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <exception>
 #include <iostream>
 #include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+std::atomic<bool> Tournament::stopRequested(false);
+
+namespace {
+    // work(w) в count потоках, нулевой - в текущем; ждёт все потоки.
+    // Исключение не выходит из потока: первое сохраняется, failed
+    // просит остальных остановиться, и оно возвращается после join
+    template <typename Work>
+    std::exception_ptr runPool(size_t count, std::atomic<bool>& failed, Work work) {
+        std::exception_ptr failure;
+        std::mutex failureMutex;
+        auto guarded = [&](size_t w) {
+            try {
+                work(w);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) failure = std::current_exception();
+                failed = true;
+            }
+        };
+        
+        std::vector<std::thread> pool;
+        for (size_t w = 1; w < count; ++w) {
+            pool.emplace_back(guarded, w);
+        }
+        guarded(0);
+        for (auto& thread : pool) {
+            thread.join();
+        }
+        return failure;
+    }
+}
 
 Tournament::Tournament(const std::vector<std::string>& strategies, 
                        int rounds, 
@@ -11,100 +55,745 @@ Tournament::Tournament(const std::vector<std::string>& strategies,
     : strategyNames(strategies), 
       configDir(configDir), 
       matrixFile(matrixFile), 
-      roundsPerGame(rounds) {
+      roundsPerGame(rounds),
+      replicas(1),
+      groupSize(3),
+      analytic(false),
+      seed(0),
+      threads(1),
+      shardIndex(0),
+      shardCount(1),
+      checkpointInterval(60),
+      resume(false),
+      interrupted(false),
+      settingsHash(ResultCache::FNV_OFFSET),
+      matrixHash(0),
+      cacheHits(0),
+      cachePlayed(0) {
     
-    for (const auto& name : strategyNames) {
-        totalScores[name] = 0;
-    }
+    // Порядок мест в группе задаётся алфавитным порядком имён
+    std::sort(strategyNames.begin(), strategyNames.end());
+    strategyNames.erase(std::unique(strategyNames.begin(), strategyNames.end()), strategyNames.end());
+    displayNames = strategyNames;
+    scoresById.assign(strategyNames.size(), 0);
 }
 
 void Tournament::run() {
-    auto triplets = generateTriplets();
+    Combinations groups(static_cast<uint32_t>(strategyNames.size()), groupSize);
+    uint64_t groupCount = groups.size();
     
     std::cout << "Starting tournament with " << strategyNames.size() 
               << " strategies" << std::endl;
-    std::cout << "Number of unique triplets: " << triplets.size() << std::endl;
+    if (groupSize == 3) {
+        std::cout << "Number of unique triplets: " << groupCount << std::endl;
+    } else {
+        std::cout << "Number of unique groups of " << groupSize << ": " << groupCount << std::endl;
+    }
+    uint64_t rangeBegin = 0;
+    uint64_t rangeEnd = groupCount;
+    getShardRange(rangeBegin, rangeEnd);
+    if (shardCount > 1) {
+        std::cout << "Shard " << shardIndex << "/" << shardCount << ": groups "
+                  << rangeBegin + 1 << ".." << rangeEnd << std::endl;
+    }
     std::cout << "Rounds per game: " << roundsPerGame << std::endl;
+    if (replicas > 1) {
+        std::cout << "Replicas per triplet: " << replicas << std::endl;
+    }
+    if (analytic) {
+        std::cout << "Scoring: analytic (expected values)" << std::endl;
+    }
+    std::cout << "Seed: " << seed << std::endl;
     
-    int gameCount = 1;
-    for (const auto& triplet : triplets) {
-        std::cout << "\nGame " << gameCount++ << "/" << triplets.size() 
-                  << ": " << triplet[0] << " vs " << triplet[1] << " vs " << triplet[2] << std::endl;
-        
-        playTriplet(triplet);
+    prepareGames(groupSize != 3 ? matrixFile : "");
+    
+    uint64_t rangeSize = rangeEnd - rangeBegin;
+    size_t workerCount = static_cast<size_t>(std::max<uint64_t>(1, std::min<uint64_t>(threads, rangeSize)));
+    if (workerCount > 1) {
+        std::cout << "Threads: " << workerCount << std::endl;
+    }
+    
+    // Потоки берут диапазоны рангов из общего счётчика и восстанавливают
+    // группы через unrank. Очки копятся в таблице своего потока, отчёт
+    // блока - в его буфере; буферы печатаются строго по порядку блоков.
+    uint64_t chunkSize = std::min<uint64_t>(4096, std::max<uint64_t>(1, rangeSize / (workerCount * 16)));
+    size_t chunkCount = static_cast<size_t>((rangeSize + chunkSize - 1) / chunkSize);
+    std::vector<char> chunkDone(chunkCount, 0);
+    // Очки блоков из контрольной точки; свои блоки потоки пропускают
+    std::vector<long long> baseScores(strategyNames.size(), 0);
+    interrupted = false;
+    
+    if (resume && !checkpointFile.empty()) {
+        Checkpoint checkpoint;
+        PartialResults expected = getPartialResults();
+        if (!checkpoint.load(checkpointFile)) {
+            std::cout << "No checkpoint at " << checkpointFile << ", starting from scratch" << std::endl;
+        } else if (!checkpoint.results.isCompatible(expected) ||
+                   checkpoint.results.begin != rangeBegin || checkpoint.results.end != rangeEnd ||
+                   checkpoint.done.size() != static_cast<size_t>((rangeSize + checkpoint.chunkSize - 1) / checkpoint.chunkSize)) {
+            std::cerr << "Warning: Checkpoint " << checkpointFile
+                      << " belongs to a different tournament, starting from scratch" << std::endl;
+        } else {
+            chunkSize = checkpoint.chunkSize;
+            chunkCount = checkpoint.done.size();
+            chunkDone = checkpoint.done;
+            baseScores = checkpoint.results.scores;
+            std::cout << "Resuming from " << checkpointFile << ": " << checkpoint.completedChunks()
+                      << "/" << chunkCount << " blocks done" << std::endl;
+        }
+    }
+    
+    // При продолжении в выводах остаются только игры завершённых блоков
+    TraceWriter::KeepGame keep;
+    if (resume) {
+        keep = [&](const std::vector<uint32_t>& ids) {
+            if (ids.size() != static_cast<size_t>(groupSize)) return false;
+            std::vector<uint32_t> group(ids);
+            std::sort(group.begin(), group.end());
+            if (std::adjacent_find(group.begin(), group.end()) != group.end() ||
+                group.back() >= strategyNames.size()) {
+                return false;
+            }
+            uint64_t rank = groups.rank(group);
+            return rank >= rangeBegin && rank < rangeEnd && chunkDone[(rank - rangeBegin) / chunkSize] != 0;
+        };
     }
+    openOutputs(keep);
+    
+    std::atomic<size_t> nextChunk(0);
+    std::vector<std::vector<long long>> workerScores(workerCount, std::vector<long long>(strategyNames.size(), 0));
+    std::vector<std::string> chunkReports(chunkCount);
+    size_t nextToPrint = 0;
+    std::mutex outputMutex;
+    
+    // Сумма очков завершённых блоков (вызывать под outputMutex)
+    auto completedScores = [&]() {
+        std::vector<long long> scores = baseScores;
+        for (const auto& local : workerScores) {
+            for (size_t id = 0; id < local.size(); ++id) {
+                scores[id] += local[id];
+            }
+        }
+        return scores;
+    };
+    auto lastCheckpoint = std::chrono::steady_clock::now();
+    std::atomic<bool> failed(false);
+    
+    auto worker = [&](size_t w) {
+        std::vector<uint32_t> group;
+        // Очки текущего блока попадают в workerScores только целиком,
+        // чтобы контрольная точка не содержала половины блока
+        std::vector<long long> chunkScores(strategyNames.size(), 0);
+        for (;;) {
+            if (stopRequested.load() || failed.load()) break;
+            size_t chunk = nextChunk.fetch_add(1);
+            if (chunk >= chunkCount) break;
+            // Отметки из контрольной точки выставлены до запуска потоков
+            if (chunkDone[chunk]) continue;
+            
+            std::ostringstream out;
+            uint64_t begin = rangeBegin + chunk * chunkSize;
+            uint64_t end = std::min(rangeEnd, begin + chunkSize);
+            groups.unrank(begin, group);
+            for (uint64_t rank = begin; rank < end; ++rank) {
+                out << "\nGame " << rank + 1 << "/" << groupCount << ": ";
+                for (size_t i = 0; i < group.size(); ++i) {
+                    out << strategyNames[group[i]];
+                    if (i < group.size() - 1) out << " vs ";
+                }
+                out << "\n";
+                
+                playTriplet(group, chunkScores, out);
+                groups.next(group);
+            }
+            
+            std::lock_guard<std::mutex> lock(outputMutex);
+            for (size_t id = 0; id < chunkScores.size(); ++id) {
+                workerScores[w][id] += chunkScores[id];
+                chunkScores[id] = 0;
+            }
+            chunkReports[chunk] = out.str();
+            chunkDone[chunk] = 1;
+            while (nextToPrint < chunkCount && chunkDone[nextToPrint]) {
+                std::cout << chunkReports[nextToPrint] << std::flush;
+                std::string().swap(chunkReports[nextToPrint]);
+                ++nextToPrint;
+            }
+            
+            if (!checkpointFile.empty() && checkpointInterval > 0) {
+                auto now = std::chrono::steady_clock::now();
+                if (now - lastCheckpoint >= std::chrono::seconds(checkpointInterval)) {
+                    saveCheckpoint(chunkSize, chunkDone, completedScores());
+                    lastCheckpoint = now;
+                }
+            }
+        }
+    };
+    
+    std::exception_ptr failure = runPool(workerCount, failed, worker);
+    if (trace) {
+        trace->close();
+    }
+    if (results) {
+        results->close();
+    }
+    if (failure) {
+        // Завершённые блоки не пропадут: --resume продолжит с них
+        if (!checkpointFile.empty()) {
+            saveCheckpoint(chunkSize, chunkDone, completedScores());
+        }
+        std::rethrow_exception(failure);
+    }
+    
+    // Целочисленное слияние по порядку потоков - итог не зависит от расписания
+    std::vector<long long> completed = completedScores();
+    for (size_t id = 0; id < completed.size(); ++id) {
+        scoresById[id] += completed[id];
+    }
+    
+    bool finished = std::find(chunkDone.begin(), chunkDone.end(), 0) == chunkDone.end();
+    if (!finished) {
+        interrupted = true;
+        if (!checkpointFile.empty()) {
+            saveCheckpoint(chunkSize, chunkDone, completed);
+        }
+    } else if (!checkpointFile.empty()) {
+        std::remove(checkpointFile.c_str());
+    }
+    if (cache) {
+        std::cout << "\nResult cache: " << cacheHits.load() << " games reused, "
+                  << cachePlayed.load() << " played (" << cacheFile << ")" << std::endl;
+    }
+    buildScoreBoard();
 }
 
-std::vector<std::vector<std::string>> Tournament::generateTriplets() const {
-    std::vector<std::vector<std::string>> triplets;
-    
-    // Генерируем все уникальные комбинации из 3 стратегий
+std::vector<double> Tournament::computePayoffTensor() {
     size_t n = strategyNames.size();
-    if (n < 3) return triplets;
+    std::vector<double> tensor(n * n * n, 0.0);
+    if (groupSize != 3 || n == 0) return tensor;
     
-    std::vector<int> indices(n);
-    for (size_t i = 0; i < n; ++i) indices[i] = i;
+    // Тройка с повторениями i <= j <= k - это сочетание (i, j+1, k+2) из n+2
+    Combinations multisets(static_cast<uint32_t>(n + 2), 3);
+    uint64_t gameCount = multisets.size();
+    std::cout << "Computing payoff tensor: " << gameCount << " games of "
+              << roundsPerGame << " rounds" << std::endl;
     
-    do {
-        std::vector<std::string> triplet = {
-            strategyNames[indices[0]],
-            strategyNames[indices[1]],
-            strategyNames[indices[2]]
-        };
-        
-        // Сортируем для уникальности (порядок не важен)
-        std::sort(triplet.begin(), triplet.end());
-        
-        // Проверяем, есть ли уже такая тройка
-        bool exists = false;
-        for (const auto& existing : triplets) {
-            if (existing[0] == triplet[0] && 
-                existing[1] == triplet[1] && 
-                existing[2] == triplet[2]) {
-                exists = true;
-                break;
+    prepareGames("");
+    openOutputs();
+    
+    // Каждая игра пишет только свою строку - без блокировок
+    std::vector<std::array<long long, 3>> seatResults(gameCount);
+    std::vector<char> played(gameCount, 0);
+    std::atomic<uint64_t> nextGame(0);
+    size_t workerCount = static_cast<size_t>(std::max<uint64_t>(1, std::min<uint64_t>(threads, gameCount)));
+    
+    std::atomic<bool> failed(false);
+    
+    auto worker = [&](size_t) {
+        std::vector<uint32_t> group;
+        std::vector<long long> seatScores(3);
+        std::ostringstream discard;
+        for (;;) {
+            if (failed.load()) break;
+            uint64_t rank = nextGame.fetch_add(1);
+            if (rank >= gameCount) break;
+            multisets.unrank(rank, group);
+            for (int seat = 0; seat < 3; ++seat) {
+                group[seat] -= seat;
+            }
+            
+            std::fill(seatScores.begin(), seatScores.end(), 0);
+            discard.str("");
+            if (playCachedGroup(group, seatScores, discard)) {
+                seatResults[rank] = {seatScores[0], seatScores[1], seatScores[2]};
+                played[rank] = 1;
             }
         }
-        
-        if (!exists) {
-            triplets.push_back(triplet);
+    };
+    
+    std::exception_ptr failure = runPool(workerCount, failed, worker);
+    if (trace) {
+        trace->close();
+    }
+    if (results) {
+        results->close();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    
+    // Совпадающие места (i == j) усредняются
+    std::vector<int> samples(tensor.size(), 0);
+    double norm = static_cast<double>(roundsPerGame) * replicas;
+    std::vector<uint32_t> group;
+    for (uint64_t rank = 0; rank < gameCount; ++rank) {
+        if (!played[rank]) continue;
+        multisets.unrank(rank, group);
+        for (int seat = 0; seat < 3; ++seat) {
+            group[seat] -= seat;
         }
-        
-        // Пропускаем оставшиеся комбинации для этих индексов
-        std::reverse(indices.begin() + 3, indices.end());
-        
-    } while (std::next_permutation(indices.begin(), indices.end()));
+        for (int seat = 0; seat < 3; ++seat) {
+            size_t self = group[seat];
+            size_t first = group[seat == 0 ? 1 : 0];
+            size_t second = group[seat == 2 ? 1 : 2];
+            double value = seatResults[rank][seat] / norm;
+            for (size_t cell : {(self * n + first) * n + second, (self * n + second) * n + first}) {
+                tensor[cell] += value;
+                samples[cell]++;
+            }
+        }
+    }
+    for (size_t cell = 0; cell < tensor.size(); ++cell) {
+        if (samples[cell] > 0) tensor[cell] /= samples[cell];
+    }
+    return tensor;
+}
+
+void Tournament::saveCheckpoint(uint64_t chunkSize, const std::vector<char>& done,
+                                const std::vector<long long>& scores) const {
+    Checkpoint checkpoint;
+    checkpoint.results = getPartialResults();
+    checkpoint.results.scores = scores;
+    checkpoint.chunkSize = chunkSize;
+    checkpoint.done = done;
+    // Игры отмеченных блоков должны быть в файлах раньше отметок
+    if (trace) {
+        trace->flush();
+    }
+    if (results) {
+        results->flush();
+    }
+    checkpoint.save(checkpointFile);
+}
+
+void Tournament::setCheckpoint(const std::string& filename, int intervalSeconds) {
+    checkpointFile = filename;
+    checkpointInterval = intervalSeconds;
+}
+
+void Tournament::setThreads(int count) {
+    if (count <= 0) {
+        unsigned hardware = std::thread::hardware_concurrency();
+        count = hardware > 0 ? static_cast<int>(hardware) : 1;
+    }
+    threads = count;
+}
+
+void Tournament::setShard(int index, int count) {
+    shardCount = count > 0 ? count : 1;
+    shardIndex = (index >= 0 && index < shardCount) ? index : 0;
+}
+
+void Tournament::getShardRange(uint64_t& begin, uint64_t& end) const {
+    // Границы i*T/N без переполнения при больших T
+    uint64_t total = getGroupCount();
+    auto boundary = [&](uint64_t shard) {
+        return total / shardCount * shard + total % shardCount * shard / shardCount;
+    };
+    begin = boundary(shardIndex);
+    end = boundary(shardIndex + 1);
+}
+
+PartialResults Tournament::getPartialResults() const {
+    PartialResults part;
+    part.shardIndex = shardIndex;
+    part.shardCount = shardCount;
+    getShardRange(part.begin, part.end);
+    part.totalGroups = getGroupCount();
+    part.groupSize = groupSize;
+    part.rounds = roundsPerGame;
+    part.replicas = replicas;
+    part.analytic = analytic;
+    part.seed = seed;
+    part.matrixHash = matrixHash;
+    part.strategyNames = strategyNames;
+    part.displayNames = displayNames;
+    part.scores = scoresById;
+    return part;
+}
+
+bool Tournament::mergeResults(const std::vector<PartialResults>& parts) {
+    if (parts.empty()) return false;
+    
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+    for (const auto& part : parts) {
+        if (!part.isCompatible(parts[0]) || part.strategyNames != strategyNames ||
+            part.groupSize != groupSize || part.totalGroups != getGroupCount()) {
+            std::cerr << "Error: Partial results come from different tournaments" << std::endl;
+            return false;
+        }
+        ranges.emplace_back(part.begin, part.end);
+    }
+    
+    // Диапазоны должны стыковаться без пропусков и пересечений
+    std::sort(ranges.begin(), ranges.end());
+    uint64_t covered = 0;
+    for (const auto& range : ranges) {
+        if (range.first != covered) {
+            std::cerr << "Error: Partial results " << (range.first > covered ? "miss" : "overlap")
+                      << " groups starting at " << std::min(range.first, covered) + 1 << std::endl;
+            return false;
+        }
+        covered = range.second;
+    }
+    if (covered != getGroupCount()) {
+        std::cerr << "Error: Partial results miss groups starting at " << covered + 1 << std::endl;
+        return false;
+    }
+    
+    for (const auto& part : parts) {
+        for (size_t id = 0; id < scoresById.size(); ++id) {
+            scoresById[id] += part.scores[id];
+        }
+    }
+    displayNames = parts[0].displayNames;
+    buildScoreBoard();
+    return true;
+}
+
+uint64_t Tournament::getGroupCount() const {
+    return Combinations(static_cast<uint32_t>(strategyNames.size()), groupSize).size();
+}
+
+std::vector<std::string> Tournament::getGroup(uint64_t rank) const {
+    std::vector<uint32_t> group;
+    Combinations(static_cast<uint32_t>(strategyNames.size()), groupSize).unrank(rank, group);
+    
+    std::vector<std::string> names;
+    for (uint32_t id : group) {
+        names.push_back(strategyNames[id]);
+    }
+    return names;
+}
+
+void Tournament::resolveDisplayNames() {
+    // Имя в таблице результатов - имя стратегии (getName), а не псевдоним
+    auto& factory = StrategyFactory::getInstance();
+    for (size_t id = 0; id < strategyNames.size(); ++id) {
+        auto strategy = factory.createSlot(strategyNames[id], configDir);
+        displayNames[id] = strategy ? strategy->getName() : strategyNames[id];
+    }
+}
+
+std::vector<std::string> Tournament::getLabels() const {
+    // Разные псевдонимы одной стратегии остаются отдельными строками
+    std::map<std::string, int> labelUses;
+    for (const auto& name : displayNames) {
+        labelUses[name]++;
+    }
     
-    return triplets;
+    std::vector<std::string> labels = displayNames;
+    for (size_t id = 0; id < labels.size(); ++id) {
+        if (labelUses[labels[id]] > 1) {
+            labels[id] += " (" + strategyNames[id] + ")";
+        }
+    }
+    return labels;
+}
+
+void Tournament::buildScoreBoard() {
+    auto labels = getLabels();
+    totalScores.clear();
+    for (size_t id = 0; id < strategyNames.size(); ++id) {
+        totalScores[labels[id]] = scoresById[id];
+    }
 }
 
-void Tournament::playTriplet(const std::vector<std::string>& triplet) {
-    Game game(roundsPerGame, matrixFile);
+void Tournament::prepareGames(const std::string& countTableFile) {
+    resolveDisplayNames();
+    matrix = GameMatrix(matrixFile);
+    countTable = CountPayoffTable(groupSize, matrix, countTableFile);
     
     auto& factory = StrategyFactory::getInstance();
-    for (const auto& name : triplet) {
-        auto strategy = factory.create(name, configDir);
-        if (strategy) {
-            game.addPlayer(std::move(strategy));
+    configSignatures.assign(strategyNames.size(), "");
+    deterministic.assign(strategyNames.size(), 0);
+    memoryOne.assign(strategyNames.size(), 0);
+    for (size_t id = 0; id < strategyNames.size(); ++id) {
+        auto strategy = factory.createSlot(strategyNames[id], configDir);
+        configSignatures[id] = strategy ? strategy->getConfigSignature() : "missing:" + strategyNames[id];
+        uint64_t signature;
+        MemoryOneResponse response;
+        deterministic[id] = strategy && strategy->getStateSignature(signature);
+        memoryOne[id] = strategy && strategy->getMemoryOneResponse(response);
+    }
+    
+    int flat[PayoffTable::OUTCOMES * PayoffTable::SEATS];
+    matrix.getFlatTable(flat);
+    std::ostringstream payoffs;
+    payoffs << "matrix";
+    for (int value : flat) payoffs << " " << value;
+    payoffs << "|count";
+    for (int others = 0; others < groupSize; ++others) {
+        payoffs << " " << countTable.payoff(Move::COOPERATE, others)
+                << " " << countTable.payoff(Move::DEFECT, others);
+    }
+    matrixHash = ResultCache::hash(payoffs.str());
+    
+    cacheHits = 0;
+    cachePlayed = 0;
+    if (cacheFile.empty()) {
+        cache.reset();
+        return;
+    }
+    
+    // Всё, кроме стратегий и зерна, что влияет на исход игры. Версия
+    // растёт при изменении того, как из зерна получаются случайные ходы.
+    std::ostringstream settings;
+    settings << "pdcache 2|rounds " << roundsPerGame << "|replicas " << replicas
+             << "|group " << groupSize << "|analytic " << analytic << "|" << payoffs.str();
+    settingsHash = ResultCache::hash(settings.str());
+    
+    cache.reset(new ResultCache());
+    if (!cache->open(cacheFile)) {
+        cache.reset();
+    }
+}
+
+void Tournament::openOutputs(const TraceWriter::KeepGame& keep) {
+    results.reset();
+    if (!resultsFile.empty()) {
+        results.reset(new ResultsWriter());
+        if (!results->open(resultsFile, strategyNames, groupSize, roundsPerGame, replicas, seed, matrixHash, keep)) {
+            results.reset();
         }
     }
     
-    if (game.isReady()) {
+    trace.reset();
+    if (!traceFile.empty() && groupSize == GameTrace::SEATS) {
+        int flat[PayoffTable::OUTCOMES * PayoffTable::SEATS];
+        matrix.getFlatTable(flat);
+        std::ostringstream table;
+        for (int value : flat) table << value << " ";
+        trace.reset(new TraceWriter());
+        if (!trace->open(traceFile, strategyNames, seed, ResultCache::hash(table.str()), keep)) {
+            trace.reset();
+        }
+    }
+}
+
+uint64_t Tournament::groupKey(const std::vector<uint32_t>& group) const {
+    // Сигнатуры в порядке мест; разделитель исключает склейку соседних
+    uint64_t key = settingsHash;
+    if (!isSeedIndependent(group)) {
+        key = ResultCache::hash("seed " + std::to_string(seed), key);
+    }
+    for (uint32_t id : group) {
+        key = ResultCache::hash(configSignatures[id], key);
+        key = ResultCache::hash(std::string(1, '\0'), key);
+    }
+    return key;
+}
+
+bool Tournament::isSeedIndependent(const std::vector<uint32_t>& group) const {
+    auto all = [&](const std::vector<char>& flags) {
+        return std::all_of(group.begin(), group.end(), [&](uint32_t id) { return flags[id] != 0; });
+    };
+    return all(deterministic) || (analytic && groupSize == MarkovGame::SEATS && all(memoryOne));
+}
+
+void Tournament::exportResult(const std::vector<uint32_t>& group, const std::vector<long long>& scores,
+                              const std::vector<long long>& cooperations, int32_t replica,
+                              ResultsTable::Source source, std::chrono::steady_clock::time_point started,
+                              int64_t share) const {
+    if (!results) return;
+    auto wall = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started);
+    results->append({group, scores, cooperations, replica, source, wall.count() / share});
+}
+
+uint64_t Tournament::gameId(const std::vector<uint32_t>& group) const {
+    uint64_t id = ResultCache::FNV_OFFSET;
+    for (uint32_t member : group) {
+        id = ResultCache::hash(configSignatures[member], id);
+        id = ResultCache::hash(std::string(1, '\0'), id);
+    }
+    return id;
+}
+
+bool Tournament::playCachedGroup(const std::vector<uint32_t>& group, std::vector<long long>& seatScores, std::ostream& out) const {
+    if (!cache) return playGroup(group, seatScores, out);
+    
+    uint64_t key = groupKey(group);
+    auto started = std::chrono::steady_clock::now();
+    if (cache->lookup(key, seatScores)) {
+        cacheHits++;
+        exportResult(group, seatScores, {}, -1, ResultsTable::CACHED, started);
+        out << "Cached results: ";
+        for (size_t i = 0; i < group.size(); ++i) {
+            out << displayNames[group[i]] << "=" << seatScores[i];
+            if (i < group.size() - 1) out << ", ";
+        }
+        out << "\n";
+        return true;
+    }
+    
+    if (!playGroup(group, seatScores, out)) return false;
+    cachePlayed++;
+    cache->store(key, seatScores);
+    return true;
+}
+
+void Tournament::playTriplet(const std::vector<uint32_t>& group, std::vector<long long>& totals, std::ostream& out) const {
+    std::vector<long long> seatScores(group.size(), 0);
+    if (!playCachedGroup(group, seatScores, out)) return;
+    for (size_t i = 0; i < group.size(); ++i) {
+        totals[group[i]] += seatScores[i];
+    }
+}
+
+bool Tournament::playGroup(const std::vector<uint32_t>& group, std::vector<long long>& seatScores, std::ostream& out) const {
+    if (analytic) {
+        if (playAnalyticTriplet(group, seatScores, out)) return true;
+        out << "Not all strategies are memory-one, simulating\n";
+    }
+    
+    // Повторы детерминированных стратегий одинаковы: играется один
+    // Game с перемоткой циклов, результат копируется на все повторы
+    bool identical = replicas > 1 &&
+                     std::all_of(group.begin(), group.end(), [&](uint32_t id) { return deterministic[id] != 0; });
+    // Пакетный движок рассчитан на три места
+    if (replicas > 1 && groupSize == 3 && !identical) {
+        return playReplicatedTriplet(group, seatScores, out);
+    }
+    
+    std::vector<long long> scores(group.size(), 0);
+    std::vector<std::string> names;
+    uint64_t streamId = gameId(group);
+    TraceEncoder encoder;
+    int copies = identical ? replicas : 1;
+    
+    for (int r = 0; r < replicas; r += copies) {
+        auto started = std::chrono::steady_clock::now();
+        Game game(roundsPerGame, matrix, countTable);
+        game.setRandomSeed(seed, streamId, static_cast<uint32_t>(r));
+        if (trace) {
+            game.setTrace(&encoder);
+        }
+        
+        auto& factory = StrategyFactory::getInstance();
+        for (uint32_t id : group) {
+            auto strategy = factory.createSlot(strategyNames[id], configDir);
+            if (strategy) {
+                game.addPlayer(std::move(strategy));
+            }
+        }
+        
+        if (!game.isReady()) return false;
         game.playGame();
-        auto scores = game.getScores();
-        auto names = game.getPlayerNames();
+        std::string record = trace ? encoder.finish(group.data(), static_cast<uint32_t>(r)) : std::string();
         
-        for (size_t i = 0; i < names.size(); ++i) {
-            totalScores[names[i]] += scores[i];
+        auto gameScores = game.getScores();
+        auto cooperations = game.getCooperations();
+        for (int copy = r; copy < r + copies; ++copy) {
+            if (trace) {
+                GameTrace::setReplica(record, static_cast<uint32_t>(copy));
+                trace->append(record);
+            }
+            for (size_t i = 0; i < gameScores.size(); ++i) {
+                scores[i] += gameScores[i];
+            }
+            exportResult(group, gameScores, cooperations, copy, ResultsTable::PLAYED, started, copies);
+        }
+        names = game.getPlayerNames();
+    }
+    
+    for (size_t i = 0; i < names.size(); ++i) {
+        seatScores[i] += scores[i];
+    }
+    
+    out << "Game results: ";
+    for (size_t i = 0; i < names.size(); ++i) {
+        out << names[i] << "=" << scores[i];
+        if (i < names.size() - 1) out << ", ";
+    }
+    out << "\n";
+    return true;
+}
+
+bool Tournament::playReplicatedTriplet(const std::vector<uint32_t>& group, std::vector<long long>& seatScores, std::ostream& out) const {
+    auto started = std::chrono::steady_clock::now();
+    BatchGame batch(replicas, roundsPerGame, matrix);
+    batch.setRandomSeed(seed, gameId(group));
+    std::vector<TraceEncoder> encoders(trace ? replicas : 0);
+    if (trace) {
+        batch.setTrace(&encoders);
+    }
+    
+    auto& factory = StrategyFactory::getInstance();
+    for (int r = 0; r < replicas; ++r) {
+        for (uint32_t id : group) {
+            auto strategy = factory.createSlot(strategyNames[id], configDir);
+            if (!strategy) return false;
+            batch.addPlayer(r, std::move(strategy));
         }
+    }
+    
+    batch.playGame();
+    for (size_t r = 0; r < encoders.size(); ++r) {
+        trace->append(encoders[r].finish(group.data(), static_cast<uint32_t>(r)));
+    }
+    for (int r = 0; results && r < replicas; ++r) {
+        exportResult(group, batch.getScores(r), batch.getCooperations(r), r,
+                     ResultsTable::PLAYED, started, replicas);
+    }
+    auto scores = batch.getTotalScores();
+    auto names = batch.getPlayerNames(0);
+    
+    for (size_t i = 0; i < names.size(); ++i) {
+        seatScores[i] += scores[i];
+    }
+    
+    out << "Game results (" << replicas << " replicas): ";
+    for (size_t i = 0; i < names.size(); ++i) {
+        out << names[i] << "=" << scores[i];
+        if (i < names.size() - 1) out << ", ";
+    }
+    out << "\n";
+    return true;
+}
+
+bool Tournament::playAnalyticTriplet(const std::vector<uint32_t>& group, std::vector<long long>& seatScores, std::ostream& out) const {
+    if (groupSize != MarkovGame::SEATS) return false;
+    auto started = std::chrono::steady_clock::now();
+    
+    auto& factory = StrategyFactory::getInstance();
+    std::vector<StrategySlot> slots;
+    std::vector<const Strategy*> strategies;
+    for (uint32_t id : group) {
+        slots.push_back(factory.createSlot(strategyNames[id], configDir));
+        if (!slots.back()) return false;
+    }
+    for (const auto& slot : slots) {
+        strategies.push_back(slot.get());
+    }
+    
+    std::array<MemoryOneResponse, MarkovGame::SEATS> responses;
+    if (!MarkovGame::describe(strategies, responses)) return false;
+    
+    MarkovGame markov(responses, matrix);
+    auto expected = markov.expectedTotals(roundsPerGame);
+    
+    // Сумма ожиданий по повторам, округлённая до целых очков
+    out << "Expected results: ";
+    for (size_t i = 0; i < slots.size(); ++i) {
+        double total = expected[i] * replicas;
+        seatScores[i] += std::llround(total);
         
-        std::cout << "Game results: ";
-        for (size_t i = 0; i < names.size(); ++i) {
-            std::cout << names[i] << "=" << scores[i];
-            if (i < names.size() - 1) std::cout << ", ";
+        out << slots[i]->getName() << "=" << std::fixed << std::setprecision(2) << total
+            << std::defaultfloat;
+        if (i < slots.size() - 1) out << ", ";
+    }
+    out << "\n";
+    
+    if (results) {
+        std::vector<long long> scores(slots.size()), cooperations(slots.size());
+        auto expectedCooperations = markov.expectedCooperations(roundsPerGame);
+        for (size_t i = 0; i < slots.size(); ++i) {
+            scores[i] = std::llround(expected[i] * replicas);
+            cooperations[i] = std::llround(expectedCooperations[i] * replicas);
         }
-        std::cout << std::endl;
+        exportResult(group, scores, cooperations, -1, ResultsTable::ANALYTIC, started);
     }
+    return true;
 }
 
 void Tournament::printResults() const {
@@ -112,7 +801,7 @@ void Tournament::printResults() const {
     std::cout << "TOURNAMENT FINAL RESULTS" << std::endl;
     std::cout << "=========================================" << std::endl;
     
-    std::vector<std::pair<std::string, int>> sortedScores(
+    std::vector<std::pair<std::string, long long>> sortedScores(
         totalScores.begin(), totalScores.end());
     
     std::sort(sortedScores.begin(), sortedScores.end(),
@@ -5,16 +5,69 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <ostream>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
 #include "core/Strategy.h"
 #include "core/Game.h"
+#include "core/BatchGame.h"
+#include "core/PartialResults.h"
+#include "core/ResultCache.h"
+#include "core/GameTrace.h"
+#include "core/ResultsTable.h"
 
 class Tournament {
+public:
+    using ScoreBoard = std::map<std::string, long long>;
+
 private:
+    // Уникальные имена по алфавиту; номер в списке - ID стратегии
     std::vector<std::string> strategyNames;
+    std::vector<std::string> displayNames;
     std::string configDir;
     std::string matrixFile;
     int roundsPerGame;
-    std::map<std::string, int> totalScores;
+    int replicas;
+    int groupSize;
+    bool analytic;
+    uint64_t seed;
+    int threads;
+    int shardIndex;
+    int shardCount;
+    std::string checkpointFile;
+    int checkpointInterval;
+    bool resume;
+    bool interrupted;
+    std::vector<long long> scoresById;
+    ScoreBoard totalScores;
+    // Загружаются в run() один раз на турнир
+    GameMatrix matrix;
+    CountPayoffTable countTable;
+    // Кэш результатов игр; ключ игры - settingsHash, продолженный
+    // зерном (только если исход от него зависит) и сигнатурами
+    // конфигураций стратегий по местам
+    std::string cacheFile;
+    std::unique_ptr<ResultCache> cache;
+    std::vector<std::string> configSignatures;
+    // По ID: стратегия детерминирована (getStateSignature) и
+    // описывается памятью в один раунд (getMemoryOneResponse)
+    std::vector<char> deterministic;
+    std::vector<char> memoryOne;
+    uint64_t settingsHash;
+    // Хэш матрицы и таблицы выигрышей (prepareGames); сверяется
+    // у шардов и контрольной точки
+    uint64_t matrixHash;
+    mutable std::atomic<uint64_t> cacheHits;
+    mutable std::atomic<uint64_t> cachePlayed;
+    // Двоичная трасса сыгранных игр (GameTrace)
+    std::string traceFile;
+    std::unique_ptr<TraceWriter> trace;
+    // Строки по играм (ResultsTable)
+    std::string resultsFile;
+    std::unique_ptr<ResultsWriter> results;
+    
+    static std::atomic<bool> stopRequested;
     
 public:
     Tournament(const std::vector<std::string>& strategies, 
@@ -25,11 +78,120 @@ public:
     void run();
     void printResults() const;
     std::string getWinner() const;
-    std::map<std::string, int> getScores() const { return totalScores; }
+    ScoreBoard getScores() const { return totalScores; }
+    
+    // Число независимых повторов каждой тройки (играются пакетом)
+    void setReplicas(int count) { replicas = count > 0 ? count : 1; }
+    int getReplicas() const { return replicas; }
+    
+    // Размер группы, играющей одну игру (по умолчанию тройки)
+    void setGroupSize(int size) { groupSize = size > 1 ? size : 2; }
+    int getGroupSize() const { return groupSize; }
+    
+    // Ожидаемые очки из цепи Маркова вместо симуляции (для троек
+    // стратегий с памятью в один раунд, остальные играются как обычно)
+    void setAnalytic(bool enabled) { analytic = enabled; }
+    bool isAnalytic() const { return analytic; }
+    
+    // Зерно случайных чисел. Поток места в игре зависит от зерна,
+    // состава группы по местам, номера повтора и места (RandomStream),
+    // но не от рангов групп и числа потоков: одно зерно - одни очки.
+    void setSeed(uint64_t value) { seed = value; }
+    uint64_t getSeed() const { return seed; }
+    
+    // Число рабочих потоков; 0 - по числу ядер. Итоговые очки
+    // не зависят от числа потоков, вывод идёт в порядке троек.
+    void setThreads(int count);
+    int getThreads() const { return threads; }
+    
+    // Группы нумеруются лениво (Combinations), без хранения списка
+    uint64_t getGroupCount() const;
+    std::vector<std::string> getGroup(uint64_t rank) const;
+    const std::vector<std::string>& getStrategyNames() const { return strategyNames; }
+    // Имена для таблиц по ID: getName() стратегии, при совпадении - с псевдонимом
+    std::vector<std::string> getLabels() const;
+    
+    // Шард index из count (0 <= index < count) играет свой непрерывный
+    // диапазон рангов групп; результаты шардов складывает mergeResults
+    void setShard(int index, int count);
+    int getShardIndex() const { return shardIndex; }
+    int getShardCount() const { return shardCount; }
+    void getShardRange(uint64_t& begin, uint64_t& end) const;
+    PartialResults getPartialResults() const;
+    // false, если результаты несовместимы или не покрывают
+    // все группы ровно по одному разу
+    bool mergeResults(const std::vector<PartialResults>& parts);
+    
+    // Тензор выигрышей для ReplicatorDynamics: каждая тройка стратегий
+    // с повторениями играется один раз (на потоках setThreads), значение
+    // [(i * n + j) * n + k] - средний выигрыш i за раунд против j и k.
+    // Только для групп из трёх игроков.
+    std::vector<double> computePayoffTensor();
+    
+    // Кэш результатов игр в файле (см. ResultCache); run() и
+    // computePayoffTensor играют только отсутствующие в нём группы.
+    // Пустое имя отключает кэш.
+    void setCacheFile(const std::string& filename) { cacheFile = filename; }
+    uint64_t getCacheHits() const { return cacheHits.load(); }
+    uint64_t getCachePlayed() const { return cachePlayed.load(); }
+    
+    // Исходы всех раундов сыгранных троек в двоичный файл (GameTrace):
+    // запись на игру и повтор, в порядке завершения. Игры из кэша
+    // и аналитические тройки не играются и в трассу не попадают.
+    // Пустое имя отключает трассу.
+    void setTraceFile(const std::string& filename) { traceFile = filename; }
+    uint64_t getTracedGames() const { return trace ? trace->getGameCount() : 0; }
+    
+    // Строка на каждую игру (повтор) в filename (.pdr) и рядом в .csv,
+    // см. ResultsTable. Пустое имя отключает запись.
+    void setResultsFile(const std::string& filename) { resultsFile = filename; }
+    uint64_t getExportedRows() const { return results ? results->getRowCount() : 0; }
+    
+    // Контрольная точка пишется в filename не чаще раза в intervalSeconds
+    // и при остановке; после полного прохода файл удаляется.
+    // Пустое имя отключает контрольные точки.
+    void setCheckpoint(const std::string& filename, int intervalSeconds = 60);
+    // Продолжить с контрольной точки, пропуская завершённые блоки
+    void setResume(bool enabled) { resume = enabled; }
+    // run() остановлен до конца (requestStop), очки неполные
+    bool wasInterrupted() const { return interrupted; }
+    
+    // Просьба остановить run() после текущих блоков; безопасна
+    // в обработчике сигнала
+    static void requestStop() { stopRequested.store(true); }
+    static void clearStopRequest() { stopRequested.store(false); }
     
 private:
-    void playTriplet(const std::vector<std::string>& triplet);
-    std::vector<std::vector<std::string>> generateTriplets() const;
+    // group - ID стратегий по местам; очки добавляются в scores[ID],
+    // отчёт пишется в out
+    void playTriplet(const std::vector<uint32_t>& group, std::vector<long long>& scores, std::ostream& out) const;
+    // То же с очками по местам (ID в группе могут повторяться);
+    // false, если группу не удалось собрать
+    bool playGroup(const std::vector<uint32_t>& group, std::vector<long long>& seatScores, std::ostream& out) const;
+    // playGroup через кэш результатов
+    bool playCachedGroup(const std::vector<uint32_t>& group, std::vector<long long>& seatScores, std::ostream& out) const;
+    uint64_t groupKey(const std::vector<uint32_t>& group) const;
+    // Исход группы не зависит от зерна: все стратегии детерминированы
+    // или группа считается аналитически
+    bool isSeedIndependent(const std::vector<uint32_t>& group) const;
+    // Строка таблицы результатов, если она ведётся; started - начало игры
+    void exportResult(const std::vector<uint32_t>& group, const std::vector<long long>& scores,
+                      const std::vector<long long>& cooperations, int32_t replica,
+                      ResultsTable::Source source, std::chrono::steady_clock::time_point started,
+                      int64_t share = 1) const;
+    // Номер игры для потоков случайных чисел - хэш сигнатур по местам,
+    // поэтому добавление стратегий в турнир не меняет уже сыгранных игр
+    uint64_t gameId(const std::vector<uint32_t>& group) const;
+    // Имена, матрица, сигнатуры конфигураций и кэш перед играми
+    void prepareGames(const std::string& countTableFile);
+    // Трасса и таблица результатов; keep - игры, сохраняемые при продолжении
+    void openOutputs(const TraceWriter::KeepGame& keep = nullptr);
+    bool playReplicatedTriplet(const std::vector<uint32_t>& group, std::vector<long long>& seatScores, std::ostream& out) const;
+    bool playAnalyticTriplet(const std::vector<uint32_t>& group, std::vector<long long>& seatScores, std::ostream& out) const;
+    void resolveDisplayNames();
+    void buildScoreBoard();
+    void saveCheckpoint(uint64_t chunkSize, const std::vector<char>& done,
+                        const std::vector<long long>& scores) const;
 };
 
 #endif
\ No newline at end of file
@@ -3,6 +3,10 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <csignal>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
 
 #include "core/Game.h"
 #include "core/GameMatrix.h"
@@ -10,6 +14,14 @@
 #include "core/Strategy.h"
 #include "core/StrategyFactory.h"
 #include "core/History.h"
+#include "core/PartialResults.h"
+#include "core/Checkpoint.h"
+#include "core/ReplicatorDynamics.h"
+#include "core/SpatialGame.h"
+#include "core/ResultCache.h"
+#include "core/GameTrace.h"
+#include "core/ResultsTable.h"
+#include <chrono>
 
 #include "utils/Parser.h"
 #include "utils/Logger.h"
@@ -20,16 +32,277 @@ void printHelp() {
     std::cout << "\nUsage:" << std::endl;
     std::cout << "  prisoners_dilemma <strategy1> <strategy2> <strategy3> [options]" << std::endl;
     std::cout << "\nOptions:" << std::endl;
-    std::cout << "  --mode=detailed|fast|tournament" << std::endl;
+    std::cout << "  --mode=detailed|fast|tournament|analytic|ecological|spatial" << std::endl;
     std::cout << "  --steps=<number>" << std::endl;
     std::cout << "  --configs=<directory>" << std::endl;
     std::cout << "  --matrix=<filename>      # Load matrix from file" << std::endl;
+    std::cout << "  --replicas=<number>      # Tournament: independent replicas per triplet" << std::endl;
+    std::cout << "  --group=<number>         # Players per game (default 3)" << std::endl;
+    std::cout << "  --threads=<number>       # Tournament worker threads (0 - all cores)" << std::endl;
+    std::cout << "  --shard=<i>/<N>          # Tournament: play slice i of N (0 <= i < N)" << std::endl;
+    std::cout << "  --checkpoint=<seconds>   # Tournament: checkpoint period (default 60, 0 - only on Ctrl+C)" << std::endl;
+    std::cout << "  --resume                 # Tournament: continue from the checkpoint (its seed unless --seed)" << std::endl;
+    std::cout << "  --cache                  # Reuse game results from <configs>/game_cache.txt" << std::endl;
+    std::cout << "  --generations=<number>   # Ecological: replicator dynamics generations (default 1000)" << std::endl;
+    std::cout << "  --lattice=<W>x<H>        # Spatial: torus of W*H agents (default 100x100)" << std::endl;
+    std::cout << "  --graph=<filename>       # Spatial: agents on a graph from an edge list \"u v\"" << std::endl;
+    std::cout << "  --log-rounds=<N>         # Log every N-th round to <configs>/game_log.txt (default 0 - off)" << std::endl;
+    std::cout << "  --seed=<number>          # Random seed; same seed gives the same results (default: clock)" << std::endl;
+    std::cout << "  --trace                  # Tournament: write every round to <configs>/tournament_trace.pdt" << std::endl;
+    std::cout << "  --results                # Tournament: per-game rows to <configs>/tournament_results.pdr and .csv" << std::endl;
     std::cout << "  --help                   # Show this help" << std::endl;
+    std::cout << "\nTable strategies: any name with <configs>/<name>.cfg containing type=table|fsm" << std::endl;
     std::cout << "\nExamples:" << std::endl;
     std::cout << "  prisoners_dilemma random alwayscooperate alwaysdefect" << std::endl;
     std::cout << "  prisoners_dilemma tft adaptive random --mode=fast --steps=50" << std::endl;
     std::cout << "  prisoners_dilemma random coop def --matrix=matrix.txt" << std::endl;
     std::cout << "  prisoners_dilemma s1 s2 s3 s4 s5 --mode=tournament" << std::endl;
+    std::cout << "  prisoners_dilemma s1 s2 s3 s4 s5 s6 s7 --mode=tournament --group=5" << std::endl;
+    std::cout << "  prisoners_dilemma tft random coop def --mode=analytic --steps=1000" << std::endl;
+    std::cout << "  prisoners_dilemma s1 s2 s3 s4 s5 --mode=tournament --shard=0/2 --configs=out" << std::endl;
+    std::cout << "  prisoners_dilemma merge out/tournament_shard_0_of_2.txt out/tournament_shard_1_of_2.txt" << std::endl;
+    std::cout << "  prisoners_dilemma s1 s2 s3 s4 s5 --mode=tournament --configs=out --resume" << std::endl;
+    std::cout << "  prisoners_dilemma s1 s2 s3 s4 s5 s6 --mode=tournament --cache --configs=out" << std::endl;
+    std::cout << "  prisoners_dilemma s1 s2 s3 s4 --mode=tournament --trace --configs=out" << std::endl;
+    std::cout << "  prisoners_dilemma trace out/tournament_trace.pdt" << std::endl;
+    std::cout << "  prisoners_dilemma tft random coop def ff --mode=ecological --generations=10000" << std::endl;
+    std::cout << "  prisoners_dilemma tft coop def --mode=spatial --lattice=1000x1000 --generations=100 --threads=0" << std::endl;
+}
+
+// Зерно запуска: --seed, при --resume - зерно контрольной точки,
+// иначе от часов. Шарды без --seed играют с зерном 0, иначе их
+// результаты не сложились бы.
+uint64_t chooseSeed(const Parser& config, const std::string& checkpointFile = "") {
+    if (config.hasSeed()) return config.getSeed();
+    Checkpoint checkpoint;
+    if (config.getResume() && !checkpointFile.empty() && checkpoint.load(checkpointFile)) {
+        return checkpoint.results.seed;
+    }
+    if (config.getShardCount() > 1) return 0;
+    return static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+}
+
+// Экологический режим: тензор выигрышей считается один раз, затем
+// доли стратегий эволюционируют; траектория пишется в CSV
+int runEcology(const Parser& config) {
+    std::cout << "\n=== PRISONER'S DILEMMA ECOLOGY ===" << std::endl;
+    Tournament tournament(config.getStrategies(),
+                          config.getSteps(),
+                          config.getConfigDir(),
+                          config.getMatrixFile());
+    tournament.setReplicas(config.getReplicas());
+    tournament.setThreads(config.getThreads());
+    tournament.setSeed(chooseSeed(config));
+    std::cout << "Seed: " << tournament.getSeed() << std::endl;
+    if (config.getUseCache()) {
+        tournament.setCacheFile(ResultCache::fileName(config.getConfigDir()));
+    }
+    
+    auto tensor = tournament.computePayoffTensor();
+    auto labels = tournament.getLabels();
+    ReplicatorDynamics dynamics(labels.size(), std::move(tensor));
+    
+    std::string trajectoryFile = (config.getConfigDir().empty() ? "." : config.getConfigDir())
+                                 + "/ecology_trajectory.csv";
+    std::ofstream csv(trajectoryFile, std::ios::trunc);
+    if (!csv.is_open()) {
+        std::cerr << "Warning: Cannot write trajectory to " << trajectoryFile << std::endl;
+    }
+    csv << "generation";
+    for (const auto& label : labels) {
+        csv << "," << label;
+    }
+    csv << "\n" << std::setprecision(10);
+    
+    auto writeRow = [&]() {
+        csv << dynamics.getGeneration();
+        for (double share : dynamics.getShares()) {
+            csv << "," << share;
+        }
+        csv << "\n";
+    };
+    writeRow();
+    while (dynamics.getGeneration() < config.getGenerations()) {
+        if (!dynamics.step()) {
+            std::cerr << "Warning: Mean fitness is not positive, stopped at generation "
+                      << dynamics.getGeneration() << std::endl;
+            break;
+        }
+        writeRow();
+    }
+    
+    std::vector<size_t> order(labels.size());
+    for (size_t id = 0; id < order.size(); ++id) order[id] = id;
+    const auto& shares = dynamics.getShares();
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return shares[a] > shares[b];
+    });
+    
+    std::cout << "\nPopulation after " << dynamics.getGeneration() << " generations:" << std::endl;
+    std::cout << std::left << std::setw(25) << "Strategy"
+              << std::right << std::setw(12) << "Share"
+              << std::setw(12) << "Fitness" << std::endl;
+    std::cout << std::string(49, '-') << std::endl;
+    for (size_t id : order) {
+        std::cout << std::left << std::setw(25) << labels[id]
+                  << std::right << std::fixed << std::setprecision(6)
+                  << std::setw(12) << shares[id]
+                  << std::setw(12) << dynamics.getFitness()[id]
+                  << std::defaultfloat << std::endl;
+    }
+    std::cout << "\nTrajectory written to " << trajectoryFile << std::endl;
+    return 0;
+}
+
+// Пространственный режим: агенты на решётке или графе перенимают
+// стратегию лучшего соседа; число агентов каждой стратегии пишется в CSV
+int runSpatial(const Parser& config) {
+    std::cout << "\n=== PRISONER'S DILEMMA SPATIAL POPULATION ===" << std::endl;
+    NeighborGraph graph;
+    if (!config.getGraphFile().empty()) {
+        if (!graph.loadEdgeList(config.getGraphFile())) {
+            return 1;
+        }
+        std::cout << "Graph: " << config.getGraphFile() << std::endl;
+    } else {
+        graph = NeighborGraph::lattice(config.getLatticeWidth(), config.getLatticeHeight());
+        std::cout << "Lattice: " << config.getLatticeWidth() << "x" << config.getLatticeHeight() << " torus" << std::endl;
+    }
+    std::cout << "Agents: " << graph.getVertexCount() << ", edges: " << graph.getEdgeCount() << std::endl;
+    
+    Tournament tournament(config.getStrategies(),
+                          config.getSteps(),
+                          config.getConfigDir(),
+                          config.getMatrixFile());
+    tournament.setReplicas(config.getReplicas());
+    tournament.setThreads(config.getThreads());
+    tournament.setSeed(chooseSeed(config));
+    std::cout << "Seed: " << tournament.getSeed() << std::endl;
+    if (config.getUseCache()) {
+        tournament.setCacheFile(ResultCache::fileName(config.getConfigDir()));
+    }
+    if (tournament.getStrategyNames().size() > 0xFFFF) {
+        std::cerr << "Error: Too many strategies for spatial mode" << std::endl;
+        return 1;
+    }
+    
+    auto tensor = tournament.computePayoffTensor();
+    auto labels = tournament.getLabels();
+    SpatialGame population(graph, labels.size(), std::move(tensor));
+    population.setThreads(config.getThreads());
+    population.seedUniform(tournament.getSeed());
+    
+    std::string trajectoryFile = (config.getConfigDir().empty() ? "." : config.getConfigDir())
+                                 + "/spatial_trajectory.csv";
+    std::ofstream csv(trajectoryFile, std::ios::trunc);
+    if (!csv.is_open()) {
+        std::cerr << "Warning: Cannot write trajectory to " << trajectoryFile << std::endl;
+    }
+    csv << "generation";
+    for (const auto& label : labels) {
+        csv << "," << label;
+    }
+    csv << "\n";
+    
+    auto writeRow = [&](const std::vector<uint64_t>& counts) {
+        csv << population.getGeneration();
+        for (uint64_t count : counts) {
+            csv << "," << count;
+        }
+        csv << "\n";
+    };
+    
+    auto counts = population.countStrategies();
+    writeRow(counts);
+    auto started = std::chrono::steady_clock::now();
+    while (population.getGeneration() < config.getGenerations()) {
+        population.step();
+        counts = population.countStrategies();
+        writeRow(counts);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    
+    std::cout << "\nPopulation after " << population.getGeneration() << " generations ("
+              << std::fixed << std::setprecision(2) << seconds << " s):" << std::defaultfloat << std::endl;
+    std::cout << std::left << std::setw(25) << "Strategy"
+              << std::right << std::setw(12) << "Agents"
+              << std::setw(12) << "Share" << std::endl;
+    std::cout << std::string(49, '-') << std::endl;
+    double agents = std::max<double>(1.0, graph.getVertexCount());
+    for (size_t id = 0; id < labels.size(); ++id) {
+        std::cout << std::left << std::setw(25) << labels[id]
+                  << std::right << std::setw(12) << counts[id]
+                  << std::fixed << std::setprecision(4) << std::setw(12) << counts[id] / agents
+                  << std::defaultfloat << std::endl;
+    }
+    std::cout << "\nTrajectory written to " << trajectoryFile << std::endl;
+    return 0;
+}
+
+// Сводка по файлу трассы: частоты исходов и доля сотрудничества
+// стратегий по всем раундам
+int runTraceSummary(const Parser& config) {
+    TraceReader reader;
+    if (!reader.open(config.getInputFiles()[0])) {
+        return 1;
+    }
+    const auto& names = reader.getStrategyNames();
+    std::vector<uint64_t> outcomes(PayoffTable::OUTCOMES, 0);
+    std::vector<uint64_t> played(names.size(), 0);
+    std::vector<uint64_t> cooperated(names.size(), 0);
+    uint64_t rounds = 0;
+    
+    for (size_t index = 0; index < reader.getGameCount(); ++index) {
+        const auto& game = reader.getGame(index);
+        std::vector<uint64_t> counts(PayoffTable::OUTCOMES, 0);
+        reader.forEachRun(index, [&](int outcome, uint64_t length) {
+            counts[outcome] += length;
+        });
+        rounds += game.rounds;
+        for (int outcome = 0; outcome < PayoffTable::OUTCOMES; ++outcome) {
+            outcomes[outcome] += counts[outcome];
+            for (uint32_t seat = 0; seat < GameTrace::SEATS; ++seat) {
+                uint32_t id = game.ids[seat];
+                if (id >= names.size()) continue;
+                played[id] += counts[outcome];
+                // Бит места: ход первого - старший (PayoffTable::outcomeIndex)
+                if (!((outcome >> (GameTrace::SEATS - 1 - seat)) & 1)) {
+                    cooperated[id] += counts[outcome];
+                }
+            }
+        }
+    }
+    
+    std::cout << "Trace: " << config.getInputFiles()[0] << std::endl;
+    std::cout << "Seed: " << reader.getSeed() << ", games: " << reader.getGameCount()
+              << ", rounds: " << rounds << std::endl;
+    std::cout << "\nOutcomes:" << std::endl;
+    for (int outcome = 0; outcome < PayoffTable::OUTCOMES; ++outcome) {
+        std::string label;
+        for (int seat = GameTrace::SEATS - 1; seat >= 0; --seat) {
+            label += (outcome >> seat) & 1 ? 'D' : 'C';
+        }
+        std::cout << "  " << label << std::setw(16) << outcomes[outcome] << std::endl;
+    }
+    std::cout << "\n" << std::left << std::setw(25) << "Strategy"
+              << std::right << std::setw(16) << "Rounds"
+              << std::setw(14) << "Cooperation" << std::endl;
+    std::cout << std::string(55, '-') << std::endl;
+    for (size_t id = 0; id < names.size(); ++id) {
+        std::cout << std::left << std::setw(25) << names[id]
+                  << std::right << std::setw(16) << played[id]
+                  << std::fixed << std::setprecision(4) << std::setw(14)
+                  << (played[id] ? static_cast<double>(cooperated[id]) / played[id] : 0.0)
+                  << std::defaultfloat << std::endl;
+    }
+    return 0;
+}
+
+// Ctrl+C: турнир дописывает контрольную точку и завершается,
+// повторный Ctrl+C прерывает сразу
+void handleInterrupt(int) {
+    Tournament::requestStop();
+    std::signal(SIGINT, SIG_DFL);
 }
 
 int main(int argc, char* argv[]) {
@@ -44,17 +317,72 @@ int main(int argc, char* argv[]) {
         
         // Создаем логгер
         Logger logger(config.getConfigDir());
+        logger.setRoundSampling(config.getLogRounds());
         
         // Получаем фабрику стратегий
         auto& factory = StrategyFactory::getInstance();
         
-        if (config.getMode() == "tournament") {
+        if (config.getMode() == "trace") {
+            return runTraceSummary(config);
+        }
+        
+        if (config.getMode() == "merge") {
+            // Сложение результатов шардов
+            std::vector<PartialResults> parts(config.getInputFiles().size());
+            for (size_t i = 0; i < parts.size(); ++i) {
+                if (!parts[i].load(config.getInputFiles()[i])) {
+                    return 1;
+                }
+            }
+            
+            Tournament tournament(parts[0].strategyNames, parts[0].rounds);
+            tournament.setGroupSize(parts[0].groupSize);
+            tournament.setReplicas(parts[0].replicas);
+            tournament.setAnalytic(parts[0].analytic);
+            tournament.setSeed(parts[0].seed);
+            if (!tournament.mergeResults(parts)) {
+                return 1;
+            }
+            tournament.printResults();
+            
+        } else if (config.getMode() == "ecological") {
+            return runEcology(config);
+            
+        } else if (config.getMode() == "spatial") {
+            return runSpatial(config);
+            
+        } else if (config.getMode() == "tournament" || config.getMode() == "analytic") {
             // Турнирный режим
             std::cout << "\n=== PRISONER'S DILEMMA TOURNAMENT ===" << std::endl;
             Tournament tournament(config.getStrategies(), 
                                  config.getSteps(),
                                  config.getConfigDir(),
                                  config.getMatrixFile());
+            tournament.setReplicas(config.getReplicas());
+            tournament.setGroupSize(config.getGroupSize());
+            tournament.setAnalytic(config.getMode() == "analytic");
+            tournament.setThreads(config.getThreads());
+            tournament.setShard(config.getShardIndex(), config.getShardCount());
+            std::string checkpointFile = Checkpoint::fileName(
+                config.getConfigDir(), config.getShardIndex(), config.getShardCount());
+            tournament.setSeed(chooseSeed(config, checkpointFile));
+            tournament.setCheckpoint(checkpointFile, config.getCheckpointInterval());
+            tournament.setResume(config.getResume());
+            if (config.getUseCache()) {
+                tournament.setCacheFile(ResultCache::fileName(config.getConfigDir()));
+            }
+            std::string traceFile;
+            if (config.getUseTrace()) {
+                traceFile = GameTrace::fileName(
+                    config.getConfigDir(), config.getShardIndex(), config.getShardCount());
+                tournament.setTraceFile(traceFile);
+            }
+            std::string resultsFile;
+            if (config.getExportResults()) {
+                resultsFile = ResultsTable::fileName(
+                    config.getConfigDir(), config.getShardIndex(), config.getShardCount());
+                tournament.setResultsFile(resultsFile);
+            }
             
             // Показываем матрицу для турнира
             if (!config.getMatrixFile().empty()) {
@@ -62,15 +390,40 @@ int main(int argc, char* argv[]) {
             }
             
             logger.logTournamentStart(config.getStrategies());
+            std::signal(SIGINT, handleInterrupt);
             tournament.run();
+            std::signal(SIGINT, SIG_DFL);
+            if (tournament.wasInterrupted()) {
+                std::cout << "\nInterrupted. Progress saved to " << checkpointFile
+                          << "; rerun with --resume to continue" << std::endl;
+                return 130;
+            }
             tournament.printResults();
+            if (tournament.getTracedGames() > 0) {
+                std::cout << "\nTrace of " << tournament.getTracedGames() << " games written to "
+                          << traceFile << std::endl;
+            }
+            if (tournament.getExportedRows() > 0) {
+                std::cout << "Results of " << tournament.getExportedRows() << " games written to "
+                          << resultsFile << " and " << ResultsTable::csvFileName(resultsFile) << std::endl;
+            }
+            
+            if (config.getShardCount() > 1) {
+                std::string partialFile = PartialResults::shardFileName(
+                    config.getConfigDir(), config.getShardIndex(), config.getShardCount());
+                if (tournament.getPartialResults().save(partialFile)) {
+                    std::cout << "\nPartial results written to " << partialFile << std::endl;
+                }
+            }
             
             auto tournamentScores = tournament.getScores();
             logger.logTournamentEnd(tournamentScores);
             
         } else {
-            // Обычная игра (3 стратегии)
-            Game game(config.getSteps(), config.getMatrixFile());
+            // Обычная игра (по умолчанию 3 стратегии)
+            Game game(config.getSteps(), config.getMatrixFile(), config.getGroupSize());
+            uint64_t seed = chooseSeed(config);
+            game.setRandomSeed(seed);
             
             // Показываем матрицу игры
             std::cout << "\n=== PRISONER'S DILEMMA ===" << std::endl;
@@ -81,7 +434,7 @@ int main(int argc, char* argv[]) {
             
             // Создаем и добавляем стратегии
             for (const auto& name : config.getStrategies()) {
-                auto strategy = factory.create(name, config.getConfigDir());
+                auto strategy = factory.createSlot(name, config.getConfigDir());
                 if (!strategy) {
                     std::cerr << "Error: Cannot create strategy '" << name << "'" << std::endl;
                     return 1;
@@ -90,16 +443,23 @@ int main(int argc, char* argv[]) {
             }
             
             if (!game.isReady()) {
-                std::cerr << "Error: Game setup failed! Need exactly 3 players." << std::endl;
+                std::cerr << "Error: Game setup failed! Need exactly "
+                          << config.getGroupSize() << " players." << std::endl;
                 return 1;
             }
             
             // Логируем начало игры
-            logger.logGameStart(game.getPlayerNames(), config.getSteps());
+            uint32_t logGame = logger.logGameStart(game.getPlayerNames(), config.getSteps());
+            game.setLogger(&logger, logGame);
+            // Перемотка циклов пропускает раунды, а их просили записать
+            if (config.getLogRounds() > 0) {
+                game.setCycleDetection(false);
+            }
             
             // Информация о игре
             std::cout << "Game mode: " << config.getMode() << std::endl;
             std::cout << "Total rounds: " << config.getSteps() << std::endl;
+            std::cout << "Seed: " << seed << std::endl;
             std::cout << "Players: ";
             auto names = game.getPlayerNames();
             for (const auto& name : names) {
@@ -137,7 +497,7 @@ int main(int argc, char* argv[]) {
             game.printFinalResults();
             
             // Логируем конец игры
-            logger.logGameEnd(game.getPlayerNames(), game.getScores());
+            logger.logGameEnd(game.getPlayerNames(), game.getScores(), logGame);
         }
         
     } catch (const std::exception& e) {
@@ -1,36 +1,39 @@
 #include "strategies/advanced/AdaptiveStrategy.h"
 #include "utils/ConfigFileParser.h"
-#include <chrono>
 #include <algorithm>
 #include <iostream>
+#include <sstream>
 
 AdaptiveStrategy::AdaptiveStrategy()
     : name("AdaptiveStrategy"),
+      initialCooperation(0.7),
       cooperationLevel(0.7),
       learningRate(0.1),
       explorationRate(0.05),
+      explorationThreshold(RandomStream::threshold(0.05)),
       memorySize(10),
       totalCooperate(0),
       totalDefect(0),
       averagePayoff(0.0),
-      rng(std::chrono::system_clock::now().time_since_epoch().count()),
-      dist(0.0, 1.0) {}
+      roundsObserved(0) {}
 
 Move AdaptiveStrategy::makeMove(
-    const std::vector<Move>& ownHistory,
-    const std::vector<std::vector<Move>>& opponentsHistory) {
+    HistoryView ownHistory, OpponentsView opponentsHistory) {
     
     if (ownHistory.empty()) {
         return getRandomMove(cooperationLevel);
     }
     
-    updateStatistics(ownHistory.back());
+    // Без движка onRoundResult не вызывается - свой ход берём из истории
+    if (!opponentStats) {
+        updateStatistics(ownHistory.back());
+    }
     analyzeOpponentsBehavior(opponentsHistory);
     
     Move decision = decideMove(ownHistory, opponentsHistory);
     
     if (shouldExplore()) {
-        return getRandomMove(0.5);
+        return random().nextBit() ? Move::DEFECT : Move::COOPERATE;
     }
     
     return decision;
@@ -51,7 +54,9 @@ void AdaptiveStrategy::loadConfig(const std::string& configDir) {
         cooperationLevel = std::max(0.0, std::min(1.0, cooperationLevel));
         learningRate = std::max(0.0, std::min(1.0, learningRate));
         explorationRate = std::max(0.0, std::min(1.0, explorationRate));
+        explorationThreshold = RandomStream::threshold(explorationRate);
         memorySize = std::max(1, memorySize);
+        initialCooperation = cooperationLevel;
         
         std::cout << "AdaptiveStrategy: Loaded configuration '" << name << "'" << std::endl;
         std::cout << "  Initial cooperation: " << cooperationLevel << std::endl;
@@ -61,9 +66,46 @@ void AdaptiveStrategy::loadConfig(const std::string& configDir) {
     }
 }
 
+void AdaptiveStrategy::reset() {
+    cooperationLevel = initialCooperation;
+    recentPayoffs.clear();
+    totalCooperate = 0;
+    totalDefect = 0;
+    averagePayoff = 0.0;
+    roundsObserved = 0;
+}
+
+std::string AdaptiveStrategy::getConfigSignature() const {
+    std::ostringstream signature;
+    signature.precision(17);
+    signature << "adaptive|" << name << "|" << initialCooperation << "|" << learningRate << "|"
+              << explorationRate << "|" << memorySize;
+    return signature.str();
+}
+
+void AdaptiveStrategy::onRoundResult(const std::vector<Move>& moves,
+                                     const std::vector<int>& payoffs,
+                                     int round) {
+    updateStatistics(moves[0]);
+    
+    // Скользящее окно и средний выигрыш за всю игру
+    recentPayoffs.push_back(payoffs[0]);
+    if (recentPayoffs.size() > static_cast<size_t>(memorySize)) {
+        recentPayoffs.pop_front();
+    }
+    roundsObserved++;
+    averagePayoff += (payoffs[0] - averagePayoff) / roundsObserved;
+}
+
+double AdaptiveStrategy::getRecentAveragePayoff() const {
+    if (recentPayoffs.empty()) return 0.0;
+    double sum = 0.0;
+    for (double payoff : recentPayoffs) sum += payoff;
+    return sum / recentPayoffs.size();
+}
 
 Move AdaptiveStrategy::getRandomMove(double cooperateProbability) {
-    return (dist(rng) < cooperateProbability) ? Move::COOPERATE : Move::DEFECT;
+    return random().bernoulli(cooperateProbability) ? Move::COOPERATE : Move::DEFECT;
 }
 
 void AdaptiveStrategy::updateStatistics(Move lastMove) {
@@ -74,7 +116,7 @@ void AdaptiveStrategy::updateStatistics(Move lastMove) {
     }
 }
 
-void AdaptiveStrategy::analyzeOpponentsBehavior(const std::vector<std::vector<Move>>& opponentsHistory) {
+void AdaptiveStrategy::analyzeOpponentsBehavior(OpponentsView opponentsHistory) {
     if (opponentsHistory.empty()) return;
     
     double opponentCooperationRate = calculateOpponentCooperationRate(opponentsHistory);
@@ -84,33 +126,26 @@ void AdaptiveStrategy::analyzeOpponentsBehavior(const std::vector<std::vector<Mo
     cooperationLevel = std::max(0.1, std::min(0.9, cooperationLevel));
 }
 
-double AdaptiveStrategy::calculateOpponentCooperationRate(const std::vector<std::vector<Move>>& opponentsHistory) {
-    int totalMoves = 0;
-    int cooperateMoves = 0;
+double AdaptiveStrategy::calculateOpponentCooperationRate(OpponentsView opponentsHistory) {
+    // Движок ведёт счётчики в окне размера memorySize
+    if (opponentStats) {
+        return opponentStats->getWindowCooperationRate(0.5);
+    }
     
+    size_t totalMoves = 0;
+    size_t cooperateMoves = 0;
+    
+    // Окно из последних memorySize ходов считается через popcount
     for (const auto& history : opponentsHistory) {
-        if (history.size() > static_cast<size_t>(memorySize)) {
-            for (size_t i = history.size() - memorySize; i < history.size(); ++i) {
-                totalMoves++;
-                if (history[i] == Move::COOPERATE) {
-                    cooperateMoves++;
-                }
-            }
-        } else {
-            for (const auto& move : history) {
-                totalMoves++;
-                if (move == Move::COOPERATE) {
-                    cooperateMoves++;
-                }
-            }
-        }
+        size_t window = std::min(history.size(), static_cast<size_t>(memorySize));
+        totalMoves += window;
+        cooperateMoves += history.countCooperations(history.size() - window, history.size());
     }
     
     return (totalMoves > 0) ? static_cast<double>(cooperateMoves) / totalMoves : 0.5;
 }
 
-Move AdaptiveStrategy::decideMove(const std::vector<Move>& ownHistory,
-                                  const std::vector<std::vector<Move>>& opponentsHistory) {
+Move AdaptiveStrategy::decideMove(HistoryView ownHistory, OpponentsView opponentsHistory) {
     
     double defectRate = calculateOpponentDefectRate(opponentsHistory);
     if (defectRate > 0.7) {
@@ -124,22 +159,22 @@ Move AdaptiveStrategy::decideMove(const std::vector<Move>& ownHistory,
     return getRandomMove(cooperationLevel);
 }
 
-double AdaptiveStrategy::calculateOpponentDefectRate(const std::vector<std::vector<Move>>& opponentsHistory) {
-    int totalMoves = 0;
-    int defectMoves = 0;
+double AdaptiveStrategy::calculateOpponentDefectRate(OpponentsView opponentsHistory) {
+    if (opponentStats) {
+        return opponentStats->getDefectRate(0.0);
+    }
+    
+    size_t totalMoves = 0;
+    size_t defectMoves = 0;
     
     for (const auto& history : opponentsHistory) {
-        for (const auto& move : history) {
-            totalMoves++;
-            if (move == Move::DEFECT) {
-                defectMoves++;
-            }
-        }
+        totalMoves += history.size();
+        defectMoves += history.countDefections();
     }
     
     return (totalMoves > 0) ? static_cast<double>(defectMoves) / totalMoves : 0.0;
 }
 
 bool AdaptiveStrategy::shouldExplore() {
-    return dist(rng) < explorationRate;
+    return random().bernoulliThreshold(explorationThreshold);
 }
@@ -5,48 +5,56 @@
 #include "utils/ConfigFileParser.h"
 #include <string>
 #include <vector>
-#include <random>
+#include <deque>
 
-class AdaptiveStrategy : public Strategy {
+class AdaptiveStrategy final : public Strategy {
 private:
     std::string name;
+    double initialCooperation;
     double cooperationLevel;
     double learningRate;
     double explorationRate;
+    uint64_t explorationThreshold;   // RandomStream::threshold(explorationRate)
     int memorySize;
-    std::vector<double> recentPayoffs;
+    std::deque<double> recentPayoffs;
     
     int totalCooperate;
     int totalDefect;
     double averagePayoff;
-    
-    std::mt19937 rng;
-    std::uniform_real_distribution<double> dist;
+    int roundsObserved;
     
     Move getRandomMove(double cooperateProbability);
     void updateStatistics(Move lastMove);
-    void analyzeOpponentsBehavior(const std::vector<std::vector<Move>>& opponentsHistory);
-    double calculateOpponentCooperationRate(const std::vector<std::vector<Move>>& opponentsHistory);
-    Move decideMove(const std::vector<Move>& ownHistory,
-                    const std::vector<std::vector<Move>>& opponentsHistory);
-    double calculateOpponentDefectRate(const std::vector<std::vector<Move>>& opponentsHistory);
+    void analyzeOpponentsBehavior(OpponentsView opponentsHistory);
+    double calculateOpponentCooperationRate(OpponentsView opponentsHistory);
+    Move decideMove(HistoryView ownHistory, OpponentsView opponentsHistory);
+    double calculateOpponentDefectRate(OpponentsView opponentsHistory);
     bool shouldExplore();
     
 public:
     AdaptiveStrategy();
     ~AdaptiveStrategy() override = default;
     
-    Move makeMove(const std::vector<Move>& ownHistory,
-                  const std::vector<std::vector<Move>>& opponentsHistory) override;
+    using Strategy::makeMove;
+    Move makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) override;
     
     std::string getName() const override { return name; }
     
     void loadConfig(const std::string& configDir) override;
+    std::unique_ptr<Strategy> clone() const override { return std::make_unique<AdaptiveStrategy>(*this); }
+    void reset() override;
+    std::string getConfigSignature() const override;
+    
+    void onRoundResult(const std::vector<Move>& moves,
+                       const std::vector<int>& payoffs,
+                       int round) override;
+    size_t getStatsWindowSize() const override { return static_cast<size_t>(memorySize); }
     
     double getCooperationLevel() const { return cooperationLevel; }
     int getTotalCooperate() const { return totalCooperate; }
     int getTotalDefect() const { return totalDefect; }
     double getAveragePayoff() const { return averagePayoff; }
+    double getRecentAveragePayoff() const;
 };
 
 #endif
\ No newline at end of file
@@ -1,16 +1,11 @@
 #include "strategies/advanced/FiftyFifty.h"
 #include "utils/ConfigFileParser.h"
-#include <cstdlib>
-#include <ctime>
 #include <iostream>
 #include <fstream>
 
-FiftyFifty::FiftyFifty() : name("FiftyFifty"), lastMoveRandom(false), firstMove('C') {
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
-}
+FiftyFifty::FiftyFifty() : name("FiftyFifty"), lastMoveRandom(false), firstMove('C') {}
 
-Move FiftyFifty::makeMove(const std::vector<Move>& ownHistory,
-                          const std::vector<std::vector<Move>>& opponentsHistory) {
+Move FiftyFifty::makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) {
     
     if (ownHistory.empty()) {
         lastMoveRandom = true;
@@ -42,6 +37,15 @@ void FiftyFifty::loadConfig(const std::string& configDir) {
     }
 }
 
+bool FiftyFifty::getMemoryOneResponse(MemoryOneResponse& response) const {
+    response.initial = (firstMove == 'C') ? 1.0 : 0.0;
+    // Противоположный своему прошлому ходу
+    for (int outcome = 0; outcome < 8; ++outcome) {
+        response.afterOutcome[outcome] = (outcome & 4) ? 1.0 : 0.0;
+    }
+    return true;
+}
+
 bool FiftyFifty::isLastMoveRandom() const {
     return lastMoveRandom;
 }
\ No newline at end of file
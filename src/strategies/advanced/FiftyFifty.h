@@ -5,7 +5,7 @@
 #include <vector>
 #include <string>
 
-class FiftyFifty : public Strategy {
+class FiftyFifty final : public Strategy {
 private:
     std::string name;
     bool lastMoveRandom;
@@ -14,12 +14,18 @@ private:
 public:
     FiftyFifty();
     
-    Move makeMove(const std::vector<Move>& ownHistory,
-                  const std::vector<std::vector<Move>>& opponentsHistory) override;
+    using Strategy::makeMove;
+    Move makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) override;
     
     std::string getName() const override;
     
     void loadConfig(const std::string& configDir) override;
+    std::unique_ptr<Strategy> clone() const override { return std::make_unique<FiftyFifty>(*this); }
+    void reset() override { lastMoveRandom = false; }
+    std::string getConfigSignature() const override { return "fiftyfifty|" + name + "|" + firstMove; }
+    // Ход зависит только от своего последнего хода
+    bool getStateSignature(uint64_t& signature) const override { signature = 0; return true; }
+    bool getMemoryOneResponse(MemoryOneResponse& response) const override;
     
     bool isLastMoveRandom() const;
 };
@@ -0,0 +1,227 @@
+#include "strategies/advanced/TableStrategy.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+TableStrategy::TableStrategy()
+    : name("TableStrategy"),
+      kind(Kind::TABLE),
+      memory(1),
+      mask(7),
+      startState(0),
+      state(0),
+      observedRounds(0),
+      initialMoves{Move::COOPERATE},
+      actions(8, Move::COOPERATE) {
+    // По умолчанию: предать, если в прошлом раунде предал хотя бы один соперник
+    for (uint32_t outcome = 0; outcome < 8; ++outcome) {
+        if (outcome & 3) actions[outcome] = Move::DEFECT;
+    }
+}
+
+uint32_t TableStrategy::lastOutcome(HistoryView ownHistory, OpponentsView opponentsHistory,
+                                    size_t round) {
+    // Для игр не на троих учитываются первые два соперника
+    uint32_t outcome = static_cast<uint32_t>(ownHistory[round]) << 2;
+    if (opponentsHistory.size() > 0 && round < opponentsHistory[0].size()) {
+        outcome |= static_cast<uint32_t>(opponentsHistory[0][round]) << 1;
+    }
+    if (opponentsHistory.size() > 1 && round < opponentsHistory[1].size()) {
+        outcome |= static_cast<uint32_t>(opponentsHistory[1][round]);
+    }
+    return outcome;
+}
+
+uint32_t TableStrategy::step(uint32_t current, uint32_t outcome) const {
+    if (kind == Kind::TABLE) {
+        return ((current << 3) | outcome) & mask;
+    }
+    return transitions[current * 4 + (outcome & 3)];
+}
+
+void TableStrategy::resync(HistoryView ownHistory, OpponentsView opponentsHistory) {
+    // Восстанавливаем состояние по истории (вызов вне обычного порядка раундов)
+    size_t rounds = ownHistory.size();
+    size_t from = 0;
+    if (kind == Kind::TABLE && rounds > static_cast<size_t>(memory)) {
+        from = rounds - memory;
+    }
+
+    state = startState;
+    for (size_t round = from; round < rounds; ++round) {
+        state = step(state, lastOutcome(ownHistory, opponentsHistory, round));
+    }
+    observedRounds = rounds;
+}
+
+Move TableStrategy::makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) {
+    size_t round = ownHistory.size();
+
+    if (round == observedRounds + 1) {
+        state = step(state, lastOutcome(ownHistory, opponentsHistory, round - 1));
+        observedRounds = round;
+    } else if (round != observedRounds) {
+        resync(ownHistory, opponentsHistory);
+    }
+
+    if (round < initialMoves.size() && kind == Kind::TABLE) {
+        return initialMoves[round];
+    }
+    return actions[state];
+}
+
+bool TableStrategy::getStateSignature(uint64_t& signature) const {
+    // Пока идут начальные ходы, важен и номер раунда
+    uint64_t warmup = std::min<uint64_t>(observedRounds, static_cast<uint64_t>(memory));
+    signature = (warmup << 32) | state;
+    return true;
+}
+
+bool TableStrategy::getMemoryOneResponse(MemoryOneResponse& response) const {
+    if (kind != Kind::TABLE || memory != 1) {
+        return false;
+    }
+    
+    response.initial = (initialMoves[0] == Move::COOPERATE) ? 1.0 : 0.0;
+    for (uint32_t outcome = 0; outcome < 8; ++outcome) {
+        response.afterOutcome[outcome] = (actions[outcome] == Move::COOPERATE) ? 1.0 : 0.0;
+    }
+    return true;
+}
+
+bool TableStrategy::parseMoves(const std::string& text, std::vector<Move>& moves) {
+    moves.clear();
+    for (char c : text) {
+        if (std::isspace(static_cast<unsigned char>(c)) || c == ',') continue;
+        char upper = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        if (upper != 'C' && upper != 'D') return false;
+        moves.push_back(charToMove(upper));
+    }
+    return !moves.empty();
+}
+
+bool TableStrategy::parseTable(const ConfigFileParser& config) {
+    int depth = config.getInt("memory", 1);
+    if (depth < 1 || depth > MAX_MEMORY) {
+        std::cerr << "Warning: table memory must be in 1.." << MAX_MEMORY << std::endl;
+        return false;
+    }
+
+    size_t size = size_t(1) << (3 * depth);
+    std::vector<Move> table;
+    if (!parseMoves(config.getString("table"), table) || table.size() != size) {
+        std::cerr << "Warning: table must contain " << size << " C/D entries" << std::endl;
+        return false;
+    }
+
+    // Ходы первых раундов: недостающие повторяют последний указанный
+    std::vector<Move> initial;
+    if (!parseMoves(config.getString("initial", "C"), initial)) {
+        std::cerr << "Warning: invalid initial moves" << std::endl;
+        return false;
+    }
+    initial.resize(depth, initial.back());
+
+    kind = Kind::TABLE;
+    memory = depth;
+    mask = static_cast<uint32_t>(size - 1);
+    startState = 0;
+    actions = std::move(table);
+    initialMoves = std::move(initial);
+    transitions.clear();
+    return true;
+}
+
+bool TableStrategy::parseMachine(const ConfigFileParser& config) {
+    int states = config.getInt("states", 0);
+    int start = config.getInt("start", 0);
+    if (states < 1 || start < 0 || start >= states) {
+        std::cerr << "Warning: invalid FSM states/start" << std::endl;
+        return false;
+    }
+
+    std::vector<Move> moves;
+    if (!parseMoves(config.getString("moves"), moves) || moves.size() != static_cast<size_t>(states)) {
+        std::cerr << "Warning: FSM moves must contain " << states << " C/D entries" << std::endl;
+        return false;
+    }
+
+    std::string text = config.getString("transitions");
+    std::replace(text.begin(), text.end(), ',', ' ');
+    std::istringstream iss(text);
+    std::vector<uint32_t> next;
+    long long value;
+    while (iss >> value) {
+        if (value < 0 || value >= states) {
+            std::cerr << "Warning: FSM transition to unknown state " << value << std::endl;
+            return false;
+        }
+        next.push_back(static_cast<uint32_t>(value));
+    }
+    if (!iss.eof() || next.size() != static_cast<size_t>(states) * 4) {
+        std::cerr << "Warning: FSM transitions must contain " << states * 4 << " states" << std::endl;
+        return false;
+    }
+
+    kind = Kind::FSM;
+    memory = 0;
+    mask = 0;
+    startState = static_cast<uint32_t>(start);
+    actions = std::move(moves);
+    initialMoves.clear();
+    transitions = std::move(next);
+    return true;
+}
+
+bool TableStrategy::loadFromFile(const std::string& filename) {
+    ConfigFileParser config;
+    if (!config.load(filename)) {
+        return false;
+    }
+    if (!isTableConfig(config)) {
+        std::cerr << "Warning: " << filename << " is not a table strategy" << std::endl;
+        return false;
+    }
+    return loadFromConfig(config, std::filesystem::path(filename).stem().string());
+}
+
+bool TableStrategy::loadFromConfig(const ConfigFileParser& config, const std::string& defaultName) {
+    std::string type = config.getString("type");
+    std::transform(type.begin(), type.end(), type.begin(), ::tolower);
+
+    bool ok = (type == "fsm") ? parseMachine(config) : parseTable(config);
+    if (!ok) return false;
+
+    name = config.getString("name", defaultName);
+    reset();
+    return true;
+}
+
+void TableStrategy::reset() {
+    state = startState;
+    observedRounds = 0;
+}
+
+std::string TableStrategy::getConfigSignature() const {
+    std::ostringstream signature;
+    signature << (kind == Kind::TABLE ? "table|" : "fsm|") << name << "|" << memory << "|" << startState << "|";
+    for (Move move : initialMoves) signature << moveToChar(move);
+    signature << "|";
+    for (Move move : actions) signature << moveToChar(move);
+    signature << "|";
+    for (uint32_t next : transitions) signature << next << ",";
+    return signature.str();
+}
+
+bool TableStrategy::loadFromDir(const std::string& configDir, const std::string& strategyName) {
+    if (configDir.empty() || strategyName.empty()) return false;
+    return loadFromFile(configDir + "/" + strategyName + ".cfg");
+}
+
+bool TableStrategy::isTableConfig(const ConfigFileParser& config) {
+    std::string type = config.getString("type");
+    std::transform(type.begin(), type.end(), type.begin(), ::tolower);
+    return type == "table" || type == "fsm";
+}
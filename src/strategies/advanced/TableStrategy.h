@@ -0,0 +1,80 @@
+#ifndef TABLESTRATEGY_H
+#define TABLESTRATEGY_H
+
+#include "core/Strategy.h"
+#include "utils/ConfigFileParser.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Табличная стратегия, описываемая файлом <configDir>/<name>.cfg.
+//
+// type=table - ход по последним memory раундам всех трёх игроков:
+//   memory=1                  # глубина памяти (1..MAX_MEMORY)
+//   initial=C                 # ходы первых memory раундов (последний символ повторяется)
+//   table=CDDDDDDD            # 8^memory символов C/D
+// Исход раунда - 3 бита (свой ход << 2 | соперник1 << 1 | соперник2), D = 1.
+// Индекс таблицы - исходы последних раундов, самый свежий в младших битах.
+//
+// type=fsm - конечный автомат:
+//   states=2
+//   start=0
+//   moves=CD                  # ход в каждом состоянии
+//   transitions=0,1,1,1,1,1,1,1   # states*4 переходов: state*4 + (соперник1 << 1 | соперник2)
+//
+// Раунд стоит одного обращения к таблице, без аллокаций.
+class TableStrategy final : public Strategy {
+public:
+    enum class Kind {TABLE, FSM};
+    static constexpr int MAX_MEMORY = 5;
+
+private:
+    std::string name;
+    Kind kind;
+    int memory;
+    uint32_t mask;
+    uint32_t startState;
+    uint32_t state;
+    size_t observedRounds;
+    std::vector<Move> initialMoves;
+    std::vector<Move> actions;        // ход по индексу/состоянию
+    std::vector<uint32_t> transitions; // только для FSM
+
+    static uint32_t lastOutcome(HistoryView ownHistory, OpponentsView opponentsHistory,
+                                size_t round);
+    uint32_t step(uint32_t current, uint32_t outcome) const;
+    void resync(HistoryView ownHistory, OpponentsView opponentsHistory);
+    static bool parseMoves(const std::string& text, std::vector<Move>& moves);
+    bool parseTable(const ConfigFileParser& config);
+    bool parseMachine(const ConfigFileParser& config);
+
+public:
+    TableStrategy();
+    ~TableStrategy() override = default;
+
+    // Загружает описание из <configDir>/<strategyName>.cfg. Без name=
+    // стратегия называется по имени файла без расширения.
+    bool loadFromDir(const std::string& configDir, const std::string& strategyName);
+    bool loadFromFile(const std::string& filename);
+    // Из уже разобранного файла; defaultName - имя, если нет name=
+    bool loadFromConfig(const ConfigFileParser& config, const std::string& defaultName);
+    // true, если файл описывает табличную стратегию (type=table|fsm)
+    static bool isTableConfig(const ConfigFileParser& config);
+
+    using Strategy::makeMove;
+    Move makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) override;
+
+    std::string getName() const override { return name; }
+    std::unique_ptr<Strategy> clone() const override { return std::make_unique<TableStrategy>(*this); }
+    void reset() override;
+    std::string getConfigSignature() const override;
+    bool getStateSignature(uint64_t& signature) const override;
+    // Только таблицы с памятью 1
+    bool getMemoryOneResponse(MemoryOneResponse& response) const override;
+
+    Kind getKind() const { return kind; }
+    int getMemory() const { return memory; }
+    size_t getTableSize() const { return actions.size(); }
+};
+
+#endif
@@ -1,16 +1,14 @@
 #include "strategies/advanced/TitForTat.h"
-#include <chrono>
+#include <sstream>
 
 TitForTat::TitForTat() 
     : name("TitForTat"),
       firstMove(Move::COOPERATE),
       useForgiveness(true),
       forgivenessProbability(0.1),
-      rng(std::chrono::system_clock::now().time_since_epoch().count()),
-      dist(0.0, 1.0) {}
+      forgivenessThreshold(RandomStream::threshold(0.1)) {}
 
-Move TitForTat::makeMove(const std::vector<Move>& ownHistory,
-                        const std::vector<std::vector<Move>>& opponentsHistory) {
+Move TitForTat::makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) {
     if (ownHistory.empty()) {
         return firstMove;
     }
@@ -41,6 +39,7 @@ void TitForTat::loadConfig(const std::string& configDir) {
         // Ограничиваем вероятность
         if (forgivenessProbability < 0.0) forgivenessProbability = 0.0;
         if (forgivenessProbability > 1.0) forgivenessProbability = 1.0;
+        forgivenessThreshold = RandomStream::threshold(forgivenessProbability);
         
         std::cout << "TitForTat: Loaded configuration '" << name << "'" << std::endl;
         std::cout << "  First move: " << moveToChar(firstMove) << std::endl;
@@ -49,7 +48,7 @@ void TitForTat::loadConfig(const std::string& configDir) {
     }
 }
 
-Move TitForTat::analyzeOpponentsLastMoves(const std::vector<std::vector<Move>>& opponentsHistory) {
+Move TitForTat::analyzeOpponentsLastMoves(OpponentsView opponentsHistory) {
     if (opponentsHistory.empty()) {
         return Move::COOPERATE;
     }
@@ -73,6 +72,36 @@ Move TitForTat::analyzeOpponentsLastMoves(const std::vector<std::vector<Move>>&
     return (defectCount > totalOpponents / 2) ? Move::DEFECT : Move::COOPERATE;
 }
 
+std::string TitForTat::getConfigSignature() const {
+    std::ostringstream signature;
+    signature.precision(17);
+    signature << "titfortat|" << name << "|" << moveToChar(firstMove) << "|"
+              << useForgiveness << "|" << forgivenessProbability;
+    return signature.str();
+}
+
+bool TitForTat::getStateSignature(uint64_t& signature) const {
+    // Без прощения ход зависит только от последних ходов соперников
+    if (useForgiveness && forgivenessProbability > 0.0) {
+        return false;
+    }
+    signature = 0;
+    return true;
+}
+
+bool TitForTat::getMemoryOneResponse(MemoryOneResponse& response) const {
+    response.initial = (firstMove == Move::COOPERATE) ? 1.0 : 0.0;
+    double forgiveness = useForgiveness ? forgivenessProbability : 0.0;
+    
+    // Предательство в ответ на предательство большинства (обоих) соперников,
+    // которое прощается с вероятностью forgivenessProbability
+    for (int outcome = 0; outcome < 8; ++outcome) {
+        bool retaliate = (outcome & 3) == 3;
+        response.afterOutcome[outcome] = retaliate ? forgiveness : 1.0;
+    }
+    return true;
+}
+
 bool TitForTat::shouldForgive() {
-    return dist(rng) < forgivenessProbability;
+    return random().bernoulliThreshold(forgivenessThreshold);
 }
\ No newline at end of file
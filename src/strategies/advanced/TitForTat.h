@@ -5,31 +5,33 @@
 #include "utils/ConfigFileParser.h"
 #include <vector>
 #include <algorithm>
-#include <random>
 #include <iostream>
 
-class TitForTat : public Strategy {
+class TitForTat final : public Strategy {
 private:
     std::string name;
     Move firstMove;
     bool useForgiveness;
     double forgivenessProbability;
-    std::mt19937 rng;
-    std::uniform_real_distribution<double> dist;
+    uint64_t forgivenessThreshold;   // RandomStream::threshold(forgivenessProbability)
     
-    Move analyzeOpponentsLastMoves(const std::vector<std::vector<Move>>& opponentsHistory);
+    Move analyzeOpponentsLastMoves(OpponentsView opponentsHistory);
     bool shouldForgive();
     
 public:
     TitForTat();
     ~TitForTat() override = default;
     
-    Move makeMove(const std::vector<Move>& ownHistory,
-                  const std::vector<std::vector<Move>>& opponentsHistory) override;
+    using Strategy::makeMove;
+    Move makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) override;
     
     std::string getName() const override { return name; }
     
     void loadConfig(const std::string& configDir) override;
+    std::unique_ptr<Strategy> clone() const override { return std::make_unique<TitForTat>(*this); }
+    std::string getConfigSignature() const override;
+    bool getStateSignature(uint64_t& signature) const override;
+    bool getMemoryOneResponse(MemoryOneResponse& response) const override;
 };
 
 #endif
\ No newline at end of file
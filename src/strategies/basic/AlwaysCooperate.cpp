@@ -1,10 +1,18 @@
 #include "strategies/basic/AlwaysCooperate.h"
+#include <algorithm>
+#include <iterator>
 #include <string>
 
-Move AlwaysCooperate::makeMove(const std::vector<Move>& ownHistory, const std::vector<std::vector<Move>>& opponentsHistory) {
+Move AlwaysCooperate::makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) {
     return Move::COOPERATE;
 }
 
 std::string AlwaysCooperate::getName() const {
     return "AlwaysCooperate";
-}
\ No newline at end of file
+}
+
+bool AlwaysCooperate::getMemoryOneResponse(MemoryOneResponse& response) const {
+    response.initial = 1.0;
+    std::fill(std::begin(response.afterOutcome), std::end(response.afterOutcome), 1.0);
+    return true;
+}
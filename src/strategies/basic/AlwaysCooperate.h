@@ -3,10 +3,14 @@
 
 #include "core/Strategy.h"
 
-class AlwaysCooperate : public Strategy {
+class AlwaysCooperate final : public Strategy {
 public:
-    Move makeMove(const std::vector<Move>& ownHistory, const std::vector<std::vector<Move>>& opponentsHistory) override;
+    using Strategy::makeMove;
+    Move makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) override;
     std::string getName() const override;
+    std::unique_ptr<Strategy> clone() const override { return std::make_unique<AlwaysCooperate>(*this); }
+    bool getStateSignature(uint64_t& signature) const override { signature = 0; return true; }
+    bool getMemoryOneResponse(MemoryOneResponse& response) const override;
 };
 
 #endif
\ No newline at end of file
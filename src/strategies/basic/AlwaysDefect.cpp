@@ -1,10 +1,18 @@
 #include "strategies/basic/AlwaysDefect.h"
+#include <algorithm>
+#include <iterator>
 #include <string>
 
-Move AlwaysDefect::makeMove(const std::vector<Move>& ownHistory, const std::vector<std::vector<Move>>& opponentsHistory) {
+Move AlwaysDefect::makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) {
     return Move::DEFECT;
 }
 
 std::string AlwaysDefect::getName() const {
     return "AlwaysDefect";
-}
\ No newline at end of file
+}
+
+bool AlwaysDefect::getMemoryOneResponse(MemoryOneResponse& response) const {
+    response.initial = 0.0;
+    std::fill(std::begin(response.afterOutcome), std::end(response.afterOutcome), 0.0);
+    return true;
+}
@@ -1,17 +1,20 @@
 #include "strategies/basic/Random.h"
-#include <cstdlib>
-#include <ctime>
 #include <string>
+#include <algorithm>
+#include <iterator>
 
-RandomStrategy::RandomStrategy() {
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
-}
+RandomStrategy::RandomStrategy() {}
 
-Move RandomStrategy::makeMove(const std::vector<Move>& ownHistory,
-                              const std::vector<std::vector<Move>>& opponentsHistory) {
-    return (std::rand() % 2 == 0) ? Move::COOPERATE : Move::DEFECT;
+Move RandomStrategy::makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) {
+    return random().nextBit() ? Move::DEFECT : Move::COOPERATE;
 }
 
 std::string RandomStrategy::getName() const {
     return "RandomStrategy";
-}
\ No newline at end of file
+}
+
+bool RandomStrategy::getMemoryOneResponse(MemoryOneResponse& response) const {
+    response.initial = 0.5;
+    std::fill(std::begin(response.afterOutcome), std::end(response.afterOutcome), 0.5);
+    return true;
+}
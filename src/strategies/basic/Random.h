@@ -5,14 +5,16 @@
 #include <vector>
 #include <string>
 
-class RandomStrategy : public Strategy {
+class RandomStrategy final : public Strategy {
 public:
     RandomStrategy();
     
-    Move makeMove(const std::vector<Move>& ownHistory,
-                  const std::vector<std::vector<Move>>& opponentsHistory) override;
+    using Strategy::makeMove;
+    Move makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) override;
     
     std::string getName() const override;
+    std::unique_ptr<Strategy> clone() const override { return std::make_unique<RandomStrategy>(*this); }
+    bool getMemoryOneResponse(MemoryOneResponse& response) const override;
 };
 
 #endif
\ No newline at end of file
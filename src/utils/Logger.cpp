@@ -6,137 +6,322 @@
 #include <map>
 #include <algorithm>
 
-Logger::Logger(const std::string& configDir) : enabled(true) {
-    if (!configDir.empty()) {
-        logPath = configDir + "/game_log.txt";
-        logFile.open(logPath, std::ios::app);
-        if (!logFile.is_open()) {
-            std::cerr << "Warning: Cannot open log file at " << logPath << std::endl;
-            enabled = false;
-        }
-    } else {
-        enabled = false;
+namespace {
+    int64_t secondsNow() {
+        return static_cast<int64_t>(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
     }
+
+    // Пачка уходит в файл не реже, чем набирается столько байт
+    const size_t BATCH_BYTES = 1 << 16;
+    const auto WRITER_PERIOD = std::chrono::milliseconds(10);
+}
+
+Logger::Logger(const std::string& configDir, size_t requestedCapacity)
+    : enabled(false),
+      capacity(2),
+      tail(0),
+      head(0),
+      processed(0),
+      droppedRounds(0),
+      coarseTime(secondsNow()),
+      nextGame(1),
+      roundSampling(0),
+      dropPolicy(DropPolicy::DROP),
+      stopping(false),
+      stampTime(-1),
+      reportedDrops(0) {
+    if (configDir.empty()) return;
+
+    logPath = configDir + "/game_log.txt";
+    logFile.open(logPath, std::ios::app);
+    if (!logFile.is_open()) {
+        std::cerr << "Warning: Cannot open log file at " << logPath << std::endl;
+        return;
+    }
+
+    // Степень двойки: номер ячейки - младшие биты позиции
+    while (capacity < requestedCapacity) capacity <<= 1;
+    slots.reset(new Slot[capacity]);
+    for (size_t i = 0; i < capacity; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    enabled = true;
+    writer = std::thread(&Logger::writerLoop, this);
 }
 
 Logger::~Logger() {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+    }
     if (logFile.is_open()) {
         logFile.close();
     }
 }
 
-void Logger::logRound(int round, 
-                      const std::vector<std::string>& playerNames,
-                      const std::vector<Move>& moves,
-                      const std::vector<int>& roundScores,
-                      const std::vector<int>& totalScores) {
-    if (!enabled) return;
-    
-    logFile << getTimestamp() << " | Round " << round << " | ";
-    
-    for (size_t i = 0; i < playerNames.size(); ++i) {
-        logFile << playerNames[i] << "=" << moveToString(moves[i]) 
-                << "(" << roundScores[i] << ") ";
+Logger::Slot* Logger::claim(bool wait, uint64_t& position) {
+    position = tail.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots[position & (capacity - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        int64_t lag = static_cast<int64_t>(sequence - position);
+        if (lag == 0) {
+            if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                return &slot;
+            }
+        } else if (lag < 0) {
+            // Буфер полон: ячейку ещё не разобрал фоновый поток
+            if (!wait) return nullptr;
+            wake.notify_one();
+            std::this_thread::yield();
+            position = tail.load(std::memory_order_relaxed);
+        } else {
+            position = tail.load(std::memory_order_relaxed);
+        }
     }
-    
-    logFile << "| Total: ";
-    for (size_t i = 0; i < playerNames.size(); ++i) {
-        logFile << playerNames[i] << "=" << totalScores[i];
-        if (i < playerNames.size() - 1) logFile << ", ";
+}
+
+void Logger::pushRound(uint32_t game, int round, const std::vector<Move>& moves,
+                       const std::vector<int>& roundScores, const std::vector<long long>& totalScores) {
+    uint64_t position;
+    Slot* slot = claim(dropPolicy == DropPolicy::BLOCK, position);
+    if (!slot) {
+        droppedRounds.fetch_add(1, std::memory_order_relaxed);
+        return;
     }
-    
-    logFile << std::endl;
+
+    Record& record = slot->record;
+    size_t seats = std::min<size_t>(moves.size(), MAX_SEATS);
+    record.type = ROUND;
+    record.seats = static_cast<uint8_t>(seats);
+    record.game = game;
+    record.time = coarseTime.load(std::memory_order_relaxed);
+    record.round = round;
+    record.defections = 0;
+    for (size_t i = 0; i < seats; ++i) {
+        record.defections |= static_cast<uint64_t>(moves[i] == Move::DEFECT) << i;
+        record.roundData.roundScores[i] = roundScores[i];
+        record.roundData.totals[i] = totalScores[i];
+    }
+    publish(slot, position);
 }
 
-void Logger::logGameStart(const std::vector<std::string>& playerNames, int totalRounds) {
-    if (!enabled) return;
-    
-    logFile << "\n" << std::string(60, '=') << std::endl;
-    logFile << getTimestamp() << " | GAME STARTED" << std::endl;
-    logFile << "Players: ";
+void Logger::pushMessage(RecordType type, std::string text, size_t stampOffset,
+                         uint32_t game, std::vector<std::string>* names) {
+    uint64_t position;
+    Slot* slot = claim(true, position);
+
+    Record& record = slot->record;
+    record.type = type;
+    record.seats = 0;
+    record.game = game;
+    record.time = coarseTime.load(std::memory_order_relaxed);
+    record.round = 0;
+    record.defections = 0;
+    record.message.text = new std::string(std::move(text));
+    record.message.names = names;
+    record.message.stampOffset = stampOffset;
+    publish(slot, position);
+}
+
+void Logger::writerLoop() {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    for (;;) {
+        // Флаг читается до разбора: всё опубликованное до остановки
+        // будет записано
+        bool stop = stopping;
+        lock.unlock();
+
+        coarseTime.store(secondsNow(), std::memory_order_relaxed);
+        drain();
+        writeBatch();
+
+        lock.lock();
+        if (stop) break;
+        wake.wait_for(lock, WRITER_PERIOD);
+    }
+}
+
+void Logger::drain() {
+    for (;;) {
+        Slot& slot = slots[head & (capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) break;
+
+        format(slot.record);
+        slot.sequence.store(head + capacity, std::memory_order_release);
+        ++head;
+        if (batch.size() >= BATCH_BYTES) writeBatch();
+    }
+}
+
+const std::string& Logger::timestamp(int64_t time) {
+    // localtime и strftime - раз в секунду журнала
+    if (time != stampTime) {
+        std::time_t value = static_cast<std::time_t>(time);
+        char buffer[80];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", std::localtime(&value));
+        stamp = buffer;
+        stampTime = time;
+    }
+    return stamp;
+}
+
+void Logger::format(Record& record) {
+    if (record.type != ROUND) {
+        std::string* text = record.message.text;
+        size_t offset = std::min(record.message.stampOffset, text->size());
+        batch.append(*text, 0, offset);
+        batch += timestamp(record.time);
+        batch.append(*text, offset, std::string::npos);
+
+        if (record.type == GAME_BEGIN && record.message.names) {
+            gameNames[record.game] = std::move(*record.message.names);
+        } else if (record.type == GAME_END) {
+            gameNames.erase(record.game);
+        }
+        delete record.message.names;
+        delete text;
+        return;
+    }
+
+    static const std::vector<std::string> noNames;
+    auto found = gameNames.find(record.game);
+    const auto& names = found != gameNames.end() ? found->second : noNames;
+    auto name = [&](size_t seat) {
+        return seat < names.size() ? names[seat] : "P" + std::to_string(seat);
+    };
+
+    batch += timestamp(record.time);
+    batch += " | Round ";
+    batch += std::to_string(record.round);
+    batch += " | ";
+    for (size_t i = 0; i < record.seats; ++i) {
+        batch += name(i);
+        batch += (record.defections >> i) & 1 ? "=D(" : "=C(";
+        batch += std::to_string(record.roundData.roundScores[i]);
+        batch += ") ";
+    }
+    batch += "| Total: ";
+    for (size_t i = 0; i < record.seats; ++i) {
+        batch += name(i);
+        batch += "=";
+        batch += std::to_string(record.roundData.totals[i]);
+        if (i + 1 < record.seats) batch += ", ";
+    }
+    batch += "\n";
+}
+
+void Logger::writeBatch() {
+    uint64_t drops = droppedRounds.load(std::memory_order_relaxed);
+    if (drops != reportedDrops) {
+        batch += timestamp(coarseTime.load(std::memory_order_relaxed));
+        batch += " | LOG BUFFER FULL: " + std::to_string(drops - reportedDrops) + " round records dropped\n";
+        reportedDrops = drops;
+    }
+    if (!batch.empty()) {
+        logFile.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+        logFile.flush();
+        batch.clear();
+    }
+    processed.store(head, std::memory_order_release);
+}
+
+void Logger::flush() {
+    if (!writer.joinable()) return;
+    uint64_t target = tail.load(std::memory_order_acquire);
+    while (processed.load(std::memory_order_acquire) < target) {
+        wake.notify_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+uint32_t Logger::logGameStart(const std::vector<std::string>& playerNames, int totalRounds) {
+    if (!enabled) return 0;
+    uint32_t game = nextGame.fetch_add(1);
+
+    std::string text = "\n" + std::string(60, '=') + "\n";
+    size_t stampOffset = text.size();
+    text += " | GAME STARTED\nPlayers: ";
     for (const auto& name : playerNames) {
-        logFile << name << " ";
+        text += name + " ";
     }
-    logFile << "| Rounds: " << totalRounds << std::endl;
-    logFile << std::string(60, '=') << std::endl;
+    text += "| Rounds: " + std::to_string(totalRounds) + "\n";
+    text += std::string(60, '=') + "\n";
+
+    pushMessage(GAME_BEGIN, std::move(text), stampOffset, game, new std::vector<std::string>(playerNames));
+    return game;
 }
 
 void Logger::logGameEnd(const std::vector<std::string>& playerNames,
-                        const std::vector<int>& finalScores) {
+                        const std::vector<long long>& finalScores,
+                        uint32_t game) {
     if (!enabled) return;
-    
-    logFile << std::string(60, '=') << std::endl;
-    logFile << getTimestamp() << " | GAME ENDED" << std::endl;
-    
-    int maxScore = -1;
+
+    std::string text = std::string(60, '=') + "\n";
+    size_t stampOffset = text.size();
+    text += " | GAME ENDED\n";
+
+    long long maxScore = -1;
     int winnerIndex = -1;
-    
+
     for (size_t i = 0; i < playerNames.size(); ++i) {
-        logFile << playerNames[i] << ": " << finalScores[i] << " points" << std::endl;
-        
+        text += playerNames[i] + ": " + std::to_string(finalScores[i]) + " points\n";
+
         if (finalScores[i] > maxScore) {
             maxScore = finalScores[i];
             winnerIndex = i;
         }
     }
-    
+
     if (winnerIndex != -1) {
-        logFile << "WINNER: " << playerNames[winnerIndex] 
-                << " with " << maxScore << " points!" << std::endl;
+        text += "WINNER: " + playerNames[winnerIndex] + " with " + std::to_string(maxScore) + " points!\n";
     }
-    
-    logFile << std::string(60, '=') << std::endl;
+
+    text += std::string(60, '=') + "\n";
+    pushMessage(GAME_END, std::move(text), stampOffset, game);
 }
 
 void Logger::logTournamentStart(const std::vector<std::string>& allStrategies) {
     if (!enabled) return;
-    
-    logFile << "\n" << std::string(70, '=') << std::endl;
-    logFile << getTimestamp() << " | TOURNAMENT STARTED" << std::endl;
-    logFile << "Participating strategies (" << allStrategies.size() << "): ";
+
+    std::string text = "\n" + std::string(70, '=') + "\n";
+    size_t stampOffset = text.size();
+    text += " | TOURNAMENT STARTED\n";
+    text += "Participating strategies (" + std::to_string(allStrategies.size()) + "): ";
     for (const auto& name : allStrategies) {
-        logFile << name << " ";
+        text += name + " ";
     }
-    logFile << std::endl;
-    logFile << std::string(70, '=') << std::endl;
+    text += "\n" + std::string(70, '=') + "\n";
+    pushMessage(MESSAGE, std::move(text), stampOffset);
 }
 
-void Logger::logTournamentEnd(const std::map<std::string, int>& finalScores) {
+void Logger::logTournamentEnd(const std::map<std::string, long long>& finalScores) {
     if (!enabled) return;
-    
-    logFile << std::string(70, '=') << std::endl;
-    logFile << getTimestamp() << " | TOURNAMENT ENDED" << std::endl;
-    
-    std::vector<std::pair<std::string, int>> sorted(
+
+    std::string text = std::string(70, '=') + "\n";
+    size_t stampOffset = text.size();
+    text += " | TOURNAMENT ENDED\n";
+
+    std::vector<std::pair<std::string, long long>> sorted(
         finalScores.begin(), finalScores.end());
-    
+
     std::sort(sorted.begin(), sorted.end(),
               [](const auto& a, const auto& b) {
                   return a.second > b.second;
               });
-    
+
     for (const auto& [name, score] : sorted) {
-        logFile << name << ": " << score << " points" << std::endl;
+        text += name + ": " + std::to_string(score) + " points\n";
     }
-    
+
     if (!sorted.empty()) {
-        logFile << "TOURNAMENT WINNER: " << sorted[0].first 
-                << " with " << sorted[0].second << " points!" << std::endl;
+        text += "TOURNAMENT WINNER: " + sorted[0].first + " with " + std::to_string(sorted[0].second) + " points!\n";
     }
-    
-    logFile << std::string(70, '=') << std::endl;
-}
 
-std::string Logger::moveToString(Move move) const {
-    return (move == Move::COOPERATE) ? "C" : "D";
+    text += std::string(70, '=') + "\n";
+    pushMessage(MESSAGE, std::move(text), stampOffset);
 }
-
-std::string Logger::getTimestamp() const {
-    auto now = std::chrono::system_clock::now();
-    std::time_t time = std::chrono::system_clock::to_time_t(now);
-    
-    char buffer[80];
-    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", std::localtime(&time));
-    
-    return std::string(buffer);
-}
\ No newline at end of file
@@ -4,43 +4,144 @@
 #include <string>
 #include <fstream>
 #include <vector>
-#include <map>          
+#include <map>
 #include <memory>
-#include <chrono>        
-#include <ctime>         
-#include <iomanip>      
-#include <algorithm>     
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <iomanip>
+#include <algorithm>
 #include "core/Strategy.h"
 
+// Асинхронный журнал game_log.txt. Вызовы log* только кладут записи
+// фиксированного размера в кольцевой буфер (ограниченная очередь
+// Вьюкова, без блокировок); фоновый поток форматирует их, копит пачкой
+// и пишет в файл. Время берётся из грубых часов, которые обновляет
+// тот же поток, поэтому запись раунда не делает системных вызовов.
+//
+// Раунды пишутся раз в setRoundSampling раундов (0 - не пишутся).
+// При заполненном буфере запись раунда отбрасывается (DropPolicy::DROP,
+// число отброшенных попадает в журнал) или ждёт места (BLOCK);
+// события игр и турниров ждут места всегда.
 class Logger {
+public:
+    enum class DropPolicy { DROP, BLOCK };
+
+    // Места сверх MAX_SEATS в записи раунда не хранятся
+    static const int MAX_SEATS = 8;
+    static const size_t DEFAULT_CAPACITY = 1 << 13;
+
 private:
+    enum RecordType : uint8_t { MESSAGE, ROUND, GAME_BEGIN, GAME_END };
+
+    struct RoundData {
+        int32_t roundScores[MAX_SEATS];
+        long long totals[MAX_SEATS];
+    };
+    struct MessageData {
+        std::string* text;                   // освобождает фоновый поток
+        std::vector<std::string>* names;     // GAME_BEGIN: имена игроков
+        size_t stampOffset;                  // куда вставить время
+    };
+    struct Record {
+        RecordType type;
+        uint8_t seats;
+        uint32_t game;
+        int64_t time;
+        int64_t round;
+        uint64_t defections;                 // бит i - предательство места i
+        union {
+            RoundData roundData;
+            MessageData message;
+        };
+    };
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence;
+        Record record;
+    };
+
     std::ofstream logFile;
     bool enabled;
     std::string logPath;
-    
+
+    std::unique_ptr<Slot[]> slots;
+    size_t capacity;
+    alignas(64) std::atomic<uint64_t> tail;
+    alignas(64) uint64_t head;
+    std::atomic<uint64_t> processed;
+    std::atomic<uint64_t> droppedRounds;
+    std::atomic<int64_t> coarseTime;
+    std::atomic<uint32_t> nextGame;
+    int roundSampling;
+    DropPolicy dropPolicy;
+
+    std::thread writer;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping;
+
+    // Состояние фонового потока
+    std::map<uint32_t, std::vector<std::string>> gameNames;
+    std::string batch;
+    int64_t stampTime;
+    std::string stamp;
+    uint64_t reportedDrops;
+
+    Slot* claim(bool wait, uint64_t& position);
+    void publish(Slot* slot, uint64_t position) {
+        slot->sequence.store(position + 1, std::memory_order_release);
+    }
+    void pushMessage(RecordType type, std::string text, size_t stampOffset,
+                     uint32_t game = 0, std::vector<std::string>* names = nullptr);
+    void pushRound(uint32_t game, int round, const std::vector<Move>& moves,
+                   const std::vector<int>& roundScores, const std::vector<long long>& totalScores);
+
+    void writerLoop();
+    void drain();
+    void format(Record& record);
+    const std::string& timestamp(int64_t time);
+    void writeBatch();
+
 public:
-    Logger(const std::string& configDir = "");
+    Logger(const std::string& configDir = "", size_t capacity = DEFAULT_CAPACITY);
     ~Logger();
-    
-    void logRound(int round, 
-                  const std::vector<std::string>& playerNames,
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // game - номер от logGameStart; дешёвый вызов на каждый раунд
+    void logRound(uint32_t game, int round,
                   const std::vector<Move>& moves,
                   const std::vector<int>& roundScores,
-                  const std::vector<int>& totalScores);
-    
-    void logGameStart(const std::vector<std::string>& playerNames, int totalRounds);
+                  const std::vector<long long>& totalScores) {
+        if (!enabled || roundSampling <= 0 || round % roundSampling != 0) return;
+        pushRound(game, round, moves, roundScores, totalScores);
+    }
+
+    // Номер игры для logRound и logGameEnd
+    uint32_t logGameStart(const std::vector<std::string>& playerNames, int totalRounds);
     void logGameEnd(const std::vector<std::string>& playerNames,
-                    const std::vector<int>& finalScores);
-    
+                    const std::vector<long long>& finalScores,
+                    uint32_t game = 0);
+
     void logTournamentStart(const std::vector<std::string>& allStrategies);
-    void logTournamentEnd(const std::map<std::string, int>& finalScores);
-    
-    void setEnabled(bool enable) { enabled = enable; }
+    void logTournamentEnd(const std::map<std::string, long long>& finalScores);
+
+    void setEnabled(bool enable) { enabled = enable && writer.joinable(); }
     bool isEnabled() const { return enabled; }
-    
-private:
-    std::string moveToString(Move move) const;
-    std::string getTimestamp() const;
+
+    // Каждый every-й раунд (с нулевого); 0 - раунды не пишутся
+    void setRoundSampling(int every) { roundSampling = every > 0 ? every : 0; }
+    int getRoundSampling() const { return roundSampling; }
+    void setDropPolicy(DropPolicy policy) { dropPolicy = policy; }
+    uint64_t getDroppedRounds() const { return droppedRounds.load(); }
+
+    // Ждёт, пока всё записанное до вызова окажется в файле
+    void flush();
 };
 
-#endif 
\ No newline at end of file
+#endif
@@ -21,6 +21,23 @@ void Parser::setDefaultValues() {
     steps = 100;
     configDir = ".";
     matrixFile = "";
+    replicas = 1;
+    groupSize = 3;
+    threads = 1;
+    shardIndex = 0;
+    shardCount = 1;
+    resume = false;
+    useCache = false;
+    useTrace = false;
+    exportResults = false;
+    checkpointInterval = 60;
+    generations = 1000;
+    latticeWidth = 100;
+    latticeHeight = 100;
+    graphFile = "";
+    seed = 0;
+    seedGiven = false;
+    logRounds = 0;
 }
 
 void Parser::parseArguments(int argc, char* argv[]) {
@@ -39,6 +56,63 @@ void Parser::parseArguments(int argc, char* argv[]) {
             }
             else if (arg.substr(0, 9) == "--matrix=") {
                 matrixFile = arg.substr(9);
+            }
+            else if (arg.substr(0, 11) == "--replicas=") {
+                replicas = std::stoi(arg.substr(11));
+            }
+            else if (arg.substr(0, 8) == "--group=") {
+                groupSize = std::stoi(arg.substr(8));
+            }
+            else if (arg.substr(0, 10) == "--threads=") {
+                threads = std::stoi(arg.substr(10));
+            }
+            else if (arg.substr(0, 8) == "--shard=") {
+                // i/N
+                std::string value = arg.substr(8);
+                size_t slash = value.find('/');
+                if (slash == std::string::npos) {
+                    throw std::invalid_argument("Shard must be given as i/N");
+                }
+                shardIndex = std::stoi(value.substr(0, slash));
+                shardCount = std::stoi(value.substr(slash + 1));
+            }
+            else if (arg == "--resume") {
+                resume = true;
+            }
+            else if (arg == "--cache") {
+                useCache = true;
+            }
+            else if (arg == "--trace") {
+                useTrace = true;
+            }
+            else if (arg == "--results") {
+                exportResults = true;
+            }
+            else if (arg.substr(0, 13) == "--checkpoint=") {
+                checkpointInterval = std::stoi(arg.substr(13));
+            }
+            else if (arg.substr(0, 14) == "--generations=") {
+                generations = std::stoi(arg.substr(14));
+            }
+            else if (arg.substr(0, 10) == "--lattice=") {
+                // WxH
+                std::string value = arg.substr(10);
+                size_t separator = value.find('x');
+                if (separator == std::string::npos) {
+                    throw std::invalid_argument("Lattice must be given as WxH");
+                }
+                latticeWidth = std::stoi(value.substr(0, separator));
+                latticeHeight = std::stoi(value.substr(separator + 1));
+            }
+            else if (arg.substr(0, 8) == "--graph=") {
+                graphFile = arg.substr(8);
+            }
+            else if (arg.substr(0, 7) == "--seed=") {
+                seed = std::stoull(arg.substr(7));
+                seedGiven = true;
+            }
+            else if (arg.substr(0, 13) == "--log-rounds=") {
+                logRounds = std::stoi(arg.substr(13));
             } else if (arg == "--help"){
                 
             }
@@ -51,19 +125,50 @@ void Parser::parseArguments(int argc, char* argv[]) {
         }
     }
 
-    if (strategies.size() > 3 && mode == "detailed") {
+    // merge <файлы...> - сложение результатов шардов
+    if (!strategies.empty() && strategies[0] == "merge") {
+        mode = "merge";
+        strategies.erase(strategies.begin());
+        return;
+    }
+
+    // trace <файл> - сводка по двоичной трассе
+    if (!strategies.empty() && strategies[0] == "trace") {
+        mode = "trace";
+        strategies.erase(strategies.begin());
+        return;
+    }
+
+    if (strategies.size() > static_cast<size_t>(groupSize) && mode == "detailed") {
         mode = "tournament";
     }
 }
 
 bool Parser::validate() const {
+    if (mode == "merge") {
+        if (strategies.empty()) {
+            std::cerr << "Error: merge requires partial results files" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    if (mode == "trace") {
+        if (strategies.size() != 1) {
+            std::cerr << "Error: trace requires exactly one trace file" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
     if (strategies.empty()) {
         std::cerr << "Error: No starategies specified" << std::endl;
         return false;
     }
 
-    if (mode != "detailed" && mode != "fast" && mode != "tournament") {
-        std::cerr << "Error: Invalid mode. Use: detailed, fast, or tournament" << std::endl;
+    if (mode != "detailed" && mode != "fast" && mode != "tournament" && mode != "analytic" &&
+        mode != "ecological" && mode != "spatial") {
+        std::cerr << "Error: Invalid mode. Use: detailed, fast, tournament, analytic, ecological or spatial" << std::endl;
         return false;
     }
 
@@ -72,8 +177,80 @@ bool Parser::validate() const {
         return false;
     }
 
-    if ((mode == "detailed" || mode == "fast") && strategies.size() != 3) {
-        std::cerr << "Error: detailed/fast mode requires exactly 3 strategies" << std::endl;
+    if (replicas <= 0) {
+        std::cerr << "Error: Replicas must be positive" << std::endl;
+        return false;
+    }
+
+    if (threads < 0) {
+        std::cerr << "Error: Threads must be non-negative (0 - all cores)" << std::endl;
+        return false;
+    }
+
+    if (shardCount < 1 || shardIndex < 0 || shardIndex >= shardCount) {
+        std::cerr << "Error: Shard must be i/N with 0 <= i < N" << std::endl;
+        return false;
+    }
+
+    if (shardCount > 1 && mode != "tournament" && mode != "analytic") {
+        std::cerr << "Error: --shard requires tournament or analytic mode" << std::endl;
+        return false;
+    }
+
+    if (checkpointInterval < 0) {
+        std::cerr << "Error: Checkpoint interval must be non-negative (0 - disabled)" << std::endl;
+        return false;
+    }
+
+    if (resume && mode != "tournament" && mode != "analytic") {
+        std::cerr << "Error: --resume requires tournament or analytic mode" << std::endl;
+        return false;
+    }
+
+    if (useTrace && mode != "tournament" && mode != "analytic") {
+        std::cerr << "Error: --trace requires tournament or analytic mode" << std::endl;
+        return false;
+    }
+
+    if (exportResults && mode != "tournament" && mode != "analytic") {
+        std::cerr << "Error: --results requires tournament or analytic mode" << std::endl;
+        return false;
+    }
+
+    if (useTrace && groupSize != 3) {
+        std::cerr << "Error: --trace supports only groups of 3" << std::endl;
+        return false;
+    }
+
+    if (generations <= 0) {
+        std::cerr << "Error: Generations must be positive" << std::endl;
+        return false;
+    }
+
+    if (logRounds < 0) {
+        std::cerr << "Error: Round logging interval cannot be negative" << std::endl;
+        return false;
+    }
+
+    if ((mode == "ecological" || mode == "spatial") && groupSize != 3) {
+        std::cerr << "Error: " << mode << " mode supports only groups of 3" << std::endl;
+        return false;
+    }
+
+    if (latticeWidth <= 0 || latticeHeight <= 0 ||
+        static_cast<long long>(latticeWidth) * latticeHeight > 0xFFFFFFFFLL) {
+        std::cerr << "Error: Lattice must be WxH with positive sides" << std::endl;
+        return false;
+    }
+
+    if (groupSize < 2) {
+        std::cerr << "Error: Group size must be at least 2" << std::endl;
+        return false;
+    }
+
+    if ((mode == "detailed" || mode == "fast") && strategies.size() != static_cast<size_t>(groupSize)) {
+        std::cerr << "Error: detailed/fast mode requires exactly " << groupSize
+                  << " strategies (see --group)" << std::endl;
         return false;
     }
 
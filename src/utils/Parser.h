@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <cstdint>
 #include <stdexcept>
 
 class Parser {
@@ -13,6 +14,23 @@ private:
     int steps;
     std::string configDir;
     std::string matrixFile;
+    int replicas;
+    int groupSize;
+    int threads;
+    int shardIndex;
+    int shardCount;
+    bool resume;
+    bool useCache;
+    bool useTrace;
+    bool exportResults;
+    int checkpointInterval;
+    int generations;
+    int latticeWidth;
+    int latticeHeight;
+    std::string graphFile;
+    uint64_t seed;
+    bool seedGiven;
+    int logRounds;
 
     void parseArguments(int argc, char* argv[]);
     void setDefaultValues();
@@ -23,6 +41,34 @@ public:
     int getSteps() const { return steps; }
     const std::string& getConfigDir() const { return configDir; }
     const std::string& getMatrixFile() const { return matrixFile; }
+    int getReplicas() const { return replicas; }
+    int getGroupSize() const { return groupSize; }
+    int getThreads() const { return threads; }
+    int getShardIndex() const { return shardIndex; }
+    int getShardCount() const { return shardCount; }
+    bool getResume() const { return resume; }
+    // Кэш результатов игр в каталоге конфигураций
+    bool getUseCache() const { return useCache; }
+    // Двоичная трасса игр турнира в каталоге конфигураций
+    bool getUseTrace() const { return useTrace; }
+    // Таблица результатов по играм (.pdr и .csv) в каталоге конфигураций
+    bool getExportResults() const { return exportResults; }
+    // Секунды между контрольными точками турнира; 0 - без них
+    int getCheckpointInterval() const { return checkpointInterval; }
+    // Число поколений динамики репликаторов (mode == "ecological")
+    int getGenerations() const { return generations; }
+    // Пространственный режим: тор --lattice=WxH или граф --graph=<файл>
+    int getLatticeWidth() const { return latticeWidth; }
+    int getLatticeHeight() const { return latticeHeight; }
+    const std::string& getGraphFile() const { return graphFile; }
+    // Зерно случайных чисел --seed=N; без него main выбирает зерно сам
+    bool hasSeed() const { return seedGiven; }
+    uint64_t getSeed() const { return seed; }
+    // Каждый N-й раунд игры в журнал; 0 - только начало и итоги
+    int getLogRounds() const { return logRounds; }
+    // Для mode == "merge" - файлы частичных результатов,
+    // для mode == "trace" - файл трассы
+    const std::vector<std::string>& getInputFiles() const { return strategies; }
 
     bool validate() const;
 };
@@ -2,6 +2,7 @@
 #include "utils/ConfigFileParser.h"
 #include "utils/Parser.h"
 #include <filesystem>
+#include <fstream>
 
 // Тесты ConfigFileParser
 TEST(ConfigFileParserTests, BasicParsingTest) {
@@ -162,4 +163,124 @@ TEST(ParserTests, ValidationTest) {
     
     const char* argv6[] = {"program", "s1", "s2", "s3", "s4", "--mode=fast"};
     EXPECT_THROW(Parser(6, const_cast<char**>(argv6)), std::invalid_argument);
-}
\ No newline at end of file
+}
+TEST(ParserTests, GroupSizeTest) {
+    const char* argv[] = {"program", "s1", "s2", "s3", "s4", "s5", "--mode=fast", "--group=5"};
+    Parser parser(8, const_cast<char**>(argv));
+    EXPECT_EQ(parser.getGroupSize(), 5);
+    EXPECT_EQ(parser.getMode(), "fast");
+    
+    // Число стратегий должно совпадать с размером группы
+    const char* argv2[] = {"program", "s1", "s2", "s3", "--mode=fast", "--group=4"};
+    EXPECT_THROW(Parser(6, const_cast<char**>(argv2)), std::invalid_argument);
+}
+
+TEST(ParserTests, ThreadsAndAnalyticModeTest) {
+    const char* argv[] = {"program", "s1", "s2", "s3", "s4", "--mode=analytic", "--threads=8"};
+    Parser parser(7, const_cast<char**>(argv));
+    EXPECT_EQ(parser.getMode(), "analytic");
+    EXPECT_EQ(parser.getThreads(), 8);
+    
+    const char* argv2[] = {"program", "s1", "s2", "s3", "--threads=-1"};
+    EXPECT_THROW(Parser(5, const_cast<char**>(argv2)), std::invalid_argument);
+}
+
+TEST(ParserTests, ShardAndMergeTest) {
+    const char* argv[] = {"program", "s1", "s2", "s3", "s4", "--mode=tournament", "--shard=1/4"};
+    Parser parser(7, const_cast<char**>(argv));
+    EXPECT_EQ(parser.getShardIndex(), 1);
+    EXPECT_EQ(parser.getShardCount(), 4);
+    
+    const char* argv2[] = {"program", "s1", "s2", "s3", "s4", "--shard=4/4"};
+    EXPECT_THROW(Parser(6, const_cast<char**>(argv2)), std::invalid_argument);
+    
+    const char* argv3[] = {"program", "merge", "a.txt", "b.txt"};
+    Parser merge(4, const_cast<char**>(argv3));
+    EXPECT_EQ(merge.getMode(), "merge");
+    EXPECT_EQ(merge.getInputFiles(), (std::vector<std::string>{"a.txt", "b.txt"}));
+}
+
+TEST(ParserTests, ResumeAndCheckpointTest) {
+    const char* argv[] = {"program", "s1", "s2", "s3", "s4", "--resume", "--checkpoint=5"};
+    Parser parser(7, const_cast<char**>(argv));
+    EXPECT_TRUE(parser.getResume());
+    EXPECT_EQ(parser.getCheckpointInterval(), 5);
+    
+    const char* argv2[] = {"program", "s1", "s2", "s3", "--resume"};
+    EXPECT_THROW(Parser(5, const_cast<char**>(argv2)), std::invalid_argument);
+}
+
+TEST(ParserTests, EcologicalModeTest) {
+    const char* argv[] = {"program", "s1", "s2", "s3", "s4", "--mode=ecological", "--generations=500"};
+    Parser parser(7, const_cast<char**>(argv));
+    EXPECT_EQ(parser.getMode(), "ecological");
+    EXPECT_EQ(parser.getGenerations(), 500);
+    
+    const char* argv2[] = {"program", "s1", "s2", "--mode=ecological", "--group=4"};
+    EXPECT_THROW(Parser(5, const_cast<char**>(argv2)), std::invalid_argument);
+}
+
+TEST(ParserTests, SpatialModeTest) {
+    const char* argv[] = {"program", "tft", "coop", "def", "--mode=spatial", "--lattice=200x50"};
+    Parser parser(6, const_cast<char**>(argv));
+    EXPECT_EQ(parser.getMode(), "spatial");
+    EXPECT_EQ(parser.getLatticeWidth(), 200);
+    EXPECT_EQ(parser.getLatticeHeight(), 50);
+    
+    const char* argv2[] = {"program", "tft", "coop", "--mode=spatial", "--lattice=200"};
+    EXPECT_THROW(Parser(5, const_cast<char**>(argv2)), std::invalid_argument);
+}
+
+TEST(ParserTests, CacheFlagTest) {
+    const char* argv[] = {"program", "s1", "s2", "s3", "s4", "--cache"};
+    Parser parser(6, const_cast<char**>(argv));
+    EXPECT_TRUE(parser.getUseCache());
+    
+    const char* argv2[] = {"program", "s1", "s2", "s3", "s4"};
+    EXPECT_FALSE(Parser(5, const_cast<char**>(argv2)).getUseCache());
+}
+
+TEST(ParserTests, SeedTest) {
+    const char* argv[] = {"program", "s1", "s2", "s3", "--seed=18446744073709551615"};
+    Parser parser(5, const_cast<char**>(argv));
+    EXPECT_TRUE(parser.hasSeed());
+    EXPECT_EQ(parser.getSeed(), 18446744073709551615ULL);
+    
+    const char* argv2[] = {"program", "s1", "s2", "s3"};
+    EXPECT_FALSE(Parser(4, const_cast<char**>(argv2)).hasSeed());
+}
+
+TEST(ParserTests, LogRoundsTest) {
+    const char* argv[] = {"program", "s1", "s2", "s3", "--log-rounds=100"};
+    EXPECT_EQ(Parser(5, const_cast<char**>(argv)).getLogRounds(), 100);
+    
+    const char* argv2[] = {"program", "s1", "s2", "s3"};
+    EXPECT_EQ(Parser(4, const_cast<char**>(argv2)).getLogRounds(), 0);
+    
+    const char* argv3[] = {"program", "s1", "s2", "s3", "--log-rounds=-1"};
+    EXPECT_THROW(Parser(5, const_cast<char**>(argv3)), std::invalid_argument);
+}
+
+TEST(ParserTests, TraceTest) {
+    const char* argv[] = {"program", "s1", "s2", "s3", "s4", "--mode=tournament", "--trace"};
+    EXPECT_TRUE(Parser(7, const_cast<char**>(argv)).getUseTrace());
+    
+    const char* argv2[] = {"program", "trace", "out/tournament_trace.pdt"};
+    Parser summary(3, const_cast<char**>(argv2));
+    EXPECT_EQ(summary.getMode(), "trace");
+    EXPECT_EQ(summary.getInputFiles(), (std::vector<std::string>{"out/tournament_trace.pdt"}));
+    
+    // Трасса пишется только турниром троек
+    const char* argv3[] = {"program", "s1", "s2", "s3", "--mode=fast", "--trace"};
+    EXPECT_THROW(Parser(6, const_cast<char**>(argv3)), std::invalid_argument);
+    const char* argv4[] = {"program", "s1", "s2", "s3", "s4", "s5", "--mode=tournament", "--group=4", "--trace"};
+    EXPECT_THROW(Parser(9, const_cast<char**>(argv4)), std::invalid_argument);
+}
+
+TEST(ParserTests, ResultsTest) {
+    const char* argv[] = {"program", "s1", "s2", "s3", "s4", "--mode=tournament", "--results"};
+    EXPECT_TRUE(Parser(7, const_cast<char**>(argv)).getExportResults());
+    
+    const char* argv2[] = {"program", "s1", "s2", "s3", "--mode=fast", "--results"};
+    EXPECT_THROW(Parser(6, const_cast<char**>(argv2)), std::invalid_argument);
+}
@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 #include "core/StrategyFactory.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
 
 TEST(StrategyFactoryTests, FactoryCreationTest) {
     auto& factory = StrategyFactory::getInstance();
@@ -113,4 +117,150 @@ TEST(StrategyFactoryTests, FactoryAvailableStrategiesTest) {
     
     // Проверяем, что список не пустой
     EXPECT_FALSE(strategies.empty());
-}
\ No newline at end of file
+}
+TEST(StrategyFactoryTests, FactorySlotFastPathTest) {
+    auto& factory = StrategyFactory::getInstance();
+    
+    // Встроенные стратегии идут по быстрому пути
+    auto tft = factory.createSlot("tft");
+    ASSERT_TRUE(static_cast<bool>(tft));
+    EXPECT_TRUE(tft.isDevirtualized());
+    EXPECT_EQ(tft->getName(), "TitForTat");
+    
+    auto defect = factory.createSlot("AD");
+    EXPECT_TRUE(defect.isDevirtualized());
+    EXPECT_EQ(defect.makeMove(HistoryView(), OpponentsView()), Move::DEFECT);
+    
+    // Неизвестная стратегия - пустой слот
+    auto invalid = factory.createSlot("nonexistent_strategy");
+    EXPECT_FALSE(static_cast<bool>(invalid));
+}
+
+// Внешняя стратегия, зарегистрированная во время выполнения
+class PluginStrategy : public Strategy {
+public:
+    using Strategy::makeMove;
+    Move makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) override {
+        return ownHistory.size() % 2 ? Move::DEFECT : Move::COOPERATE;
+    }
+    std::string getName() const override { return "Plugin"; }
+};
+
+TEST(StrategyFactoryTests, FactorySlotVirtualFallbackTest) {
+    auto& factory = StrategyFactory::getInstance();
+    factory.registerStrategy("plugin_test", []() -> std::unique_ptr<Strategy> {
+        return std::make_unique<PluginStrategy>();
+    });
+    
+    auto plugin = factory.createSlot("plugin_test");
+    ASSERT_TRUE(static_cast<bool>(plugin));
+    EXPECT_FALSE(plugin.isDevirtualized());
+    EXPECT_EQ(plugin->getName(), "Plugin");
+    EXPECT_EQ(plugin.makeMove(HistoryView(), OpponentsView()), Move::COOPERATE);
+}
+
+
+TEST(StrategyFactoryTests, FactoryTableConfigTest) {
+    auto& factory = StrategyFactory::getInstance();
+    std::filesystem::create_directory("test_factory_tables");
+    std::ofstream file("test_factory_tables/my_grim.cfg");
+    file << "type=fsm\nname=Grim\nstates=2\nmoves=CD\ntransitions=0,1,1,1,1,1,1,1\n";
+    file.close();
+    
+    // Стратегия, описанная только файлом, идёт по быстрому пути
+    auto slot = factory.createSlot("MY_GRIM", "test_factory_tables");
+    ASSERT_TRUE(static_cast<bool>(slot));
+    EXPECT_TRUE(slot.isDevirtualized());
+    EXPECT_EQ(slot->getName(), "Grim");
+    
+    auto strategy = factory.create("my_grim", "test_factory_tables");
+    ASSERT_NE(strategy, nullptr);
+    EXPECT_EQ(strategy->getName(), "Grim");
+    
+    // Без каталога конфигураций имя неизвестно
+    EXPECT_EQ(factory.create("my_grim"), nullptr);
+    
+    std::remove("test_factory_tables/my_grim.cfg");
+    std::filesystem::remove("test_factory_tables");
+}
+
+TEST(StrategyFactoryTests, FactoryPrototypeCacheTest) {
+    auto& factory = StrategyFactory::getInstance();
+    std::filesystem::create_directory("test_factory_prototypes");
+    std::ofstream tft("test_factory_prototypes/titfortat.cfg");
+    tft << "name=CachedTFT\nuse_forgiveness=false\n";
+    tft.close();
+    std::ofstream grim("test_factory_prototypes/proto_grim.cfg");
+    grim << "type=fsm\nname=Grim\nstates=2\nmoves=CD\ntransitions=0,1,1,1,1,1,1,1\n";
+    grim.close();
+    
+    auto first = factory.createSlot("tft", "test_factory_prototypes");
+    ASSERT_TRUE(static_cast<bool>(first));
+    EXPECT_EQ(first->getName(), "CachedTFT");
+    ASSERT_TRUE(static_cast<bool>(factory.createSlot("proto_grim", "test_factory_prototypes")));
+    
+    // Следующие игроки - копии прототипов, файлы больше не читаются
+    std::remove("test_factory_prototypes/titfortat.cfg");
+    std::remove("test_factory_prototypes/proto_grim.cfg");
+    std::filesystem::remove("test_factory_prototypes");
+    
+    auto second = factory.createSlot("tft", "test_factory_prototypes");
+    EXPECT_TRUE(second.isDevirtualized());
+    EXPECT_EQ(second->getName(), "CachedTFT");
+    EXPECT_NE(first.get(), second.get());
+    auto table = factory.createSlot("proto_grim", "test_factory_prototypes");
+    ASSERT_TRUE(static_cast<bool>(table));
+    EXPECT_EQ(table->getName(), "Grim");
+    auto plain = factory.create("tft", "test_factory_prototypes");
+    ASSERT_NE(plain, nullptr);
+    EXPECT_EQ(plain->getName(), "CachedTFT");
+    
+    factory.clearPrototypes();
+    EXPECT_EQ(factory.createSlot("tft", "test_factory_prototypes")->getName(), "TitForTat");
+    EXPECT_FALSE(static_cast<bool>(factory.createSlot("proto_grim", "test_factory_prototypes")));
+    
+    // Копия сбрасывает состояние игры
+    StrategySlot adaptive{AdaptiveStrategy()};
+    adaptive->onRoundResult({Move::COOPERATE, Move::DEFECT, Move::DEFECT}, {0, 5, 5}, 0);
+    auto copy = adaptive.clone();
+    ASSERT_TRUE(static_cast<bool>(copy));
+    EXPECT_EQ(static_cast<AdaptiveStrategy*>(adaptive.get())->getTotalCooperate(), 1);
+    EXPECT_EQ(static_cast<AdaptiveStrategy*>(copy.get())->getTotalCooperate(), 0);
+    
+    // Внешняя стратегия без clone() создаётся заново
+    EXPECT_EQ(PluginStrategy().clone(), nullptr);
+    factory.registerStrategy("plugin_proto", []() -> std::unique_ptr<Strategy> {
+        return std::make_unique<PluginStrategy>();
+    });
+    auto pluginA = factory.createSlot("plugin_proto");
+    auto pluginB = factory.createSlot("plugin_proto");
+    ASSERT_TRUE(pluginA && pluginB);
+    EXPECT_NE(pluginA.get(), pluginB.get());
+}
+
+TEST(StrategyFactoryTests, ConcurrentPrototypesTest) {
+    auto& factory = StrategyFactory::getInstance();
+    factory.clearPrototypes();
+    std::filesystem::create_directory("test_factory_concurrent");
+    std::ofstream grim("test_factory_concurrent/grim_mt.cfg");
+    grim << "type=fsm\nname=GrimMT\nstates=2\nmoves=CD\ntransitions=0,1,1,1,1,1,1,1\n";
+    grim.close();
+    
+    // Потоки одновременно просят один и тот же прототип
+    std::vector<int> built(8, 0);
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < built.size(); ++t) {
+        pool.emplace_back([&, t]() {
+            for (int i = 0; i < 100; ++i) {
+                auto slot = factory.createSlot(i % 2 ? "grim_mt" : "tft", "test_factory_concurrent");
+                built[t] += slot && slot->getName() == (i % 2 ? "GrimMT" : "TitForTat");
+            }
+        });
+    }
+    for (auto& thread : pool) thread.join();
+    for (int count : built) EXPECT_EQ(count, 100);
+    
+    std::remove("test_factory_concurrent/grim_mt.cfg");
+    std::filesystem::remove("test_factory_concurrent");
+    factory.clearPrototypes();
+}
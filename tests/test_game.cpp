@@ -3,6 +3,27 @@
 #include "core/GameMatrix.h"
 #include "strategies/basic/AlwaysCooperate.h"
 #include "strategies/basic/AlwaysDefect.h"
+#include "strategies/advanced/FiftyFifty.h"
+#include "core/BatchGame.h"
+#include "core/MarkovGame.h"
+#include "core/Tournament.h"
+#include "core/Combinations.h"
+#include "core/PartialResults.h"
+#include "core/Checkpoint.h"
+#include "core/ReplicatorDynamics.h"
+#include "core/SpatialGame.h"
+#include "core/ResultCache.h"
+#include "core/GameTrace.h"
+#include "core/ResultsTable.h"
+#include "core/StrategyFactory.h"
+#include "utils/Logger.h"
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <cstdio>
+#include "strategies/basic/Random.h"
+#include "strategies/advanced/TableStrategy.h"
+#include "strategies/advanced/AdaptiveStrategy.h"
 
 // Тесты GameMatrix
 TEST(GameMatrixTests, DefaultMatrixTest) {
@@ -131,4 +152,1447 @@ TEST(GameTests, ResetGameTest) {
     game.reset();
     EXPECT_EQ(game.getCurrentRound(), 0);
     EXPECT_FALSE(game.isReady());
-}
\ No newline at end of file
+}
+
+// Стратегия со старым интерфейсом: работает через адаптер
+class LegacyCopycat : public Strategy {
+public:
+    Move makeMove(const std::vector<Move>& ownHistory,
+                  const std::vector<std::vector<Move>>& opponentsHistory) override {
+        if (opponentsHistory.empty() || opponentsHistory[0].empty()) {
+            return Move::COOPERATE;
+        }
+        return opponentsHistory[0].back();
+    }
+    std::string getName() const override { return "LegacyCopycat"; }
+};
+
+TEST(GameTests, LegacyStrategyAdapterTest) {
+    Game game(3);
+    
+    game.addPlayer(std::make_unique<AlwaysDefect>());
+    game.addPlayer(std::make_unique<LegacyCopycat>());
+    game.addPlayer(std::make_unique<AlwaysCooperate>());
+    
+    game.playGame();
+    
+    // Раунд 1: D C C => 9 3 3, затем копирует D: D D C => 5 5 0
+    auto scores = game.getScores();
+    EXPECT_EQ(scores[0], 9 + 5 + 5);
+    EXPECT_EQ(scores[1], 3 + 5 + 5);
+    EXPECT_EQ(scores[2], 3 + 0 + 0);
+}
+
+// Тесты OpponentStats
+TEST(OpponentStatsTests, SlidingWindowTest) {
+    OpponentStats stats(2, 3);
+    
+    stats.record({Move::COOPERATE, Move::DEFECT});
+    stats.record({Move::COOPERATE, Move::COOPERATE});
+    stats.record({Move::DEFECT, Move::COOPERATE});
+    stats.record({Move::DEFECT, Move::DEFECT});
+    
+    EXPECT_EQ(stats.getRounds(), 4);
+    EXPECT_EQ(stats.getCooperations(0), 2);
+    EXPECT_EQ(stats.getCooperations(1), 2);
+    EXPECT_EQ(stats.getTotalDefections(), 4);
+    
+    // В окне последние 3 раунда
+    EXPECT_EQ(stats.getWindowFill(), 3);
+    EXPECT_EQ(stats.getWindowCooperations(0), 1);
+    EXPECT_EQ(stats.getWindowCooperations(1), 2);
+    EXPECT_DOUBLE_EQ(stats.getWindowCooperationRate(), 0.5);
+    
+    EXPECT_EQ(stats.getLastMove(0), Move::DEFECT);
+    EXPECT_EQ(stats.getLastDefectCount(), 2);
+}
+
+// Стратегия, запоминающая всё, что сообщает движок
+class RecordingStrategy : public Strategy {
+public:
+    std::vector<std::vector<Move>> seenMoves;
+    std::vector<std::vector<int>> seenPayoffs;
+    std::vector<int> seenRounds;
+    size_t statsRounds = 0;
+    
+    using Strategy::makeMove;
+    Move makeMove(HistoryView ownHistory, OpponentsView opponentsHistory) override {
+        return Move::DEFECT;
+    }
+    void onRoundResult(const std::vector<Move>& moves,
+                       const std::vector<int>& payoffs,
+                       int round) override {
+        seenMoves.push_back(moves);
+        seenPayoffs.push_back(payoffs);
+        seenRounds.push_back(round);
+        statsRounds = opponentStats ? opponentStats->getRounds() : 0;
+    }
+    std::string getName() const override { return "Recording"; }
+};
+
+TEST(GameTests, RoundResultCallbackTest) {
+    Game game(2);
+    
+    auto recorder = std::make_unique<RecordingStrategy>();
+    RecordingStrategy* observed = recorder.get();
+    
+    game.addPlayer(std::make_unique<AlwaysCooperate>());
+    game.addPlayer(std::move(recorder));
+    game.addPlayer(std::make_unique<AlwaysCooperate>());
+    game.playGame();
+    
+    // Свой ход первым, затем оппоненты по порядку: C D C => 3 9 3
+    ASSERT_EQ(observed->seenRounds, (std::vector<int>{0, 1}));
+    EXPECT_EQ(observed->seenMoves[0],
+              (std::vector<Move>{Move::DEFECT, Move::COOPERATE, Move::COOPERATE}));
+    EXPECT_EQ(observed->seenPayoffs[0], (std::vector<int>{9, 3, 3}));
+    EXPECT_EQ(observed->statsRounds, 2);
+}
+
+
+// Тесты BatchGame
+TEST(BatchGameTests, MatchesSingleGameTest) {
+    const size_t games = 19;  // не кратно ширине вектора
+    BatchGame batch(games, 7);
+    
+    for (size_t g = 0; g < games; ++g) {
+        // Чередуем составы, чтобы исходы различались между играми
+        if (g % 2 == 0) {
+            batch.addPlayer(g, std::make_unique<AlwaysCooperate>());
+            batch.addPlayer(g, std::make_unique<FiftyFifty>());
+            batch.addPlayer(g, std::make_unique<AlwaysDefect>());
+        } else {
+            batch.addPlayer(g, std::make_unique<FiftyFifty>());
+            batch.addPlayer(g, std::make_unique<AlwaysDefect>());
+            batch.addPlayer(g, std::make_unique<AlwaysDefect>());
+        }
+    }
+    ASSERT_TRUE(batch.isReady());
+    batch.playGame();
+    EXPECT_EQ(batch.getCurrentRound(), 7);
+    
+    Game even(7);
+    even.addPlayer(std::make_unique<AlwaysCooperate>());
+    even.addPlayer(std::make_unique<FiftyFifty>());
+    even.addPlayer(std::make_unique<AlwaysDefect>());
+    even.playGame();
+    
+    Game odd(7);
+    odd.addPlayer(std::make_unique<FiftyFifty>());
+    odd.addPlayer(std::make_unique<AlwaysDefect>());
+    odd.addPlayer(std::make_unique<AlwaysDefect>());
+    odd.playGame();
+    
+    for (size_t g = 0; g < games; ++g) {
+        EXPECT_EQ(batch.getScores(g), (g % 2 == 0) ? even.getScores() : odd.getScores());
+    }
+    
+    auto totals = batch.getTotalScores();
+    EXPECT_EQ(totals[1], 10LL * even.getScores()[1] + 9LL * odd.getScores()[1]);
+    EXPECT_EQ(batch.getPlayerNames(1)[0], "FiftyFifty");
+}
+
+TEST(BatchGameTests, LargePayoffsDoNotOverflowTest) {
+    // 5000 раундов по MAX_PAYOFF - больше, чем вмещают 32 бита
+    const int rounds = 5000;
+    std::ofstream testFile("test_large_matrix.txt");
+    for (const char* moves : {"C C C", "C C D", "C D C", "C D D", "D C C", "D C D", "D D C", "D D D"}) {
+        testFile << moves << " " << PayoffTable::MAX_PAYOFF << " " << PayoffTable::MIN_PAYOFF << " 1\n";
+    }
+    testFile.close();
+    GameMatrix matrix("test_large_matrix.txt");
+    std::remove("test_large_matrix.txt");
+    
+    // Отрицательные выигрыши проверяют расширение знака в каждом пути
+    const size_t games = 11;
+    std::vector<long long> expected = {static_cast<long long>(PayoffTable::MAX_PAYOFF) * rounds,
+                                       static_cast<long long>(PayoffTable::MIN_PAYOFF) * rounds, rounds};
+    for (int level = BatchGame::SCALAR; level <= BatchGame::detectSimd(); ++level) {
+        BatchGame batch(games, rounds, matrix);
+        batch.setSimd(static_cast<BatchGame::Simd>(level));
+        ASSERT_EQ(batch.getSimd(), level);
+        for (size_t g = 0; g < games; ++g) {
+            batch.addPlayer(g, std::make_unique<AlwaysDefect>());
+            batch.addPlayer(g, std::make_unique<AlwaysCooperate>());
+            batch.addPlayer(g, std::make_unique<AlwaysDefect>());
+        }
+        batch.playGame();
+        for (size_t g = 0; g < games; ++g) {
+            EXPECT_EQ(batch.getScores(g), expected) << "game " << g << ", level " << level;
+        }
+        EXPECT_EQ(batch.getTotalScores()[0], expected[0] * static_cast<long long>(games));
+        EXPECT_EQ(batch.getCooperations(0), (std::vector<long long>{0, rounds, 0}));
+    }
+}
+
+TEST(BatchGameTests, VectorPathsMatchScalarTest) {
+    // Случайные ходы с общим зерном: все пути дают те же очки
+    const size_t games = 37;
+    std::vector<std::vector<long long>> scalar;
+    for (int level = BatchGame::SCALAR; level <= BatchGame::detectSimd(); ++level) {
+        BatchGame batch(games, 300);
+        batch.setSimd(static_cast<BatchGame::Simd>(level));
+        batch.setRandomSeed(21, 4);
+        for (size_t g = 0; g < games; ++g) {
+            batch.addPlayer(g, std::make_unique<FiftyFifty>());
+            batch.addPlayer(g, std::make_unique<TitForTat>());
+            batch.addPlayer(g, std::make_unique<FiftyFifty>());
+        }
+        batch.playGame();
+        std::vector<std::vector<long long>> scores;
+        for (size_t g = 0; g < games; ++g) scores.push_back(batch.getScores(g));
+        if (level == BatchGame::SCALAR) {
+            scalar = scores;
+        } else {
+            EXPECT_EQ(scores, scalar) << "level " << level;
+        }
+    }
+#if defined(__x86_64__) || defined(_M_X64)
+    // SSE2 входит в x86-64
+    EXPECT_GE(BatchGame::detectSimd(), BatchGame::SSE2);
+#endif
+}
+
+// Тесты PayoffTable
+TEST(GameMatrixTests, CompileTimeDefaultTableTest) {
+    static_assert(DefaultPayoffTable::payoff(0, 0) == 7, "C C C => 7 7 7");
+    static_assert(DefaultPayoffTable::table.payoff(Move::COOPERATE, Move::DEFECT, Move::DEFECT, 0) == 0,
+                  "C D D => 0 5 5");
+    static_assert(DefaultPayoffTable::payoff(7, 2) == 1, "D D D => 1 1 1");
+    
+    GameMatrix matrix;
+    EXPECT_TRUE(matrix.getTable() == DefaultPayoffTable::table);
+}
+
+TEST(GameMatrixTests, PackedLookupTest) {
+    PayoffTable table;
+    table.set(5, 0, -7);
+    table.set(5, 1, PayoffTable::MAX_PAYOFF);
+    table.set(5, 2, PayoffTable::MIN_PAYOFF);
+    
+    EXPECT_EQ(table.payoff(5, 0), -7);
+    EXPECT_EQ(table.payoff(5, 1), PayoffTable::MAX_PAYOFF);
+    EXPECT_EQ(table.payoff(5, 2), PayoffTable::MIN_PAYOFF);
+    EXPECT_EQ(table.payoff(4, 0), 0);
+    
+    // Загруженная матрица идёт через ту же таблицу
+    std::ofstream testFile("test_packed_matrix.txt");
+    testFile << "D C D -4 12 6\n";
+    testFile.close();
+    
+    GameMatrix matrix("test_packed_matrix.txt");
+    EXPECT_EQ(matrix.getPayoff(Move::DEFECT, Move::COOPERATE, Move::DEFECT, 0), -4);
+    EXPECT_EQ(matrix.getPayoff(Move::DEFECT, Move::COOPERATE, Move::DEFECT, 1), 12);
+    EXPECT_EQ(matrix.getPayoff(Move::DEFECT, Move::COOPERATE, Move::DEFECT),
+              (std::vector<int>{-4, 12, 6}));
+    
+    std::remove("test_packed_matrix.txt");
+}
+
+// Тесты игры N игроков
+TEST(CountPayoffTableTests, DerivedFromMatrixTest) {
+    GameMatrix matrix;
+    
+    // Для трёх игроков таблица совпадает с матрицей
+    CountPayoffTable three(3, matrix);
+    EXPECT_EQ(three.payoff(Move::COOPERATE, 2), 7);
+    EXPECT_EQ(three.payoff(Move::COOPERATE, 1), 3);
+    EXPECT_EQ(three.payoff(Move::COOPERATE, 0), 0);
+    EXPECT_EQ(three.payoff(Move::DEFECT, 2), 9);
+    EXPECT_EQ(three.payoff(Move::DEFECT, 1), 5);
+    EXPECT_EQ(three.payoff(Move::DEFECT, 0), 1);
+    
+    // Для пяти игроков крайние точки те же, середина интерполирована
+    CountPayoffTable five(5, matrix);
+    EXPECT_EQ(five.payoff(Move::COOPERATE, 4), 7);
+    EXPECT_EQ(five.payoff(Move::COOPERATE, 2), 3);
+    EXPECT_EQ(five.payoff(Move::DEFECT, 0), 1);
+    EXPECT_EQ(five.payoff(Move::DEFECT, 3), 7);
+}
+
+TEST(CountPayoffTableTests, LoadFromFileTest) {
+    std::ofstream testFile("test_count_matrix.txt");
+    testFile << "# public goods, 4 players\n";
+    testFile << "C 3 12\n";
+    testFile << "D 0 2\n";
+    testFile << "X 1 5\n";
+    testFile.close();
+    
+    CountPayoffTable table(4, GameMatrix(), "test_count_matrix.txt");
+    EXPECT_TRUE(table.isTableLoaded());
+    EXPECT_EQ(table.payoff(Move::COOPERATE, 3), 12);
+    EXPECT_EQ(table.payoff(Move::DEFECT, 0), 2);
+    // Строка с ходом не C/D отклоняется, остаётся производное значение
+    EXPECT_EQ(table.payoff(Move::DEFECT, 1), CountPayoffTable(4, GameMatrix()).payoff(Move::DEFECT, 1));
+    
+    std::remove("test_count_matrix.txt");
+}
+
+TEST(GameTests, FivePlayerGameTest) {
+    Game game(4, "", 5);
+    EXPECT_EQ(game.getPlayerCount(), 5);
+    
+    game.addPlayer(std::make_unique<AlwaysCooperate>());
+    game.addPlayer(std::make_unique<AlwaysDefect>());
+    game.addPlayer(std::make_unique<AlwaysCooperate>());
+    EXPECT_FALSE(game.isReady());
+    game.addPlayer(std::make_unique<AlwaysCooperate>());
+    game.addPlayer(std::make_unique<AlwaysDefect>());
+    ASSERT_TRUE(game.isReady());
+    
+    game.playGame();
+    
+    // Три сотрудничающих: у C двое сотрудничающих оппонентов, у D трое
+    CountPayoffTable table(5, GameMatrix());
+    auto scores = game.getScores();
+    ASSERT_EQ(scores.size(), 5);
+    EXPECT_EQ(scores[0], 4 * table.payoff(Move::COOPERATE, 2));
+    EXPECT_EQ(scores[1], 4 * table.payoff(Move::DEFECT, 3));
+    EXPECT_EQ(scores[4], scores[1]);
+}
+
+TEST(GameTests, DevirtualizedSlotsTest) {
+    Game game(5);
+    
+    game.addPlayer(StrategySlot(AlwaysCooperate()));
+    game.addPlayer(StrategySlot(AlwaysDefect()));
+    game.addPlayer(std::make_unique<AlwaysCooperate>());
+    game.playGame();
+    
+    // Результат не зависит от способа вызова
+    auto scores = game.getScores();
+    EXPECT_EQ(scores[0], 3 * 5);
+    EXPECT_EQ(scores[1], 9 * 5);
+    EXPECT_EQ(scores[2], 3 * 5);
+}
+
+
+TEST(GameTests, CycleFastForwardMatchesSimulationTest) {
+    // TableStrategy по умолчанию - детерминированный "око за око"
+    auto play = [](bool detect) {
+        Game game(10001);
+        game.setCycleDetection(detect);
+        game.addPlayer(StrategySlot(TableStrategy()));
+        game.addPlayer(StrategySlot(FiftyFifty()));
+        game.addPlayer(StrategySlot(AlwaysCooperate()));
+        game.playGame();
+        EXPECT_EQ(game.getCurrentRound(), 10001);
+        return game;
+    };
+    
+    Game fast = play(true);
+    Game slow = play(false);
+    EXPECT_GT(fast.getFastForwardedRounds(), 9000);
+    EXPECT_EQ(slow.getFastForwardedRounds(), 0);
+    EXPECT_EQ(fast.getScores(), slow.getScores());
+    EXPECT_EQ(fast.getCurrentMoves(), slow.getCurrentMoves());
+    EXPECT_EQ(fast.getCooperations(), slow.getCooperations());
+}
+
+TEST(GameTests, BillionRoundCycleTest) {
+    Game game(1000000000);
+    game.addPlayer(StrategySlot(AlwaysCooperate()));
+    game.addPlayer(StrategySlot(AlwaysDefect()));
+    game.addPlayer(StrategySlot(FiftyFifty()));
+    game.playGame();
+    
+    // Цикл из двух раундов: (C D C) -> 3 9 3, (C D D) -> 0 5 5
+    auto scores = game.getScores();
+    EXPECT_EQ(scores[0], 3LL * 500000000);
+    EXPECT_EQ(scores[1], 14LL * 500000000);
+    EXPECT_EQ(scores[2], 8LL * 500000000);
+    EXPECT_EQ(game.getCurrentRound(), 1000000000);
+    EXPECT_EQ(game.getCooperations(), (std::vector<long long>{1000000000, 0, 500000000}));
+}
+
+TEST(GameTests, RandomStrategyDisablesFastForwardTest) {
+    Game game(200);
+    game.addPlayer(StrategySlot(AlwaysCooperate()));
+    game.addPlayer(StrategySlot(AlwaysDefect()));
+    game.addPlayer(StrategySlot(RandomStrategy()));
+    game.playGame();
+    
+    EXPECT_EQ(game.getFastForwardedRounds(), 0);
+    EXPECT_EQ(game.getCurrentRound(), 200);
+}
+
+TEST(MarkovGameTests, DeterministicMatchesSimulationTest) {
+    AlwaysCooperate cooperate;
+    AlwaysDefect defect;
+    FiftyFifty alternate;
+    
+    std::array<MemoryOneResponse, 3> responses;
+    ASSERT_TRUE(MarkovGame::describe({&cooperate, &defect, &alternate}, responses));
+    MarkovGame markov(responses);
+    
+    Game game(1001);
+    game.addPlayer(StrategySlot(AlwaysCooperate()));
+    game.addPlayer(StrategySlot(AlwaysDefect()));
+    game.addPlayer(StrategySlot(FiftyFifty()));
+    game.playGame();
+    
+    auto expected = markov.expectedTotals(1001);
+    auto scores = game.getScores();
+    for (int seat = 0; seat < 3; ++seat) {
+        EXPECT_NEAR(expected[seat], static_cast<double>(scores[seat]), 1e-6);
+    }
+}
+
+TEST(MarkovGameTests, StochasticExpectationTest) {
+    RandomStrategy random;
+    TableStrategy titForTat;
+    
+    // Три случайных игрока: все исходы равновероятны
+    std::array<MemoryOneResponse, 3> responses;
+    ASSERT_TRUE(MarkovGame::describe({&random, &random, &random}, responses));
+    auto uniform = MarkovGame(responses).expectedTotals(1000);
+    EXPECT_NEAR(uniform[0], 1000 * 33.0 / 8, 1e-6);
+    
+    // Сумма по раундам совпадает с удвоением
+    ASSERT_TRUE(MarkovGame::describe({&titForTat, &random, &random}, responses));
+    MarkovGame markov(responses);
+    std::vector<double> sum(3, 0.0);
+    for (int round = 0; round < 37; ++round) {
+        auto perRound = markov.expectedRoundScores(round);
+        for (int seat = 0; seat < 3; ++seat) sum[seat] += perRound[seat];
+    }
+    auto totals = markov.expectedTotals(37);
+    for (int seat = 0; seat < 3; ++seat) {
+        EXPECT_NEAR(totals[seat], sum[seat], 1e-9);
+    }
+    
+    // Строки матрицы переходов - распределения
+    for (const auto& row : markov.getTransitionMatrix()) {
+        double total = 0.0;
+        for (double probability : row) total += probability;
+        EXPECT_NEAR(total, 1.0, 1e-12);
+    }
+}
+
+TEST(MarkovGameTests, AdaptiveIsNotMemoryOneTest) {
+    AlwaysCooperate cooperate;
+    AdaptiveStrategy adaptive;
+    std::array<MemoryOneResponse, 3> responses;
+    EXPECT_FALSE(MarkovGame::describe({&cooperate, &adaptive, &cooperate}, responses));
+}
+
+TEST(TournamentTests, ThreadCountDoesNotChangeScoresTest) {
+    // Аналитические тройки (все стратегии здесь с памятью в один раунд)
+    std::vector<std::string> names = {"tft", "random", "coop", "def", "ff"};
+    
+    auto run = [&](int threads) {
+        Tournament tournament(names, 500);
+        tournament.setAnalytic(true);
+        tournament.setReplicas(3);
+        tournament.setThreads(threads);
+        tournament.run();
+        return tournament.getScores();
+    };
+    
+    auto single = run(1);
+    EXPECT_EQ(run(4), single);
+    EXPECT_EQ(run(16), single);
+    EXPECT_GT(single.at("AlwaysDefect"), 0);
+}
+
+TEST(TournamentTests, ThreadCountDoesNotChangePlayedScoresTest) {
+    // Симуляция: random и adaptive тянут случайные числа каждый раунд,
+    // потоки мест зависят только от зерна и группы, не от расписания
+    std::vector<std::string> names = {"tft", "random", "adaptive", "def", "ff", "coop"};
+    
+    auto run = [&](int threads, int replicas) {
+        Tournament tournament(names, 300);
+        tournament.setSeed(12345);
+        tournament.setReplicas(replicas);
+        tournament.setThreads(threads);
+        tournament.run();
+        return tournament.getScores();
+    };
+    
+    for (int replicas : {1, 4}) {
+        auto single = run(1, replicas);
+        EXPECT_EQ(run(4, replicas), single) << "replicas " << replicas;
+        EXPECT_EQ(run(16, replicas), single) << "replicas " << replicas;
+        EXPECT_GT(single.at("RandomStrategy"), 0);
+    }
+}
+
+TEST(CombinationsTests, RankUnrankRoundTripTest) {
+    for (int k = 2; k <= 5; ++k) {
+        Combinations groups(11, k);
+        EXPECT_EQ(groups.size(), Combinations::binomial(11, k));
+        
+        // next обходит все сочетания в порядке рангов
+        std::vector<uint32_t> walked;
+        groups.unrank(0, walked);
+        for (uint64_t rank = 0; rank < groups.size(); ++rank) {
+            std::vector<uint32_t> direct;
+            groups.unrank(rank, direct);
+            ASSERT_EQ(direct, walked) << "k=" << k << " rank=" << rank;
+            EXPECT_EQ(groups.rank(direct), rank);
+            for (int i = 1; i < k; ++i) EXPECT_LT(direct[i - 1], direct[i]);
+            EXPECT_EQ(groups.next(walked), rank + 1 < groups.size());
+        }
+    }
+}
+
+TEST(CombinationsTests, LargePoolTest) {
+    // 2000 стратегий - 1.3 млрд троек, список не строится
+    Combinations triplets(2000, 3);
+    EXPECT_EQ(triplets.size(), 1331334000ULL);
+    
+    std::vector<uint32_t> last;
+    triplets.unrank(triplets.size() - 1, last);
+    EXPECT_EQ(last, (std::vector<uint32_t>{1997, 1998, 1999}));
+    
+    for (uint64_t rank : {0ULL, 1ULL, 123456789ULL, 999999999ULL, 1331333998ULL}) {
+        std::vector<uint32_t> group;
+        triplets.unrank(rank, group);
+        EXPECT_EQ(triplets.rank(group), rank);
+    }
+}
+
+TEST(TournamentTests, AliasesKeepSeparateRowsTest) {
+    Tournament tournament({"tft", "coop", "titfortat", "def"}, 50);
+    EXPECT_EQ(tournament.getGroupCount(), 4u);
+    EXPECT_EQ(tournament.getGroup(0), (std::vector<std::string>{"coop", "def", "tft"}));
+    tournament.setAnalytic(true);
+    tournament.run();
+    
+    // Ни одной пустой строки под псевдонимом
+    auto scores = tournament.getScores();
+    ASSERT_EQ(scores.size(), 4u);
+    EXPECT_GT(scores.at("TitForTat (tft)"), 0);
+    EXPECT_EQ(scores.at("TitForTat (tft)"), scores.at("TitForTat (titfortat)"));
+    EXPECT_GT(scores.at("AlwaysDefect"), scores.at("AlwaysCooperate"));
+}
+
+TEST(TournamentTests, ShardsMergeToFullRunTest) {
+    std::vector<std::string> names = {"tft", "random", "coop", "def", "ff", "ad"};
+    
+    Tournament full(names, 200);
+    full.setAnalytic(true);
+    full.run();
+    
+    // Три шарда через файлы частичных результатов
+    std::vector<PartialResults> parts;
+    for (int shard = 0; shard < 3; ++shard) {
+        Tournament part(names, 200);
+        part.setAnalytic(true);
+        part.setShard(shard, 3);
+        part.run();
+        
+        std::string file = PartialResults::shardFileName(".", shard, 3);
+        ASSERT_TRUE(part.getPartialResults().save(file));
+        PartialResults loaded;
+        ASSERT_TRUE(loaded.load(file));
+        std::remove(file.c_str());
+        EXPECT_EQ(loaded.scores, part.getPartialResults().scores);
+        parts.push_back(loaded);
+    }
+    
+    Tournament merged(parts[0].strategyNames, parts[0].rounds);
+    merged.setAnalytic(true);
+    ASSERT_TRUE(merged.mergeResults(parts));
+    EXPECT_EQ(merged.getScores(), full.getScores());
+    
+    // Шард с другой матрицей выигрышей не складывается
+    EXPECT_NE(parts[0].matrixHash, 0u);
+    Tournament otherMatrix(parts[0].strategyNames, parts[0].rounds);
+    parts[1].matrixHash ^= 1;
+    EXPECT_FALSE(otherMatrix.mergeResults(parts));
+    parts[1].matrixHash ^= 1;
+    
+    // Пропущенный шард обнаруживается
+    Tournament incomplete(parts[0].strategyNames, parts[0].rounds);
+    parts.pop_back();
+    EXPECT_FALSE(incomplete.mergeResults(parts));
+}
+
+TEST(TournamentTests, WorkerExceptionReachesCallerTest) {
+    // Стратегия без makeMove бросает logic_error в потоке игры;
+    // исключение должно дойти до вызывающего, а не завершить процесс
+    class Broken : public Strategy {
+    public:
+        std::string getName() const override { return "Broken"; }
+    };
+    StrategyFactory::getInstance().registerStrategy("broken_test", []() -> std::unique_ptr<Strategy> {
+        return std::make_unique<Broken>();
+    });
+    std::vector<std::string> names = {"broken_test", "coop", "def", "ff", "random", "tft"};
+    
+    for (int threads : {1, 4}) {
+        Tournament tournament(names, 20);
+        tournament.setThreads(threads);
+        EXPECT_THROW(tournament.run(), std::logic_error) << threads;
+        EXPECT_THROW(tournament.computePayoffTensor(), std::logic_error) << threads;
+    }
+}
+
+TEST(TournamentTests, CheckpointResumeMatchesFullRunTest) {
+    std::vector<std::string> names = {"tft", "random", "coop", "def", "ff", "ad"};
+    std::string file = Checkpoint::fileName(".", 0, 1);
+    
+    Tournament full(names, 200);
+    full.setAnalytic(true);
+    full.run();
+    
+    // Остановка до первого блока оставляет пустую контрольную точку
+    Tournament stopped(names, 200);
+    stopped.setAnalytic(true);
+    stopped.setCheckpoint(file, 0);
+    Tournament::requestStop();
+    stopped.run();
+    Tournament::clearStopRequest();
+    EXPECT_TRUE(stopped.wasInterrupted());
+    Checkpoint empty;
+    ASSERT_TRUE(empty.load(file));
+    EXPECT_EQ(empty.completedChunks(), 0u);
+    
+    // Первая половина групп (шард 0/2) записана как выполненный блок
+    Tournament half(names, 200);
+    half.setAnalytic(true);
+    half.setShard(0, 2);
+    half.run();
+    uint64_t begin = 0, end = 0;
+    half.getShardRange(begin, end);
+    ASSERT_EQ(full.getGroupCount(), 2 * end);
+    
+    Checkpoint checkpoint;
+    checkpoint.results = stopped.getPartialResults();
+    checkpoint.results.scores = half.getPartialResults().scores;
+    checkpoint.chunkSize = end;
+    checkpoint.done = {1, 0};
+    ASSERT_TRUE(checkpoint.save(file));
+    
+    Checkpoint loaded;
+    ASSERT_TRUE(loaded.load(file));
+    EXPECT_EQ(loaded.chunkSize, end);
+    EXPECT_EQ(loaded.done, checkpoint.done);
+    EXPECT_EQ(loaded.results.scores, checkpoint.results.scores);
+    
+    Tournament resumed(names, 200);
+    resumed.setAnalytic(true);
+    resumed.setCheckpoint(file, 0);
+    resumed.setResume(true);
+    resumed.run();
+    EXPECT_FALSE(resumed.wasInterrupted());
+    EXPECT_EQ(resumed.getScores(), full.getScores());
+    
+    // После полного прохода контрольная точка удаляется
+    EXPECT_FALSE(loaded.load(file));
+}
+
+// Тесты ReplicatorDynamics
+TEST(ReplicatorDynamicsTests, DominantStrategyTakesOverTest) {
+    // Стратегия 1 всегда получает 5, стратегия 0 - 3
+    std::vector<double> tensor(8, 3.0);
+    for (size_t cell = 4; cell < 8; ++cell) tensor[cell] = 5.0;
+    ReplicatorDynamics dynamics(2, tensor);
+    
+    EXPECT_DOUBLE_EQ(dynamics.getMeanFitness(), 4.0);
+    ASSERT_TRUE(dynamics.step());
+    EXPECT_DOUBLE_EQ(dynamics.getShares()[0], 0.375);
+    EXPECT_DOUBLE_EQ(dynamics.getShares()[1], 0.625);
+    
+    for (int generation = 1; generation < 100; ++generation) {
+        ASSERT_TRUE(dynamics.step());
+    }
+    EXPECT_EQ(dynamics.getGeneration(), 100);
+    EXPECT_GT(dynamics.getShares()[1], 0.999);
+    EXPECT_NEAR(dynamics.getShares()[0] + dynamics.getShares()[1], 1.0, 1e-12);
+    
+    EXPECT_FALSE(dynamics.setShares({1.0}));
+    ASSERT_TRUE(dynamics.setShares({3.0, 1.0}));
+    EXPECT_DOUBLE_EQ(dynamics.getShares()[0], 0.75);
+    EXPECT_EQ(dynamics.getGeneration(), 0);
+}
+
+TEST(ReplicatorDynamicsTests, FitnessContractsBothOpponentsTest) {
+    // A[i][j][k] = i + 10 j + 100 k: f_i = i + 110 * sum_j x_j j
+    const size_t n = 3;
+    std::vector<double> tensor(n * n * n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+            for (size_t k = 0; k < n; ++k)
+                tensor[(i * n + j) * n + k] = i + 10.0 * j + 100.0 * k;
+    ReplicatorDynamics dynamics(n, tensor);
+    ASSERT_TRUE(dynamics.setShares({0.5, 0.25, 0.25}));
+    
+    double meanOpponent = 0.25 * 1 + 0.25 * 2;
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(dynamics.getFitness()[i], i + 110.0 * meanOpponent, 1e-12);
+    }
+}
+
+TEST(ReplicatorDynamicsTests, TournamentTensorMatchesMatrixTest) {
+    Tournament tournament({"coop", "def"}, 10);
+    tournament.setAnalytic(true);
+    auto tensor = tournament.computePayoffTensor();
+    ASSERT_EQ(tensor.size(), 8u);
+    
+    // ID по алфавиту: coop = 0, def = 1
+    GameMatrix matrix;
+    const Move C = Move::COOPERATE, D = Move::DEFECT;
+    EXPECT_DOUBLE_EQ(tensor[0], matrix.getPayoff(C, C, C, 0));
+    EXPECT_DOUBLE_EQ(tensor[1], matrix.getPayoff(C, C, D, 0));
+    EXPECT_DOUBLE_EQ(tensor[2], matrix.getPayoff(C, C, D, 0));
+    EXPECT_DOUBLE_EQ(tensor[4], matrix.getPayoff(D, C, C, 0));
+    EXPECT_DOUBLE_EQ(tensor[7], matrix.getPayoff(D, D, D, 0));
+    
+    // Предатели вытесняют сотрудничающих
+    ReplicatorDynamics dynamics(2, tensor);
+    for (int generation = 0; generation < 50; ++generation) {
+        ASSERT_TRUE(dynamics.step());
+    }
+    EXPECT_GT(dynamics.getShares()[1], 0.99);
+}
+
+// Тесты NeighborGraph и SpatialGame
+TEST(SpatialTests, LatticeNeighborsTest) {
+    auto graph = NeighborGraph::lattice(3, 3);
+    ASSERT_EQ(graph.getVertexCount(), 9u);
+    EXPECT_EQ(graph.getEdgeCount(), 18u);
+    for (uint32_t v = 0; v < 9; ++v) {
+        EXPECT_EQ(graph.degree(v), 4u);
+    }
+    // Соседи через край тора
+    std::vector<uint32_t> corner(graph.begin(0), graph.end(0));
+    EXPECT_EQ(corner, (std::vector<uint32_t>{1, 2, 3, 6}));
+    
+    auto moore = NeighborGraph::lattice(4, 4, true);
+    EXPECT_EQ(moore.degree(5), 8u);
+}
+
+TEST(SpatialTests, EdgeListTest) {
+    {
+        std::ofstream file("test_edges.txt");
+        file << "# triangle\n0 1\n1 2  # comment\n2 0\n0 1\n\n3 3\n";
+    }
+    NeighborGraph graph;
+    ASSERT_TRUE(graph.loadEdgeList("test_edges.txt"));
+    std::remove("test_edges.txt");
+    
+    // Повторное ребро и петля отброшены
+    EXPECT_EQ(graph.getVertexCount(), 4u);
+    EXPECT_EQ(graph.getEdgeCount(), 3u);
+    EXPECT_EQ(graph.degree(0), 2u);
+    EXPECT_EQ(graph.degree(3), 0u);
+    EXPECT_FALSE(graph.loadEdgeList("missing_edges.txt"));
+}
+
+TEST(SpatialTests, ScoresSumNeighborPairsTest) {
+    // Симметричный по соперникам A[i][j][k] = 1 + i + 10 (j + k) + 100 j k
+    std::vector<double> tensor(8);
+    for (int cell = 0; cell < 8; ++cell) {
+        int j = (cell >> 1) & 1, k = cell & 1;
+        tensor[cell] = 1 + (cell >> 2) + 10 * (j + k) + 100 * j * k;
+    }
+    auto at = [&](int i, int j, int k) { return tensor[(i * 2 + j) * 2 + k]; };
+    
+    // Звезда: центр 0 и три листа - перебор пар
+    NeighborGraph star;
+    star.setEdges(4, {{0, 1}, {0, 2}, {0, 3}});
+    SpatialGame small(star, 2, tensor);
+    small.setStrategies({0, 1, 0, 1});
+    small.computeScores();
+    EXPECT_DOUBLE_EQ(small.getScores()[0], at(0, 1, 0) + at(0, 1, 1) + at(0, 0, 1));
+    EXPECT_DOUBLE_EQ(small.getScores()[1], 0.0);
+    
+    // Двенадцать листьев - подсчёт по стратегиям
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::vector<SpatialGame::StrategyId> initial = {1};
+    for (uint32_t leaf = 1; leaf <= 12; ++leaf) {
+        edges.emplace_back(0, leaf);
+        initial.push_back(leaf % 3 == 0 ? 1 : 0);
+    }
+    NeighborGraph big;
+    big.setEdges(13, edges);
+    SpatialGame large(big, 2, tensor);
+    large.setStrategies(initial);
+    large.computeScores();
+    
+    double expected = 0.0;
+    for (uint32_t a = 1; a <= 12; ++a) {
+        for (uint32_t b = a + 1; b <= 12; ++b) {
+            expected += at(1, initial[a], initial[b]);
+        }
+    }
+    EXPECT_NEAR(large.getScores()[0], expected, 1e-9);
+}
+
+TEST(SpatialTests, ImitationSpreadsAndIgnoresThreadsTest) {
+    // Стратегия 1 всегда получает больше
+    std::vector<double> tensor = {3, 3, 3, 3, 5, 5, 5, 5};
+    auto graph = NeighborGraph::lattice(9, 9);
+    SpatialGame population(graph, 2, tensor);
+    std::vector<SpatialGame::StrategyId> initial(81, 0);
+    initial[40] = 1;
+    population.setStrategies(initial);
+    
+    population.step();
+    EXPECT_EQ(population.countStrategies()[1], 5u);
+    for (int generation = 1; generation < 8; ++generation) {
+        population.step();
+    }
+    EXPECT_EQ(population.countStrategies()[1], 81u);
+    
+    // Синхронное обновление не зависит от числа потоков
+    auto lattice = NeighborGraph::lattice(96, 96);
+    std::vector<double> mixed = {3, 0, 0, 5, 1, 4, 4, 1};
+    SpatialGame serial(lattice, 2, mixed);
+    SpatialGame parallel(lattice, 2, mixed);
+    serial.seedUniform(42);
+    parallel.seedUniform(42);
+    parallel.setThreads(4);
+    for (int generation = 0; generation < 5; ++generation) {
+        serial.step();
+        parallel.step();
+    }
+    EXPECT_EQ(serial.getStrategies(), parallel.getStrategies());
+    EXPECT_EQ(serial.getScores(), parallel.getScores());
+}
+
+TEST(TournamentTests, ResultCacheIncrementalTest) {
+    const std::string cacheFile = "test_game_cache.txt";
+    std::remove(cacheFile.c_str());
+    std::vector<std::string> names = {"coop", "def", "ff", "tft"};
+    
+    Tournament first(names, 100);
+    first.setAnalytic(true);
+    first.setCacheFile(cacheFile);
+    first.run();
+    EXPECT_EQ(first.getCacheHits(), 0u);
+    EXPECT_EQ(first.getCachePlayed(), 4u);
+    
+    // Новичок: играются только 6 групп с его участием
+    names.push_back("random");
+    Tournament grown(names, 100);
+    grown.setAnalytic(true);
+    grown.setCacheFile(cacheFile);
+    grown.run();
+    EXPECT_EQ(grown.getCacheHits(), 4u);
+    EXPECT_EQ(grown.getCachePlayed(), 6u);
+    
+    Tournament uncached(names, 100);
+    uncached.setAnalytic(true);
+    uncached.run();
+    EXPECT_EQ(grown.getScores(), uncached.getScores());
+    
+    ResultCache reopened;
+    ASSERT_TRUE(reopened.open(cacheFile));
+    EXPECT_EQ(reopened.size(), 10u);
+    std::remove(cacheFile.c_str());
+}
+
+TEST(TournamentTests, ResultCacheConfigEditTest) {
+    const std::string dir = "test_cache_configs";
+    const std::string cacheFile = dir + "/game_cache.txt";
+    std::filesystem::create_directory(dir);
+    auto writeConfig = [&](const char* firstMove) {
+        std::ofstream file(dir + "/titfortat.cfg");
+        file << "use_forgiveness=false\nfirst_move=" << firstMove << "\n";
+    };
+    auto& factory = StrategyFactory::getInstance();
+    std::vector<std::string> names = {"coop", "def", "ff", "tft"};
+    
+    writeConfig("C");
+    factory.clearPrototypes();
+    Tournament before(names, 50, dir);
+    before.setCacheFile(cacheFile);
+    before.run();
+    EXPECT_EQ(before.getCachePlayed(), 4u);
+    
+    // Правка конфигурации TitForTat затрагивает только три группы с ним
+    writeConfig("D");
+    factory.clearPrototypes();
+    Tournament after(names, 50, dir);
+    after.setCacheFile(cacheFile);
+    after.run();
+    EXPECT_EQ(after.getCacheHits(), 1u);
+    EXPECT_EQ(after.getCachePlayed(), 3u);
+    
+    // Другое число раундов - другие ключи
+    Tournament longer(names, 60, dir);
+    longer.setCacheFile(cacheFile);
+    longer.run();
+    EXPECT_EQ(longer.getCacheHits(), 0u);
+    
+    // Детерминированные группы не зависят от зерна, случайные - зависят
+    std::vector<std::string> mixed = {"coop", "def", "tft", "random"};
+    auto seeded = [&](uint64_t value) {
+        Tournament tournament(mixed, 50, dir);
+        tournament.setSeed(value);
+        tournament.setCacheFile(cacheFile);
+        tournament.run();
+        return tournament.getCacheHits();
+    };
+    seeded(1);
+    EXPECT_EQ(seeded(2), 1u);
+    EXPECT_EQ(seeded(1), 4u);
+    
+    factory.clearPrototypes();
+    std::filesystem::remove_all(dir);
+}
+
+TEST(RandomStreamTests, PhiloxKnownAnswerTest) {
+    // Контрольные векторы Random123 для Philox4x32-10
+    const uint32_t zeroCounter[4] = {0, 0, 0, 0};
+    const uint32_t zeroKey[2] = {0, 0};
+    uint32_t out[4];
+    RandomStream::generate(zeroCounter, zeroKey, out);
+    EXPECT_EQ(out[0], 0x6627e8d5u);
+    EXPECT_EQ(out[1], 0xe169c58du);
+    EXPECT_EQ(out[2], 0xbc57ac4cu);
+    EXPECT_EQ(out[3], 0x9b00dbd8u);
+    
+    const uint32_t piCounter[4] = {0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u};
+    const uint32_t piKey[2] = {0xa4093822u, 0x299f31d0u};
+    RandomStream::generate(piCounter, piKey, out);
+    EXPECT_EQ(out[0], 0xd16cfe09u);
+    EXPECT_EQ(out[1], 0x94fdccebu);
+    EXPECT_EQ(out[2], 0x5001e420u);
+    EXPECT_EQ(out[3], 0x24126ea1u);
+    
+    // Поток - функция (seed, game, replica, seat)
+    RandomStream a(42, 7, 1, 2), b(42, 7, 1, 2), otherSeat(42, 7, 1, 0), otherReplica(42, 7, 0, 2);
+    bool seatDiffers = false, replicaDiffers = false;
+    for (int i = 0; i < 16; ++i) {
+        uint32_t value = a.nextUint32();
+        EXPECT_EQ(value, b.nextUint32());
+        seatDiffers |= value != otherSeat.nextUint32();
+        replicaDiffers |= value != otherReplica.nextUint32();
+    }
+    EXPECT_TRUE(seatDiffers);
+    EXPECT_TRUE(replicaDiffers);
+}
+
+TEST(TournamentTests, SeedReproducesRandomGamesTest) {
+    std::vector<std::string> names = {"adaptive", "coop", "def", "random", "tft"};
+    
+    auto run = [&](uint64_t seed, int threads, int replicas) {
+        Tournament tournament(names, 200);
+        tournament.setSeed(seed);
+        tournament.setThreads(threads);
+        tournament.setReplicas(replicas);
+        tournament.run();
+        return tournament.getScores();
+    };
+    
+    // Одиночные игры (Game) и пакет повторов (BatchGame)
+    for (int replicas : {1, 3}) {
+        auto single = run(7, 1, replicas);
+        EXPECT_EQ(run(7, 4, replicas), single);
+        EXPECT_EQ(run(7, 16, replicas), single);
+        EXPECT_NE(run(8, 1, replicas), single);
+    }
+}
+
+TEST(TournamentTests, SeededCacheMatchesFreshRunTest) {
+    // Поток игры зависит от состава группы, а не от её ранга, поэтому
+    // сохранённые игры со случайными стратегиями совпадают с новыми
+    const std::string cacheFile = "test_seeded_cache.txt";
+    std::remove(cacheFile.c_str());
+    std::vector<std::string> names = {"adaptive", "def", "random", "tft"};
+    
+    Tournament first(names, 100);
+    first.setSeed(11);
+    first.setCacheFile(cacheFile);
+    first.run();
+    
+    names.push_back("coop");
+    Tournament grown(names, 100);
+    grown.setSeed(11);
+    grown.setCacheFile(cacheFile);
+    grown.run();
+    EXPECT_EQ(grown.getCacheHits(), 4u);
+    
+    Tournament fresh(names, 100);
+    fresh.setSeed(11);
+    fresh.run();
+    EXPECT_EQ(grown.getScores(), fresh.getScores());
+    
+    // Другое зерно - другие ключи
+    Tournament reseeded(names, 100);
+    reseeded.setSeed(12);
+    reseeded.setCacheFile(cacheFile);
+    reseeded.run();
+    EXPECT_EQ(reseeded.getCacheHits(), 0u);
+    std::remove(cacheFile.c_str());
+}
+
+TEST(RandomStreamTests, BufferedDrawsMatchBlocksTest) {
+    // Буфер из BUFFER_BLOCKS блоков - те же слова, что поблочный generate
+    const uint32_t key[2] = {0x12345678u, 0x9abcdef0u};
+    uint32_t counter[4] = {0xfffffff8u, 2, 9, 0};
+    uint32_t blocks[RandomStream::BUFFER_WORDS], block[4];
+    RandomStream::generateBlocks(counter, key, blocks);
+    for (int b = 0; b < RandomStream::BUFFER_BLOCKS; ++b) {
+        uint32_t single[4] = {0xfffffff8u + static_cast<uint32_t>(b), 2, 9, 0};
+        RandomStream::generate(single, key, block);
+        for (int w = 0; w < 4; ++w) {
+            EXPECT_EQ(blocks[4 * b + w], block[w]);
+        }
+    }
+    
+    // Крайние вероятности и частота битов
+    RandomStream draws(1);
+    int ones = 0, hits = 0;
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_FALSE(draws.bernoulli(0.0));
+        EXPECT_TRUE(draws.bernoulli(1.0));
+        ones += draws.nextBit();
+        hits += draws.bernoulli(0.1);
+    }
+    EXPECT_NEAR(ones, 5000, 300);
+    EXPECT_NEAR(hits, 1000, 150);
+}
+
+namespace {
+    size_t countLines(const std::string& filename, const std::string& marker) {
+        std::ifstream file(filename);
+        std::string line;
+        size_t count = 0;
+        while (std::getline(file, line)) {
+            if (line.find(marker) != std::string::npos) count++;
+        }
+        return count;
+    }
+}
+
+TEST(LoggerTests, SampledRoundsReachFileTest) {
+    const std::string dir = "test_logger_dir";
+    std::filesystem::create_directory(dir);
+    std::remove((dir + "/game_log.txt").c_str());
+    {
+        Logger logger(dir);
+        logger.setRoundSampling(10);
+        Game game(95);
+        game.setCycleDetection(false);
+        game.addPlayer(std::make_unique<AlwaysCooperate>());
+        game.addPlayer(std::make_unique<AlwaysDefect>());
+        game.addPlayer(std::make_unique<FiftyFifty>());
+        uint32_t id = logger.logGameStart(game.getPlayerNames(), 95);
+        game.setLogger(&logger, id);
+        game.playGame();
+        logger.logGameEnd(game.getPlayerNames(), game.getScores(), id);
+        logger.flush();
+        
+        // Раунды 0, 10, ..., 90
+        EXPECT_EQ(countLines(dir + "/game_log.txt", "| Round "), 10u);
+        EXPECT_EQ(countLines(dir + "/game_log.txt", "Round 90 | AlwaysCooperate=C(3) AlwaysDefect=D(9) FiftyFifty=C(3)"), 1u);
+        EXPECT_EQ(countLines(dir + "/game_log.txt", "GAME ENDED"), 1u);
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST(LoggerTests, FullBufferDropsOnlyRoundsTest) {
+    const std::string dir = "test_logger_drop_dir";
+    std::filesystem::create_directory(dir);
+    std::remove((dir + "/game_log.txt").c_str());
+    const int rounds = 20000;
+    uint64_t dropped = 0;
+    {
+        // Два места: фоновый поток разбирает буфер раз в 10 мс и не
+        // успевает за раундами, часть из них неизбежно отбрасывается
+        Logger logger(dir, 2);
+        logger.setRoundSampling(1);
+        std::vector<Move> moves = {Move::COOPERATE, Move::DEFECT, Move::COOPERATE};
+        std::vector<int> scores = {1, 2, 3};
+        std::vector<long long> totals = {1, 2, 3};
+        uint32_t id = logger.logGameStart({"A", "B", "C"}, rounds);
+        for (int round = 0; round < rounds; ++round) {
+            logger.logRound(id, round, moves, scores, totals);
+        }
+        logger.logGameEnd({"A", "B", "C"}, totals, id);
+        dropped = logger.getDroppedRounds();
+    }
+    // Каждый раунд либо записан, либо учтён как отброшенный;
+    // события игры не теряются
+    EXPECT_GT(dropped, 0u);
+    std::string file = dir + "/game_log.txt";
+    EXPECT_EQ(countLines(file, "| Round ") + dropped, static_cast<size_t>(rounds));
+    EXPECT_EQ(countLines(file, "GAME STARTED"), 1u);
+    EXPECT_EQ(countLines(file, "GAME ENDED"), 1u);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(GameTraceTests, EncoderReaderRoundTripTest) {
+    const std::string traceFile = "test_trace.pdt";
+    std::remove(traceFile.c_str());
+    
+    // Длинные серии (RLE) и случайные исходы (упаковка по 3 бита);
+    // длины не кратны блоку
+    std::vector<std::vector<int>> games(2);
+    for (int r = 0; r < 10000; ++r) {
+        games[0].push_back(r < 9000 ? 0 : (r < 9990 ? 7 : r % 8));
+    }
+    RandomStream stream(5);
+    for (int r = 0; r < 5000; ++r) {
+        games[1].push_back(static_cast<int>(stream.nextUint32() & 7));
+    }
+    
+    {
+        TraceWriter writer;
+        ASSERT_TRUE(writer.open(traceFile, {"coop", "def", "tft"}, 42, 99));
+        TraceEncoder encoder;
+        for (size_t g = 0; g < games.size(); ++g) {
+            for (int outcome : games[g]) encoder.add(outcome);
+            const uint32_t ids[3] = {0, 1, static_cast<uint32_t>(g + 1)};
+            writer.append(encoder.finish(ids, static_cast<uint32_t>(g)));
+        }
+        EXPECT_EQ(writer.getGameCount(), 2u);
+    }
+    // 5000 случайных исходов - 1875 байт; 10000 раундов почти из
+    // двух серий - несколько десятков байт
+    auto size = std::filesystem::file_size(traceFile);
+    EXPECT_LT(size, 2100u);
+    
+    TraceReader reader;
+    ASSERT_TRUE(reader.open(traceFile));
+    EXPECT_EQ(reader.getSeed(), 42u);
+    EXPECT_EQ(reader.getMatrixHash(), 99u);
+    EXPECT_EQ(reader.getStrategyNames(), (std::vector<std::string>{"coop", "def", "tft"}));
+    ASSERT_EQ(reader.getGameCount(), 2u);
+    for (size_t g = 0; g < games.size(); ++g) {
+        EXPECT_EQ(reader.getGame(g).rounds, games[g].size());
+        EXPECT_EQ(reader.getGame(g).ids[2], g + 1);
+        EXPECT_EQ(reader.getGame(g).replica, g);
+        
+        std::vector<int> runs;
+        reader.forEachRun(g, [&](int outcome, uint64_t length) {
+            runs.insert(runs.end(), length, outcome);
+        });
+        EXPECT_EQ(runs, games[g]);
+        for (size_t r = 0; r < games[g].size(); r += 7) {
+            EXPECT_EQ(reader.outcome(g, r), games[g][r]);
+        }
+        EXPECT_EQ(reader.outcome(g, games[g].size()), -1);
+    }
+    reader.close();
+    
+    // Оборванная последняя запись пропускается
+    std::filesystem::resize_file(traceFile, size - 5);
+    ASSERT_TRUE(reader.open(traceFile));
+    EXPECT_EQ(reader.getGameCount(), 1u);
+    reader.close();
+    std::remove(traceFile.c_str());
+}
+
+TEST(GameTraceTests, EncoderCycleMatchesRoundsTest) {
+    const uint32_t ids[3] = {0, 1, 2};
+    // Цикл дописывается с середины блока и заканчивается не на границе
+    for (size_t length : {1u, 3u, 7u, 100u}) {
+        std::vector<uint8_t> cycle;
+        for (size_t i = 0; i < length; ++i) cycle.push_back(static_cast<uint8_t>((i * 5 + 1) % 8));
+        TraceEncoder rounds, cycles;
+        for (int r = 0; r < 1000; ++r) {
+            rounds.add(r % 8);
+            cycles.add(r % 8);
+        }
+        for (uint64_t r = 0; r < 30000; ++r) rounds.add(cycle[r % length]);
+        cycles.addCycle(cycle.data(), cycle.size(), 30000);
+        EXPECT_EQ(cycles.getRounds(), rounds.getRounds());
+        EXPECT_EQ(cycles.finish(ids, 0), rounds.finish(ids, 0)) << "cycle length " << length;
+    }
+    
+    // Миллиард раундов одного исхода без поштучного добавления
+    TraceEncoder encoder;
+    encoder.addRun(7, 1000000000ull);
+    EXPECT_EQ(encoder.getRounds(), 1000000000ull);
+    EXPECT_LT(encoder.finish(ids, 0).size(), 4000000u);
+}
+
+TEST(TournamentTests, TraceReproducesScoresTest) {
+    // Очки, пересчитанные по исходам трассы, совпадают с очками турнира:
+    // и для перемотанных циклов, и для пакета повторов
+    const std::string traceFile = "test_tournament_trace.pdt";
+    std::vector<std::string> names = {"coop", "def", "random", "tft"};
+    int flat[PayoffTable::OUTCOMES * PayoffTable::SEATS];
+    GameMatrix().getFlatTable(flat);
+    
+    for (int replicas : {1, 3}) {
+        std::remove(traceFile.c_str());
+        Tournament tournament(names, 1000);
+        tournament.setSeed(3);
+        tournament.setReplicas(replicas);
+        tournament.setTraceFile(traceFile);
+        tournament.run();
+        EXPECT_EQ(tournament.getTracedGames(), 4u * replicas);
+        
+        TraceReader reader;
+        ASSERT_TRUE(reader.open(traceFile));
+        EXPECT_EQ(reader.getSeed(), 3u);
+        ASSERT_EQ(reader.getGameCount(), 4u * replicas);
+        std::vector<long long> scores(names.size(), 0);
+        for (size_t g = 0; g < reader.getGameCount(); ++g) {
+            const auto& game = reader.getGame(g);
+            EXPECT_EQ(game.rounds, 1000u);
+            reader.forEachRun(g, [&](int outcome, uint64_t length) {
+                for (int seat = 0; seat < 3; ++seat) {
+                    scores[game.ids[seat]] += flat[outcome * 3 + seat] * static_cast<long long>(length);
+                }
+            });
+        }
+        auto labels = tournament.getLabels();
+        for (size_t id = 0; id < names.size(); ++id) {
+            EXPECT_EQ(scores[id], tournament.getScores()[labels[id]]) << labels[id];
+        }
+        reader.close();
+    }
+    std::remove(traceFile.c_str());
+}
+
+TEST(TournamentTests, DeterministicReplicasFastForwardTest) {
+    // Сто миллионов раундов x 4 повтора: детерминированная тройка
+    // играется один раз с перемоткой, а не раунд за раундом в пакете
+    const std::string dir = "test_replicas_configs";
+    const std::string traceFile = dir + "/trace.pdt";
+    const std::string resultsFile = dir + "/results.pdr";
+    std::filesystem::create_directory(dir);
+    {
+        // TitForTat без прощения детерминирован
+        std::ofstream file(dir + "/titfortat.cfg");
+        file << "use_forgiveness=false\n";
+    }
+    auto& factory = StrategyFactory::getInstance();
+    factory.clearPrototypes();
+    const int rounds = 100000000;
+    std::vector<std::string> names = {"coop", "def", "tft"};
+    
+    Tournament single(names, rounds, dir);
+    single.run();
+    
+    Tournament replicated(names, rounds, dir);
+    replicated.setReplicas(4);
+    replicated.setTraceFile(traceFile);
+    replicated.setResultsFile(resultsFile);
+    replicated.run();
+    for (const auto& [name, score] : single.getScores()) {
+        EXPECT_EQ(replicated.getScores()[name], 4 * score) << name;
+    }
+    EXPECT_EQ(replicated.getExportedRows(), 4u);
+    
+    TraceReader reader;
+    ASSERT_TRUE(reader.open(traceFile));
+    ASSERT_EQ(reader.getGameCount(), 4u);
+    for (size_t g = 0; g < reader.getGameCount(); ++g) {
+        EXPECT_EQ(reader.getGame(g).replica, g);
+        EXPECT_EQ(reader.getGame(g).rounds, static_cast<uint64_t>(rounds));
+    }
+    reader.close();
+    
+    ResultsReader results;
+    ASSERT_TRUE(results.open(resultsFile));
+    std::vector<int32_t> replicaColumn;
+    ASSERT_TRUE(results.getColumn("replica", replicaColumn));
+    EXPECT_EQ(replicaColumn, (std::vector<int32_t>{0, 1, 2, 3}));
+    
+    std::filesystem::remove_all(dir);
+    factory.clearPrototypes();
+}
+
+TEST(TournamentTests, TraceResumeKeepsFinishedGamesTest) {
+    const std::string traceFile = "test_resume_trace.pdt";
+    std::vector<std::string> names = {"tft", "random", "coop", "def", "ff", "ad"};
+    std::string file = Checkpoint::fileName(".", 0, 1);
+    auto traced = [&](Tournament& tournament) {
+        tournament.setSeed(9);
+        tournament.setTraceFile(traceFile);
+        tournament.setCheckpoint(file, 0);
+        tournament.run();
+    };
+    // Каждая группа встречается в трассе ровно один раз
+    auto expectEachGroupOnce = [&](size_t groupCount) {
+        TraceReader reader;
+        ASSERT_TRUE(reader.open(traceFile));
+        ASSERT_EQ(reader.getGameCount(), groupCount);
+        std::set<std::vector<uint32_t>> groups;
+        for (size_t g = 0; g < reader.getGameCount(); ++g) {
+            const auto& game = reader.getGame(g);
+            groups.insert({game.ids[0], game.ids[1], game.ids[2]});
+        }
+        EXPECT_EQ(groups.size(), groupCount);
+    };
+    
+    // Повторный запуск без --resume переписывает трассу, а не дописывает
+    std::remove(traceFile.c_str());
+    Tournament full(names, 200);
+    traced(full);
+    Tournament stopped(names, 200);
+    Tournament::requestStop();
+    traced(stopped);
+    Tournament::clearStopRequest();
+    Tournament again(names, 200);
+    traced(again);
+    expectEachGroupOnce(full.getGroupCount());
+    
+    // Продолжение: игры невыполненного блока и мусор в хвосте
+    // отбрасываются, блок переигрывается один раз
+    Checkpoint checkpoint;
+    checkpoint.results = stopped.getPartialResults();
+    checkpoint.chunkSize = full.getGroupCount() / 2;
+    checkpoint.done = {1, 0};
+    ASSERT_TRUE(checkpoint.save(file));
+    {
+        std::ofstream tail(traceFile, std::ios::binary | std::ios::app);
+        tail << "garbage";
+    }
+    Tournament resumed(names, 200);
+    resumed.setResume(true);
+    traced(resumed);
+    EXPECT_FALSE(resumed.wasInterrupted());
+    expectEachGroupOnce(full.getGroupCount());
+    
+    std::remove(traceFile.c_str());
+}
+
+TEST(TournamentTests, ResultsTableMatchesScoresTest) {
+    // Строки таблицы складываются в очки турнира; сотрудничество
+    // считается и в одиночных играх, и в пакете повторов
+    const std::string resultsFile = "test_results.pdr";
+    const std::string csvFile = ResultsTable::csvFileName(resultsFile);
+    EXPECT_EQ(csvFile, "test_results.csv");
+    std::vector<std::string> names = {"coop", "def", "random", "tft"};
+    
+    for (int replicas : {1, 3}) {
+        std::remove(resultsFile.c_str());
+        Tournament tournament(names, 500);
+        tournament.setSeed(7);
+        tournament.setReplicas(replicas);
+        tournament.setThreads(2);
+        tournament.setResultsFile(resultsFile);
+        tournament.run();
+        EXPECT_EQ(tournament.getExportedRows(), 4u * replicas);
+        
+        ResultsReader reader;
+        ASSERT_TRUE(reader.open(resultsFile));
+        EXPECT_EQ(reader.getRowCount(), 4u * replicas);
+        EXPECT_EQ(reader.getGroupSize(), 3u);
+        EXPECT_EQ(reader.getRounds(), 500u);
+        EXPECT_EQ(reader.getReplicas(), static_cast<uint32_t>(replicas));
+        EXPECT_EQ(reader.getMatrixHash(), tournament.getPartialResults().matrixHash);
+        EXPECT_EQ(reader.getStrategyNames(), names);
+        
+        std::vector<long long> scores(names.size(), 0);
+        std::vector<uint32_t> ids;
+        std::vector<int64_t> seatScores, cooperations;
+        std::vector<int32_t> replicaColumn;
+        std::vector<uint64_t> seeds;
+        for (int seat = 0; seat < 3; ++seat) {
+            std::string suffix = std::to_string(seat);
+            ASSERT_TRUE(reader.getColumn("id" + suffix, ids));
+            ASSERT_TRUE(reader.getColumn("score" + suffix, seatScores));
+            ASSERT_TRUE(reader.getColumn("coop" + suffix, cooperations));
+            for (size_t row = 0; row < ids.size(); ++row) {
+                scores[ids[row]] += seatScores[row];
+                if (names[ids[row]] == "coop") {
+                    EXPECT_EQ(cooperations[row], 500);
+                }
+                if (names[ids[row]] == "def") {
+                    EXPECT_EQ(cooperations[row], 0);
+                }
+            }
+        }
+        auto labels = tournament.getLabels();
+        for (size_t id = 0; id < names.size(); ++id) {
+            EXPECT_EQ(scores[id], tournament.getScores()[labels[id]]) << labels[id];
+        }
+        ASSERT_TRUE(reader.getColumn("replica", replicaColumn));
+        EXPECT_EQ(*std::max_element(replicaColumn.begin(), replicaColumn.end()), replicas - 1);
+        ASSERT_TRUE(reader.getColumn("seed", seeds));
+        EXPECT_EQ(seeds, std::vector<uint64_t>(seeds.size(), 7));
+        EXPECT_FALSE(reader.getColumn("seed", replicaColumn));
+        EXPECT_FALSE(reader.getColumn("missing", seeds));
+        
+        std::ifstream csv(csvFile);
+        std::string line;
+        std::getline(csv, line);
+        EXPECT_EQ(line, "strategy0,strategy1,strategy2,score0,score1,score2,coop0,coop1,coop2,"
+                        "replica,source,seed,wall_ns");
+        EXPECT_EQ(countLines(csvFile, ","), 1u + 4u * replicas);
+    }
+    
+    // Аналитические тройки - строка на группу с ожиданиями
+    std::remove(resultsFile.c_str());
+    Tournament analytic({"coop", "def", "tft"}, 500);
+    analytic.setAnalytic(true);
+    analytic.setReplicas(2);
+    analytic.setResultsFile(resultsFile);
+    analytic.run();
+    ResultsReader reader;
+    ASSERT_TRUE(reader.open(resultsFile));
+    ASSERT_EQ(reader.getRowCount(), 1u);
+    std::vector<uint8_t> sources;
+    std::vector<int64_t> cooperations;
+    ASSERT_TRUE(reader.getColumn("source", sources));
+    ASSERT_TRUE(reader.getColumn("coop0", cooperations));
+    EXPECT_EQ(sources[0], ResultsTable::ANALYTIC);
+    EXPECT_EQ(cooperations[0], 1000);
+    
+    std::remove(resultsFile.c_str());
+    std::remove(csvFile.c_str());
+}
+
+TEST(TournamentTests, ResultsResumeKeepsFinishedGamesTest) {
+    const std::string resultsFile = "test_resume_results.pdr";
+    const std::string csvFile = ResultsTable::csvFileName(resultsFile);
+    std::vector<std::string> names = {"tft", "random", "coop", "def", "ff", "ad"};
+    std::string file = Checkpoint::fileName(".", 0, 1);
+    auto exported = [&](Tournament& tournament) {
+        tournament.setSeed(9);
+        tournament.setResultsFile(resultsFile);
+        tournament.setCheckpoint(file, 0);
+        tournament.run();
+    };
+    // Каждая группа встречается в таблице и в CSV ровно один раз
+    auto expectEachGroupOnce = [&](size_t groupCount) {
+        ResultsReader reader;
+        ASSERT_TRUE(reader.open(resultsFile));
+        ASSERT_EQ(reader.getRowCount(), groupCount);
+        std::vector<std::vector<uint32_t>> ids(3);
+        for (int seat = 0; seat < 3; ++seat) {
+            ASSERT_TRUE(reader.getColumn("id" + std::to_string(seat), ids[seat]));
+        }
+        std::set<std::vector<uint32_t>> groups;
+        for (size_t row = 0; row < groupCount; ++row) {
+            groups.insert({ids[0][row], ids[1][row], ids[2][row]});
+        }
+        EXPECT_EQ(groups.size(), groupCount);
+        EXPECT_EQ(countLines(csvFile, ","), 1u + groupCount);
+    };
+    
+    // Повторный запуск без --resume переписывает таблицу
+    std::remove(resultsFile.c_str());
+    Tournament full(names, 200);
+    exported(full);
+    Tournament stopped(names, 200);
+    Tournament::requestStop();
+    exported(stopped);
+    Tournament::clearStopRequest();
+    Tournament again(names, 200);
+    exported(again);
+    expectEachGroupOnce(full.getGroupCount());
+    
+    // Продолжение: строки невыполненного блока и испорченный хвост
+    // (блок длиннее CHUNK_ROWS) отбрасываются
+    Checkpoint checkpoint;
+    checkpoint.results = stopped.getPartialResults();
+    checkpoint.chunkSize = full.getGroupCount() / 2;
+    checkpoint.done = {1, 0};
+    ASSERT_TRUE(checkpoint.save(file));
+    {
+        std::ofstream tail(resultsFile, std::ios::binary | std::ios::app);
+        const uint32_t chunkRows = ResultsTable::CHUNK_ROWS + 1;
+        tail.write(reinterpret_cast<const char*>(&chunkRows), sizeof(chunkRows));
+        tail << std::string(1 << 20, 'x');
+    }
+    Tournament resumed(names, 200);
+    resumed.setResume(true);
+    exported(resumed);
+    EXPECT_FALSE(resumed.wasInterrupted());
+    expectEachGroupOnce(full.getGroupCount());
+    
+    std::remove(resultsFile.c_str());
+    std::remove(csvFile.c_str());
+}
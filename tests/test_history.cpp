@@ -0,0 +1,402 @@
+#include <gtest/gtest.h>
+#include "core/PackedHistory.h"
+#include "core/HistoryView.h"
+#include "core/History.h"
+#include <filesystem>
+#include <fstream>
+#include <cstdio>
+
+// Тесты PackedHistory
+TEST(PackedHistoryTests, PushAndAccessTest) {
+    PackedHistory history;
+    std::vector<Move> moves;
+    
+    // Больше двух слов, чтобы проверить границы
+    for (int i = 0; i < 150; ++i) {
+        Move move = (i % 3 == 0) ? Move::DEFECT : Move::COOPERATE;
+        history.push_back(move);
+        moves.push_back(move);
+    }
+    
+    EXPECT_EQ(history.size(), 150);
+    for (size_t i = 0; i < moves.size(); ++i) {
+        EXPECT_EQ(history[i], moves[i]);
+    }
+    EXPECT_EQ(history.back(), moves.back());
+    EXPECT_EQ(history.toVector(), moves);
+}
+
+TEST(PackedHistoryTests, RangeCountTest) {
+    PackedHistory history;
+    std::vector<Move> moves;
+    for (int i = 0; i < 200; ++i) {
+        Move move = (i % 5 < 2) ? Move::COOPERATE : Move::DEFECT;
+        history.push_back(move);
+        moves.push_back(move);
+    }
+    
+    // Сравниваем с прямым подсчётом на разных отрезках
+    for (size_t from = 0; from <= 200; from += 13) {
+        for (size_t to = from; to <= 200; to += 7) {
+            size_t expected = 0;
+            for (size_t i = from; i < to; ++i) {
+                if (moves[i] == Move::COOPERATE) expected++;
+            }
+            EXPECT_EQ(history.countCooperations(from, to), expected);
+            EXPECT_EQ(history.countDefections(from, to), (to - from) - expected);
+        }
+    }
+}
+
+TEST(PackedHistoryTests, LastMovesMaskTest) {
+    PackedHistory history;
+    // C D D C ... последний ход в бите 0
+    history.push_back(Move::COOPERATE);
+    history.push_back(Move::DEFECT);
+    history.push_back(Move::DEFECT);
+    history.push_back(Move::COOPERATE);
+    
+    EXPECT_EQ(history.lastMoves(1), 0b1u);
+    EXPECT_EQ(history.lastMoves(4), 0b1001u);
+    EXPECT_EQ(history.lastMoves(10), 0b1001u);
+    
+    // Через границу слова
+    for (int i = 0; i < 62; ++i) history.push_back(Move::DEFECT);
+    history.push_back(Move::COOPERATE);
+    EXPECT_EQ(history.size(), 67);
+    EXPECT_EQ(history.lastMoves(3), 0b001u);
+    EXPECT_EQ(history.lastMoves(64), (uint64_t(1) << 63) | 1u);
+    // Больше 64 - урезается до 64
+    EXPECT_EQ(history.lastMoves(100), history.lastMoves(64));
+}
+
+TEST(PackedHistoryTests, ViewSnapshotTest) {
+    PackedHistory history;
+    history.push_back(Move::COOPERATE);
+    history.push_back(Move::DEFECT);
+    
+    HistoryView view(history);
+    history.push_back(Move::COOPERATE);
+    
+    // Представление видит только раунды на момент создания
+    EXPECT_EQ(view.size(), 2);
+    EXPECT_EQ(view.back(), Move::DEFECT);
+    EXPECT_EQ(view.countCooperations(), 1);
+    EXPECT_EQ(view.lastMoves(2), 0b10u);
+    
+    std::vector<Move> collected;
+    for (Move move : view) collected.push_back(move);
+    EXPECT_EQ(collected, (std::vector<Move>{Move::COOPERATE, Move::DEFECT}));
+}
+
+// Тесты History
+TEST(HistoryTests, ColumnarRoundsTest) {
+    History history;
+    history.addRound({"tft", "def", "coop"}, {Move::COOPERATE, Move::DEFECT, Move::COOPERATE});
+    history.addRound({"tft", "def", "coop"}, {Move::DEFECT, Move::DEFECT, Move::COOPERATE});
+    // Повтор имени в раунде - действует последний ход
+    history.addRound({"tft", "def", "coop", "def"}, {Move::DEFECT, Move::DEFECT, Move::COOPERATE, Move::COOPERATE});
+    
+    EXPECT_EQ(history.getRoundCount(), 3);
+    EXPECT_EQ(history.getPlayerNames(), (std::vector<std::string>{"tft", "def", "coop"}));
+    EXPECT_EQ(history.getPlayerMoves("def").toVector(),
+              (std::vector<Move>{Move::DEFECT, Move::DEFECT, Move::COOPERATE}));
+    EXPECT_EQ(history.getPlayerMoves("tft").countCooperations(), 1u);
+    EXPECT_TRUE(history.getPlayerMoves("unknown").empty());
+    
+    RoundRecord last = {{"coop", Move::COOPERATE}, {"def", Move::COOPERATE}, {"tft", Move::DEFECT}};
+    EXPECT_EQ(history.getLastRound().toRecord(), last);
+    Move move;
+    EXPECT_TRUE(history.getRound(0).getMove("def", move));
+    EXPECT_EQ(move, Move::DEFECT);
+    EXPECT_FALSE(history.getRound(0).getMove("unknown", move));
+    
+    size_t rounds = 0;
+    for (auto round : history.getAllRounds()) {
+        EXPECT_EQ(round.size(), 3u);
+        rounds++;
+    }
+    EXPECT_EQ(rounds, 3u);
+    
+    history.clear();
+    EXPECT_TRUE(history.isEmpty());
+    EXPECT_TRUE(history.getLastRound().empty());
+}
+
+TEST(HistoryTests, PlayersJoinAndSkipRoundsTest) {
+    // Состав раундов меняется; каждый раунд читается таким, каким добавлен
+    History history;
+    std::vector<RoundRecord> expected;
+    const std::vector<std::string> names = {"a", "b", "c", "d"};
+    for (int round = 0; round < 300; ++round) {
+        std::vector<std::string> present;
+        std::vector<Move> moves;
+        RoundRecord record;
+        for (size_t p = 0; p < names.size(); ++p) {
+            // b - с 10-го раунда подряд, c - через раунд, d - пропуски после 100-го
+            bool here = p == 0 || (p == 1 && round >= 10) || (p == 2 && round % 2 == 0) ||
+                        (p == 3 && (round < 100 || round % 7 == 0));
+            if (!here) continue;
+            Move move = (round * 5 + p) % 3 == 0 ? Move::DEFECT : Move::COOPERATE;
+            present.push_back(names[p]);
+            moves.push_back(move);
+            record[names[p]] = move;
+        }
+        history.addRound(present, moves);
+        expected.push_back(record);
+    }
+    
+    size_t round = 0;
+    for (auto view : history.getAllRounds()) {
+        EXPECT_EQ(view.toRecord(), expected[round]) << round;
+        round++;
+    }
+    for (const auto& name : names) {
+        std::vector<Move> column;
+        for (const auto& record : expected) {
+            auto found = record.find(name);
+            if (found != record.end()) column.push_back(found->second);
+        }
+        EXPECT_EQ(history.getPlayerMoves(name).toVector(), column) << name;
+    }
+}
+
+TEST(HistoryTests, ViewSurvivesNewPlayersTest) {
+    // Представление, взятое до прихода новых игроков, остаётся верным
+    History history;
+    history.addRound({"a", "b"}, {Move::DEFECT, Move::COOPERATE});
+    HistoryView view = history.getPlayerMoves("a");
+    for (int player = 0; player < 1000; ++player) {
+        history.intern("p" + std::to_string(player));
+    }
+    ASSERT_EQ(view.size(), 1u);
+    EXPECT_EQ(view[0], Move::DEFECT);
+    
+    // Незнакомый ID - пустое представление
+    EXPECT_TRUE(history.getPlayerMoves(History::PlayerId(5000)).empty());
+}
+
+TEST(HistoryTests, MillionRoundsFitInColumnsTest) {
+    History history;
+    std::vector<History::PlayerId> ids = {history.intern("tft"), history.intern("def"), history.intern("random")};
+    std::vector<Move> moves(3);
+    size_t cooperations = 0;
+    for (int round = 0; round < 1000000; ++round) {
+        moves[0] = Move::COOPERATE;
+        moves[1] = Move::DEFECT;
+        moves[2] = (round % 3 == 0) ? Move::COOPERATE : Move::DEFECT;
+        cooperations += moves[2] == Move::COOPERATE;
+        history.addInternedRound(ids, moves);
+    }
+    
+    // Бит на ход плюс счётчики слов - меньше мегабайта на троих
+    EXPECT_LT(history.memoryUsage(), 1u << 20);
+    EXPECT_EQ(history.getPlayerMoves(ids[2]).countCooperations(), cooperations);
+    EXPECT_EQ(history.getPlayerMoves("def").countDefections(), 1000000u);
+}
+
+TEST(HistoryTests, SaveAndLoadTest) {
+    const std::string dir = "test_history_dir";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directory(dir);
+    
+    History saved(dir);
+    saved.addRound({"tft", "def"}, {Move::COOPERATE, Move::DEFECT});
+    saved.addRound({"tft", "def", "coop"}, {Move::DEFECT, Move::DEFECT, Move::COOPERATE});
+    saved.saveToFile();
+    
+    History loaded(dir);
+    ASSERT_EQ(loaded.getRoundCount(), 2);
+    EXPECT_EQ(loaded.getRound(0).toRecord(), saved.getRound(0).toRecord());
+    EXPECT_EQ(loaded.getRound(1).toRecord(), saved.getRound(1).toRecord());
+    std::filesystem::remove_all(dir);
+}
+
+TEST(HistoryTests, AppendsOnlyNewRoundsTest) {
+    const std::string dir = "test_history_append_dir";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directory(dir);
+    
+    // Несколько сессий: каждая дописывает по сегменту
+    std::vector<uintmax_t> sizes;
+    for (int session = 0; session < 4; ++session) {
+        History history(dir);
+        ASSERT_EQ(history.getRoundCount(), session * 1000);
+        for (int i = 0; i < 1000; ++i) {
+            history.addRound({"tft", "def"}, {(i % 3) ? Move::COOPERATE : Move::DEFECT, Move::DEFECT});
+        }
+        history.saveToFile();
+        history.saveToFile();    // без новых раундов файл не меняется
+        EXPECT_EQ(history.getSegmentCount(), static_cast<size_t>(session + 1));
+        sizes.push_back(std::filesystem::file_size(history.getFileName()));
+    }
+    // Рост линейный: каждая сессия добавляет столько же байт
+    EXPECT_EQ(sizes[2] - sizes[1], sizes[3] - sizes[2]);
+    EXPECT_LT(sizes[3] - sizes[2], 1000u);
+    
+    History loaded(dir);
+    ASSERT_EQ(loaded.getRoundCount(), 4000);
+    EXPECT_EQ(loaded.getPlayerMoves("tft").countDefections(), 4 * 334u);
+    EXPECT_EQ(loaded.getPlayerMoves("def").countCooperations(), 0u);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(HistoryTests, SparsePlayersSurviveReloadTest) {
+    const std::string dir = "test_history_sparse_dir";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directory(dir);
+    
+    History saved(dir);
+    saved.addRound({"a", "b"}, {Move::COOPERATE, Move::DEFECT});
+    saved.saveToFile();
+    saved.addRound({"a", "c"}, {Move::DEFECT, Move::COOPERATE});
+    saved.addRound({"b", "c"}, {Move::COOPERATE, Move::DEFECT});
+    saved.saveToFile();
+    saved.addRound({"c"}, {Move::COOPERATE});
+    saved.saveToFile();
+    
+    History loaded(dir);
+    ASSERT_EQ(loaded.getRoundCount(), saved.getRoundCount());
+    EXPECT_EQ(loaded.getPlayerNames(), saved.getPlayerNames());
+    for (int round = 0; round < saved.getRoundCount(); ++round) {
+        EXPECT_EQ(loaded.getRound(round).toRecord(), saved.getRound(round).toRecord());
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST(HistoryTests, TornTailIsDroppedTest) {
+    const std::string dir = "test_history_torn_dir";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directory(dir);
+    
+    std::string filename;
+    uintmax_t firstSegmentEnd;
+    {
+        History history(dir);
+        history.addRound({"a", "b"}, {Move::COOPERATE, Move::DEFECT});
+        history.saveToFile();
+        filename = history.getFileName();
+        firstSegmentEnd = std::filesystem::file_size(filename);
+        history.addRound({"a", "b"}, {Move::DEFECT, Move::COOPERATE});
+        history.saveToFile();
+    }
+    // Обрыв посреди второго сегмента
+    std::filesystem::resize_file(filename, std::filesystem::file_size(filename) - 3);
+    
+    History history(dir);
+    ASSERT_EQ(history.getRoundCount(), 1);
+    EXPECT_EQ(history.getSegmentCount(), 1u);
+    
+    // Следующее сохранение затирает хвост
+    history.addRound({"a", "c"}, {Move::DEFECT, Move::DEFECT});
+    history.saveToFile();
+    EXPECT_GT(std::filesystem::file_size(filename), firstSegmentEnd);
+    
+    History reloaded(dir);
+    ASSERT_EQ(reloaded.getRoundCount(), 2);
+    Move move;
+    ASSERT_TRUE(reloaded.getRound(1).getMove("c", move));
+    EXPECT_EQ(move, Move::DEFECT);
+    EXPECT_EQ(reloaded.getSegmentCount(), 2u);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(HistoryTests, CorruptFramesAreDroppedTest) {
+    const std::string dir = "test_history_frames_dir";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directory(dir);
+    
+    std::string filename;
+    {
+        History history(dir);
+        history.addRound({"a", "b"}, {Move::COOPERATE, Move::DEFECT});
+        history.saveToFile();
+        filename = history.getFileName();
+    }
+    auto appendFrame = [&](uint32_t size, const std::string& body) {
+        uint32_t sum = 2166136261u;
+        for (unsigned char byte : body) {
+            sum ^= byte;
+            sum *= 16777619u;
+        }
+        std::ofstream file(filename, std::ios::binary | std::ios::app);
+        file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        file.write(reinterpret_cast<const char*>(&sum), sizeof(sum));
+        file << body;
+    };
+    auto put = [](std::string& out, auto value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    uintmax_t validSize = std::filesystem::file_size(filename);
+    
+    // Длина кадра больше остатка файла - хвост отбрасывается без
+    // попытки выделить память под неё
+    appendFrame(0xFFFFFFF0u, "");
+    EXPECT_EQ(History(dir).getRoundCount(), 1);
+    
+    // Биты присутствия отмечают два раунда, а ходов ноль
+    std::filesystem::resize_file(filename, validSize);
+    std::string body;
+    put(body, uint64_t(1));     // первый раунд
+    put(body, uint32_t(2));     // раундов
+    put(body, uint32_t(2));     // первый новый ID
+    put(body, uint32_t(0));     // имён
+    put(body, uint32_t(1));     // столбцов
+    put(body, uint32_t(0));     // ID
+    put(body, uint32_t(0));     // ходов
+    put(body, uint8_t(0));      // не подряд
+    put(body, uint8_t(3));      // присутствие
+    appendFrame(static_cast<uint32_t>(body.size()), body);
+    History history(dir);
+    EXPECT_EQ(history.getRoundCount(), 1);
+    EXPECT_EQ(history.getSegmentCount(), 1u);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(HistoryTests, CompactAndClearTest) {
+    const std::string dir = "test_history_compact_dir";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directory(dir);
+    
+    History history(dir);
+    for (size_t i = 0; i < History::MAX_SEGMENTS; ++i) {
+        history.addRound({"a"}, {Move::COOPERATE});
+        history.saveToFile();
+    }
+    EXPECT_EQ(history.getSegmentCount(), History::MAX_SEGMENTS);
+    
+    // Сверх предела - один сегмент со всеми раундами
+    history.addRound({"a"}, {Move::DEFECT});
+    history.saveToFile();
+    EXPECT_EQ(history.getSegmentCount(), 1u);
+    EXPECT_EQ(History(dir).getRoundCount(), static_cast<int>(History::MAX_SEGMENTS) + 1);
+    
+    history.clear();
+    history.addRound({"b"}, {Move::DEFECT});
+    history.saveToFile();
+    History reloaded(dir);
+    ASSERT_EQ(reloaded.getRoundCount(), 1);
+    EXPECT_EQ(reloaded.getPlayerNames(), std::vector<std::string>{"b"});
+    std::filesystem::remove_all(dir);
+}
+
+TEST(HistoryTests, ImportsLegacyTextTest) {
+    const std::string dir = "test_history_legacy_dir";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directory(dir);
+    {
+        std::ofstream legacy(dir + "/history.txt");
+        legacy << "tft:C def:D\n";
+        legacy << "coop:C def:D tft:D\n";
+    }
+    
+    History history(dir);
+    ASSERT_EQ(history.getRoundCount(), 2);
+    EXPECT_TRUE(std::filesystem::exists(history.getFileName()));
+    RoundRecord expected = {{"coop", Move::COOPERATE}, {"def", Move::DEFECT}, {"tft", Move::DEFECT}};
+    EXPECT_EQ(history.getRound(1).toRecord(), expected);
+    
+    std::filesystem::remove(dir + "/history.txt");
+    EXPECT_EQ(History(dir).getRound(1).toRecord(), expected);
+    std::filesystem::remove_all(dir);
+}
@@ -6,6 +6,10 @@
 #include "strategies/advanced/FiftyFifty.h"
 #include "strategies/advanced/TitForTat.h"
 #include "strategies/advanced/AdaptiveStrategy.h"
+#include "strategies/advanced/TableStrategy.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
 
 // Тесты для AlwaysCooperate
 TEST(StrategyTests, AlwaysCooperateTest) {
@@ -65,6 +69,9 @@ TEST(StrategyTests, FiftyFiftyTest) {
 // Тесты для TitForTat
 TEST(StrategyTests, TitForTatTest) {
     TitForTat strategy;
+    // Зерно 0: первые два броска прощения (0.94, 0.97) выше 0.1
+    RandomStream stream(0);
+    strategy.attachRandom(&stream);
     std::vector<Move> ownHistory;
     std::vector<std::vector<Move>> opponentsHistory;
     
@@ -100,7 +107,7 @@ TEST(StrategyTests, RandomTest) {
         ownHistory.push_back(move);
     }
     
-    EXPECT_EQ(strategy.getName(), "Random");
+    EXPECT_EQ(strategy.getName(), "RandomStrategy");
 }
 
 // Тесты для AdaptiveStrategy
@@ -122,5 +129,112 @@ TEST(StrategyTests, AdaptiveStrategyTest) {
     Move move2 = strategy.makeMove(ownHistory, opponentsHistory);
     EXPECT_TRUE(move2 == Move::COOPERATE || move2 == Move::DEFECT);
     
+    // Без движка статистика обновляется из истории
+    EXPECT_EQ(strategy.getTotalCooperate() + strategy.getTotalDefect(), 1);
+    EXPECT_GT(strategy.getCooperationLevel(), 0.7);
+    
     EXPECT_EQ(strategy.getName(), "AdaptiveStrategy");
-}
\ No newline at end of file
+}
+
+// Табличная стратегия: память 2, предаёт только после двух подряд
+// раундов, где кто-то из соперников предал
+TEST(StrategyTests, TableStrategyMemoryTwoTest) {
+    std::filesystem::create_directory("test_tables");
+    std::string table(64, 'C');
+    for (int index = 0; index < 64; ++index) {
+        if ((index & 3) && ((index >> 3) & 3)) table[index] = 'D';
+    }
+    std::ofstream file("test_tables/patient.cfg");
+    file << "type=table\nname=Patient\nmemory=2\ninitial=CD\ntable=" << table << "\n";
+    file.close();
+    
+    TableStrategy strategy;
+    ASSERT_TRUE(strategy.loadFromDir("test_tables", "patient"));
+    EXPECT_EQ(strategy.getName(), "Patient");
+    EXPECT_EQ(strategy.getKind(), TableStrategy::Kind::TABLE);
+    EXPECT_EQ(strategy.getTableSize(), 64u);
+    
+    std::vector<Move> own;
+    std::vector<std::vector<Move>> opponents(2);
+    const char* first = "CDDCDDC";
+    const char* second = "CCCCCDC";
+    const char* expected = "CDCDCCD";
+    for (int round = 0; round < 7; ++round) {
+        Move move = strategy.makeMove(own, opponents);
+        EXPECT_EQ(move, charToMove(expected[round])) << "round " << round;
+        own.push_back(move);
+        opponents[0].push_back(charToMove(first[round]));
+        opponents[1].push_back(charToMove(second[round]));
+    }
+    
+    std::remove("test_tables/patient.cfg");
+    std::filesystem::remove("test_tables");
+}
+
+// Конечный автомат: Grim Trigger
+TEST(StrategyTests, TableStrategyFsmTest) {
+    std::filesystem::create_directory("test_tables");
+    std::ofstream file("test_tables/grim.cfg");
+    file << "type=fsm\nname=Grim\nstates=2\nstart=0\nmoves=CD\n";
+    file << "transitions=0,1,1,1, 1,1,1,1\n";
+    file.close();
+    
+    TableStrategy strategy;
+    ASSERT_TRUE(strategy.loadFromDir("test_tables", "grim"));
+    EXPECT_EQ(strategy.getKind(), TableStrategy::Kind::FSM);
+    
+    std::vector<Move> own;
+    std::vector<std::vector<Move>> opponents(2);
+    const char* first = "CCDCCC";
+    const char* expected = "CCCDDD";
+    for (int round = 0; round < 6; ++round) {
+        Move move = strategy.makeMove(own, opponents);
+        EXPECT_EQ(move, charToMove(expected[round])) << "round " << round;
+        own.push_back(move);
+        opponents[0].push_back(charToMove(first[round]));
+        opponents[1].push_back(Move::COOPERATE);
+    }
+    
+    // Повторный вызов на той же истории не сдвигает состояние,
+    // новая игра сбрасывает автомат
+    EXPECT_EQ(strategy.makeMove(own, opponents), Move::DEFECT);
+    EXPECT_EQ(strategy.makeMove(std::vector<Move>(), std::vector<std::vector<Move>>(2)), Move::COOPERATE);
+    
+    // Без name= имя берётся из имени файла
+    std::ofstream anonymous("test_tables/anon.cfg");
+    anonymous << "type=fsm\nstates=1\nmoves=D\ntransitions=0,0,0,0\n";
+    anonymous.close();
+    TableStrategy unnamed;
+    ASSERT_TRUE(unnamed.loadFromDir("test_tables", "anon"));
+    EXPECT_EQ(unnamed.getName(), "anon");
+    
+    // Некорректные описания отклоняются
+    std::ofstream broken("test_tables/broken.cfg");
+    broken << "type=fsm\nstates=2\nmoves=CD\ntransitions=0,1,2,1,1,1,1,1\n";
+    broken.close();
+    EXPECT_FALSE(strategy.loadFromDir("test_tables", "broken"));
+    
+    std::remove("test_tables/grim.cfg");
+    std::remove("test_tables/anon.cfg");
+    std::remove("test_tables/broken.cfg");
+    std::filesystem::remove("test_tables");
+}
+
+// Стратегия без makeMove не уходит в бесконечную рекурсию
+TEST(StrategyTests, MissingMakeMoveThrowsTest) {
+    class Empty : public Strategy {
+    public:
+        std::string getName() const override { return "Empty"; }
+    };
+    
+    Empty strategy;
+    std::vector<Move> own;
+    std::vector<std::vector<Move>> opponents(2);
+    EXPECT_THROW(strategy.makeMove(own, opponents), std::logic_error);
+    PackedHistory history;
+    EXPECT_THROW(strategy.makeMove(HistoryView(history), OpponentsView()), std::logic_error);
+    
+    // Обычные стратегии адаптер по-прежнему пропускает
+    AlwaysDefect defect;
+    EXPECT_EQ(defect.makeMove(HistoryView(history), OpponentsView()), Move::DEFECT);
+}